@@ -0,0 +1,278 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "area-tracker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+/**
+ * Check if (`x`, `y`) is inside, or on, `bounds`
+ *
+ * @param bounds
+ * The area to check
+ *
+ * @param x
+ * The X coordinate to check
+ *
+ * @param y
+ * The Y coordinate to check
+ *
+ * @return
+ * True if the point is inside `bounds`, false otherwise
+ */
+bool
+contains(const ns3::Rectangle& bounds, double x, double y)
+{
+    return x >= bounds.xMin && x <= bounds.xMax && y >= bounds.yMin && y <= bounds.yMax;
+}
+
+} // namespace
+
+namespace ns3::netsimulyzer
+{
+
+void
+AreaTracker::Add(uint32_t areaId, const Rectangle& bounds)
+{
+    m_areas.emplace_back(areaId, bounds);
+}
+
+void
+AreaTracker::Build(double cellSize)
+{
+    m_cells.clear();
+    m_unbounded.clear();
+
+    if (cellSize <= 0.0)
+    {
+        // Roughly one cell per area, so each area
+        // only has to be checked near itself
+        double total = 0.0;
+        std::size_t counted = 0u;
+        for (const auto& [id, bounds] : m_areas)
+        {
+            const auto size = std::max(bounds.xMax - bounds.xMin, bounds.yMax - bounds.yMin);
+            if (std::isfinite(size))
+            {
+                total += size;
+                counted++;
+            }
+        }
+        cellSize = counted == 0u ? 0.0 : total / static_cast<double>(counted);
+    }
+
+    m_cellSize = cellSize > 0.0 ? cellSize : 1.0;
+
+    // Areas without finite bounds would cover every cell,
+    // so they are checked for every point instead
+    std::vector<std::size_t> gridded;
+    for (std::size_t i = 0; i < m_areas.size(); i++)
+    {
+        const auto& bounds = m_areas[i].second;
+        if (std::isfinite(bounds.xMin) && std::isfinite(bounds.xMax) &&
+            std::isfinite(bounds.yMin) && std::isfinite(bounds.yMax))
+        {
+            gridded.emplace_back(i);
+        }
+        else
+        {
+            m_unbounded.emplace_back(i);
+        }
+    }
+
+    // Grow the cells until the grid has a reasonable size. Once the cells are
+    // larger than every area, each area overlaps at most 4 cells, so this ends
+    const auto cellLimit = std::max(MaxCells, 4u * gridded.size());
+    while (CountCells(gridded) > static_cast<double>(cellLimit))
+    {
+        m_cellSize *= 2.0;
+    }
+
+    for (const auto i : gridded)
+    {
+        const auto& bounds = m_areas[i].second;
+        const auto maxX = Cell(bounds.xMax);
+        const auto maxY = Cell(bounds.yMax);
+        for (auto x = Cell(bounds.xMin); x <= maxX; x++)
+        {
+            for (auto y = Cell(bounds.yMin); y <= maxY; y++)
+            {
+                m_cells[Key(x, y)].emplace_back(i);
+            }
+        }
+    }
+}
+
+void
+AreaTracker::Clear(void)
+{
+    m_areas.clear();
+    m_cells.clear();
+    m_unbounded.clear();
+    m_inside.clear();
+    m_found.clear();
+}
+
+std::size_t
+AreaTracker::GetSize(void) const
+{
+    return m_areas.size();
+}
+
+double
+AreaTracker::GetCellSize(void) const
+{
+    return m_cellSize;
+}
+
+void
+AreaTracker::Find(double x, double y, std::vector<uint32_t>& areas) const
+{
+    areas.clear();
+    for (const auto i : m_unbounded)
+    {
+        if (contains(m_areas[i].second, x, y))
+        {
+            areas.emplace_back(m_areas[i].first);
+        }
+    }
+
+    const auto cell = m_cells.find(Key(Cell(x), Cell(y)));
+    if (cell != m_cells.end())
+    {
+        for (const auto i : cell->second)
+        {
+            if (contains(m_areas[i].second, x, y))
+            {
+                areas.emplace_back(m_areas[i].first);
+            }
+        }
+    }
+    std::sort(areas.begin(), areas.end());
+}
+
+bool
+AreaTracker::Update(uint32_t nodeId, const Vector3D& position, const ChangedCallback& changed)
+{
+    Find(position.x, position.y, m_found);
+
+    const auto last = m_inside.find(nodeId);
+    if (last == m_inside.end())
+    {
+        if (m_found.empty())
+        {
+            // Outside before & after, the common case for most Nodes
+            return false;
+        }
+
+        for (const auto area : m_found)
+        {
+            changed(area, true);
+        }
+        m_inside.emplace(nodeId, m_found);
+        return true;
+    }
+
+    const auto& before = last->second;
+    for (const auto area : before)
+    {
+        if (!std::binary_search(m_found.begin(), m_found.end(), area))
+        {
+            changed(area, false);
+        }
+    }
+    for (const auto area : m_found)
+    {
+        if (!std::binary_search(before.begin(), before.end(), area))
+        {
+            changed(area, true);
+        }
+    }
+
+    if (m_found.empty())
+    {
+        m_inside.erase(last);
+    }
+    else
+    {
+        last->second.swap(m_found);
+    }
+    return true;
+}
+
+bool
+AreaTracker::IsInside(uint32_t nodeId) const
+{
+    return m_inside.find(nodeId) != m_inside.end();
+}
+
+int64_t
+AreaTracker::Cell(double value) const
+{
+    // Keep far away (or non-finite) coordinates from overflowing the index
+    constexpr auto limit = static_cast<double>(std::numeric_limits<int32_t>::max());
+    const auto cell = std::floor(value / m_cellSize);
+    if (!(cell > -limit))
+    {
+        return static_cast<int64_t>(-limit);
+    }
+    return static_cast<int64_t>(std::min(cell, limit));
+}
+
+double
+AreaTracker::CountCells(const std::vector<std::size_t>& areas) const
+{
+    // As a double, since the count may not fit an integer
+    double count = 0.0;
+    for (const auto i : areas)
+    {
+        const auto& bounds = m_areas[i].second;
+        count += static_cast<double>(Cell(bounds.xMax) - Cell(bounds.xMin) + 1) *
+                 static_cast<double>(Cell(bounds.yMax) - Cell(bounds.yMin) + 1);
+    }
+    return count;
+}
+
+uint64_t
+AreaTracker::Key(int64_t x, int64_t y)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32u) |
+           static_cast<uint64_t>(static_cast<uint32_t>(y));
+}
+
+} // namespace ns3::netsimulyzer
@@ -0,0 +1,228 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#ifndef AREA_TRACKER_H
+#define AREA_TRACKER_H
+
+#include "ns3/rectangle.h"
+#include "ns3/vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3::netsimulyzer
+{
+
+/**
+ * Tracks which areas each Node is inside of.
+ *
+ * Areas are indexed by a uniform grid of square cells, each holding
+ * the areas which overlap it. Finding the areas containing a position
+ * only checks the areas of the cell it falls in,
+ * so the cost does not grow with the number of areas
+ *
+ * Only Nodes inside at least one area are stored
+ */
+class AreaTracker
+{
+  public:
+    /**
+     * The most grid cells `Build()` creates, unless there are
+     * enough areas to need more. Past this, the cells are made larger
+     */
+    static constexpr std::size_t MaxCells{1u << 16u};
+
+    /**
+     * Callback for each area a Node enters or exits during an `Update()`.
+     * Called with the ID of the area, & true if the Node entered it,
+     * false if it exited
+     */
+    using ChangedCallback = std::function<void(uint32_t, bool)>;
+
+    /**
+     * Add an area to be tracked. Not indexed until `Build()` is called
+     *
+     * @param areaId
+     * The ID of the area
+     *
+     * @param bounds
+     * The area's bounds. Positions on the bounds are inside the area
+     */
+    void Add(uint32_t areaId, const Rectangle& bounds);
+
+    /**
+     * Index every area added
+     *
+     * @param cellSize
+     * The width & height of each grid cell, in ns-3 units.
+     * Zero or less picks a size from the average size of the areas.
+     * Made larger if the grid would have more than `MaxCells` cells
+     */
+    void Build(double cellSize);
+
+    /**
+     * Remove every area & Node
+     */
+    void Clear(void);
+
+    /**
+     * @return
+     * The number of areas tracked
+     */
+    std::size_t GetSize(void) const;
+
+    /**
+     * @return
+     * The width & height of each grid cell. Only meaningful after `Build()`
+     */
+    double GetCellSize(void) const;
+
+    /**
+     * Find every area containing (`x`, `y`)
+     *
+     * @param x
+     * The X coordinate to check
+     *
+     * @param y
+     * The Y coordinate to check
+     *
+     * @param areas
+     * Replaced with the ID of each area containing the point, in ascending order
+     */
+    void Find(double x, double y, std::vector<uint32_t>& areas) const;
+
+    /**
+     * Move the Node with `nodeId` to `position`, calling `changed`
+     * for each area it entered or exited
+     *
+     * @param nodeId
+     * The ID of the Node which moved
+     *
+     * @param position
+     * The Node's new position
+     *
+     * @param changed
+     * Called for each area the Node entered or exited.
+     * Exits are reported before entries
+     *
+     * @return
+     * True if the Node was inside any area before or after the move
+     */
+    bool Update(uint32_t nodeId, const Vector3D& position, const ChangedCallback& changed);
+
+    /**
+     * @param nodeId
+     * The ID of the Node to check
+     *
+     * @return
+     * True if the Node was inside any area as of its last `Update()`
+     */
+    bool IsInside(uint32_t nodeId) const;
+
+  private:
+    /**
+     * Get the cell containing a coordinate on one axis
+     *
+     * @param value
+     * The coordinate
+     *
+     * @return
+     * The index of the cell on that axis
+     */
+    int64_t Cell(double value) const;
+
+    /**
+     * Count the cells overlapped by each of `areas`, with the current `m_cellSize`
+     *
+     * @param areas
+     * The indices into `m_areas` of the areas to count
+     *
+     * @return
+     * The total number of cells overlapped, counting shared cells once per area
+     */
+    double CountCells(const std::vector<std::size_t>& areas) const;
+
+    /**
+     * Combine cell indices into a single key for `m_cells`
+     *
+     * @param x
+     * The index of the cell on the X axis
+     *
+     * @param y
+     * The index of the cell on the Y axis
+     *
+     * @return
+     * The key for the cell
+     */
+    static uint64_t Key(int64_t x, int64_t y);
+
+    /**
+     * Every area tracked, as {ID, bounds}
+     */
+    std::vector<std::pair<uint32_t, Rectangle>> m_areas;
+
+    /**
+     * The index into `m_areas` of every area overlapping each cell, by `Key()`
+     */
+    std::unordered_map<uint64_t, std::vector<std::size_t>> m_cells;
+
+    /**
+     * The index into `m_areas` of every area without finite bounds.
+     * These are not in the grid, & are checked for every point
+     */
+    std::vector<std::size_t> m_unbounded;
+
+    /**
+     * The width & height of each cell
+     */
+    double m_cellSize{1.0};
+
+    /**
+     * The areas each Node is inside of, in ascending order, by Node ID.
+     * Nodes outside every area are not stored
+     */
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_inside;
+
+    /**
+     * Areas found by the current `Update()`, kept to avoid allocating
+     */
+    std::vector<uint32_t> m_found;
+};
+
+} // namespace ns3::netsimulyzer
+
+#endif
@@ -0,0 +1,975 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "binary-output.h"
+
+#include "json-event-emitter.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <variant>
+
+namespace
+{
+
+/**
+ * Size of the footer: trailer offset, index offset, & magic
+ */
+constexpr std::size_t FooterSize = 8u + 8u + sizeof(ns3::netsimulyzer::BinaryFormat::Magic);
+
+/**
+ * Get the bits of `value` as an unsigned integer of the same size
+ *
+ * @tparam T
+ * An integer or floating point type
+ *
+ * @param value
+ * The value to convert
+ *
+ * @return
+ * The bits of `value`
+ */
+template <typename T>
+auto
+ToBits(T value)
+{
+    using Bits = std::conditional_t<sizeof(T) == 8u,
+                                    uint64_t,
+                                    std::conditional_t<sizeof(T) == 4u, uint32_t, uint8_t>>;
+    static_assert(sizeof(T) == sizeof(Bits), "Unsupported type size");
+
+    Bits bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    return bits;
+}
+
+/**
+ * Append `value` to `out` in little-endian order
+ *
+ * @param out
+ * The buffer to append to
+ *
+ * @param value
+ * The value to write
+ */
+template <typename T>
+void
+AppendLittleEndian(std::string& out, T value)
+{
+    const auto bits = ToBits(value);
+    for (auto i = 0u; i < sizeof(T); i++)
+    {
+        out.push_back(static_cast<char>((bits >> (i * 8u)) & 0xFFu));
+    }
+}
+
+/**
+ * Append every value in `column` to `out` in little-endian order
+ *
+ * @param out
+ * The buffer to append to
+ *
+ * @param column
+ * The values to write
+ */
+template <typename T>
+void
+AppendColumn(std::string& out, const std::vector<T>& column)
+{
+    for (const auto value : column)
+    {
+        AppendLittleEndian(out, value);
+    }
+}
+
+/**
+ * Append `value` to `out` as an unsigned LEB128 varint:
+ * 7 bits per byte, least significant first, with the high bit
+ * set on every byte but the last
+ *
+ * @param out
+ * The buffer to append to
+ *
+ * @param value
+ * The value to write
+ */
+void
+AppendVarint(std::string& out, uint64_t value)
+{
+    while (value >= 0x80u)
+    {
+        out.push_back(static_cast<char>((value & 0x7Fu) | 0x80u));
+        value >>= 7u;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+/**
+ * Map a signed value to an unsigned one, so values
+ * near zero (positive or negative) have short varints.
+ * 0 -> 0, -1 -> 1, 1 -> 2, -2 -> 3...
+ *
+ * @param value
+ * The value to map
+ *
+ * @return
+ * The zigzag encoded value
+ */
+uint64_t
+ZigZagEncode(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1u) ^ static_cast<uint64_t>(value >> 63);
+}
+
+/**
+ * Reverse `ZigZagEncode()`
+ *
+ * @param value
+ * The zigzag encoded value
+ *
+ * @return
+ * The original signed value
+ */
+int64_t
+ZigZagDecode(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1u) ^ -static_cast<int64_t>(value & 1u);
+}
+
+/**
+ * Decode a little-endian value from `data`
+ *
+ * @param data
+ * At least `sizeof(T)` bytes
+ *
+ * @return
+ * The decoded value
+ */
+template <typename T>
+T
+DecodeLittleEndian(const char* data)
+{
+    decltype(ToBits(T{})) bits{0u};
+    for (auto i = 0u; i < sizeof(T); i++)
+    {
+        bits |= static_cast<decltype(bits)>(static_cast<unsigned char>(data[i])) << (i * 8u);
+    }
+
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+/**
+ * Read exactly `size` bytes from `input`, aborting if the file is too short
+ *
+ * @param input
+ * The stream to read from
+ *
+ * @param size
+ * The number of bytes to read
+ *
+ * @return
+ * The bytes read
+ */
+std::string
+ReadBytes(std::istream& input, std::size_t size)
+{
+    std::string bytes(size, '\0');
+    input.read(bytes.data(), static_cast<std::streamsize>(size));
+    NS_ABORT_MSG_IF(static_cast<std::size_t>(input.gcount()) != size,
+                    "Unexpected end of NetSimulyzer binary output");
+    return bytes;
+}
+
+/**
+ * Read one little-endian value from `input`
+ *
+ * @param input
+ * The stream to read from
+ *
+ * @return
+ * The decoded value
+ */
+template <typename T>
+T
+ReadValue(std::istream& input)
+{
+    return DecodeLittleEndian<T>(ReadBytes(input, sizeof(T)).data());
+}
+
+/**
+ * Reads values from a block which has been loaded into memory.
+ * Aborts if a read would go past the end of the block
+ */
+class ByteReader
+{
+  public:
+    /**
+     * @param bytes
+     * The block to read. Must outlive the reader
+     */
+    explicit ByteReader(const std::string& bytes)
+        : m_current(bytes.data()),
+          m_end(bytes.data() + bytes.size())
+    {
+    }
+
+    /**
+     * @return
+     * The next little-endian value
+     */
+    template <typename T>
+    T Value(void)
+    {
+        Require(sizeof(T));
+        const auto value = DecodeLittleEndian<T>(m_current);
+        m_current += sizeof(T);
+        return value;
+    }
+
+    /**
+     * @return
+     * The next unsigned varint
+     */
+    uint64_t Varint(void)
+    {
+        uint64_t value{0u};
+        for (auto shift = 0u; shift < 64u; shift += 7u)
+        {
+            Require(1u);
+            const auto byte = static_cast<unsigned char>(*m_current++);
+            value |= static_cast<uint64_t>(byte & 0x7Fu) << shift;
+            if ((byte & 0x80u) == 0u)
+            {
+                return value;
+            }
+        }
+
+        NS_ABORT_MSG("Malformed varint in NetSimulyzer binary output");
+        return value;
+    }
+
+    /**
+     * @return
+     * The next zigzag encoded varint
+     */
+    int64_t SignedVarint(void)
+    {
+        return ZigZagDecode(Varint());
+    }
+
+    /**
+     * Read `count` little-endian values into `column`
+     *
+     * @param count
+     * The number of values to read
+     *
+     * @param column
+     * Where to store the values. Replaces any existing contents
+     */
+    template <typename T>
+    void Column(uint32_t count, std::vector<T>& column)
+    {
+        column.resize(count);
+        for (auto& value : column)
+        {
+            value = Value<T>();
+        }
+    }
+
+    /**
+     * @param size
+     * The number of bytes to read
+     *
+     * @return
+     * The next `size` bytes
+     */
+    std::string Bytes(std::size_t size)
+    {
+        Require(size);
+        std::string bytes{m_current, size};
+        m_current += size;
+        return bytes;
+    }
+
+  private:
+    /**
+     * Abort if there are fewer than `size` bytes left
+     *
+     * @param size
+     * The number of bytes about to be read
+     */
+    void Require(std::size_t size) const
+    {
+        NS_ABORT_MSG_IF(static_cast<std::size_t>(m_end - m_current) < size,
+                        "Unexpected end of NetSimulyzer binary output block");
+    }
+
+    /**
+     * The next byte to read
+     */
+    const char* m_current;
+
+    /**
+     * One past the last byte of the block
+     */
+    const char* m_end;
+};
+
+/**
+ * Read a JSON section (length, then text) from `input`
+ *
+ * @param input
+ * The stream to read from
+ *
+ * @return
+ * The parsed section
+ */
+nlohmann::json
+ReadJsonSection(std::istream& input)
+{
+    const auto length = ReadValue<uint64_t>(input);
+    return nlohmann::json::parse(ReadBytes(input, length));
+}
+
+} // namespace
+
+namespace ns3::netsimulyzer
+{
+
+NS_LOG_COMPONENT_DEFINE("BinaryOutput");
+
+BinaryOutputWriter::BinaryOutputWriter(std::ostream& output,
+                                       uint32_t blockSize,
+                                       BinaryFormat::Encoding encoding,
+                                       double positionResolution)
+    : m_output(output),
+      m_blockSize(blockSize),
+      m_encoding(encoding)
+{
+    NS_ABORT_MSG_IF(blockSize == 0u, "Binary output block size must be at least 1");
+    NS_ABORT_MSG_IF(positionResolution < 0.0, "Position resolution may not be negative");
+
+    if (positionResolution > 0.0)
+    {
+        m_positionScale = 1.0 / positionResolution;
+    }
+}
+
+void
+BinaryOutputWriter::WriteHeader(const nlohmann::json& header)
+{
+    NS_LOG_FUNCTION(this);
+    m_scratch.clear();
+    m_scratch.append(BinaryFormat::Magic, sizeof(BinaryFormat::Magic));
+    AppendLittleEndian(m_scratch, BinaryFormat::Version);
+
+    const auto text = header.dump();
+    AppendLittleEndian(m_scratch, static_cast<uint64_t>(text.size()));
+    m_scratch.append(text);
+
+    WriteBytes(m_scratch);
+}
+
+void
+BinaryOutputWriter::Write(const EventRecord& event)
+{
+    if (const auto position = std::get_if<CourseChangeEvent>(&event))
+    {
+        m_positions.id.emplace_back(position->nodeId);
+        m_positions.x.emplace_back(position->position.x);
+        m_positions.y.emplace_back(position->position.y);
+        m_positions.z.emplace_back(position->position.z);
+        FinishRecord(m_positions, position->time);
+        return;
+    }
+
+    if (const auto append = std::get_if<XYSeriesAppendEvent>(&event))
+    {
+        m_xySeriesAppends.id.emplace_back(append->id);
+        m_xySeriesAppends.x.emplace_back(append->x);
+        m_xySeriesAppends.y.emplace_back(append->y);
+        FinishRecord(m_xySeriesAppends, append->time);
+        return;
+    }
+
+    const auto previousSize = m_json.text.size();
+    JsonEventEmitter{m_json.text}.Write(event);
+    m_json.length.emplace_back(static_cast<uint32_t>(m_json.text.size() - previousSize));
+    FinishRecord(m_json, std::visit([](const auto& e) { return e.time; }, event));
+}
+
+void
+BinaryOutputWriter::Finish(const nlohmann::json& trailer)
+{
+    NS_LOG_FUNCTION(this);
+    WriteBlock(m_positions);
+    WriteBlock(m_xySeriesAppends);
+    WriteBlock(m_json);
+
+    const auto trailerOffset = m_offset;
+    const auto text = trailer.dump();
+    m_scratch.clear();
+    AppendLittleEndian(m_scratch, static_cast<uint64_t>(text.size()));
+    m_scratch.append(text);
+    WriteBytes(m_scratch);
+
+    const auto indexOffset = m_offset;
+    m_scratch.clear();
+    AppendLittleEndian(m_scratch, static_cast<uint32_t>(m_index.size()));
+    for (const auto& entry : m_index)
+    {
+        AppendLittleEndian(m_scratch, static_cast<uint8_t>(entry.type));
+        AppendLittleEndian(m_scratch, entry.count);
+        AppendLittleEndian(m_scratch, entry.offset);
+        AppendLittleEndian(m_scratch, entry.firstNanoseconds);
+        AppendLittleEndian(m_scratch, entry.lastNanoseconds);
+    }
+
+    AppendLittleEndian(m_scratch, trailerOffset);
+    AppendLittleEndian(m_scratch, indexOffset);
+    m_scratch.append(BinaryFormat::Magic, sizeof(BinaryFormat::Magic));
+    WriteBytes(m_scratch);
+    m_output.flush();
+}
+
+void
+BinaryOutputWriter::FinishRecord(BinaryFormat::ColumnBlock& block, Time time)
+{
+    block.sequence.emplace_back(m_nextSequence++);
+    block.nanoseconds.emplace_back(time.GetNanoSeconds());
+
+    if (block.sequence.size() >= m_blockSize)
+    {
+        WriteBlock(block);
+    }
+}
+
+void
+BinaryOutputWriter::WriteBlock(BinaryFormat::ColumnBlock& block)
+{
+    if (block.sequence.empty())
+    {
+        return;
+    }
+
+    const auto count = static_cast<uint32_t>(block.sequence.size());
+    m_index.emplace_back(BinaryFormat::BlockIndexEntry{block.type,
+                                                       count,
+                                                       m_offset,
+                                                       block.nanoseconds.front(),
+                                                       block.nanoseconds.back()});
+
+    m_scratch.clear();
+    AppendLittleEndian(m_scratch, static_cast<uint8_t>(block.type));
+    AppendLittleEndian(m_scratch, static_cast<uint8_t>(m_encoding));
+    AppendLittleEndian(m_scratch, count);
+
+    if (m_encoding == BinaryFormat::Encoding::Delta)
+    {
+        EncodeDelta(block);
+    }
+    else
+    {
+        AppendRawColumns(block);
+    }
+    WriteBytes(m_scratch);
+    block.Clear();
+}
+
+void
+BinaryOutputWriter::AppendRawColumns(const BinaryFormat::ColumnBlock& block)
+{
+    AppendColumn(m_scratch, block.sequence);
+    AppendColumn(m_scratch, block.nanoseconds);
+
+    switch (block.type)
+    {
+    case BinaryFormat::BlockType::NodePosition:
+        AppendColumn(m_scratch, block.id);
+        AppendColumn(m_scratch, block.x);
+        AppendColumn(m_scratch, block.y);
+        AppendColumn(m_scratch, block.z);
+        break;
+    case BinaryFormat::BlockType::XYSeriesAppend:
+        AppendColumn(m_scratch, block.id);
+        AppendColumn(m_scratch, block.x);
+        AppendColumn(m_scratch, block.y);
+        break;
+    case BinaryFormat::BlockType::Json:
+        AppendColumn(m_scratch, block.length);
+        m_scratch.append(block.text);
+        break;
+    }
+}
+
+void
+BinaryOutputWriter::EncodeDelta(const BinaryFormat::ColumnBlock& block)
+{
+    const auto count = block.sequence.size();
+    const auto isPosition = block.type == BinaryFormat::BlockType::NodePosition;
+    const auto scale = isPosition ? m_positionScale : 0.0;
+    AppendLittleEndian(m_scratch, scale);
+
+    uint64_t previousSequence{0u};
+    for (const auto sequence : block.sequence)
+    {
+        AppendVarint(m_scratch, sequence - previousSequence);
+        previousSequence = sequence;
+    }
+
+    if (block.type == BinaryFormat::BlockType::Json)
+    {
+        int64_t previousNanoseconds{0};
+        for (const auto nanoseconds : block.nanoseconds)
+        {
+            AppendVarint(m_scratch, ZigZagEncode(nanoseconds - previousNanoseconds));
+            previousNanoseconds = nanoseconds;
+        }
+
+        for (const auto length : block.length)
+        {
+            AppendVarint(m_scratch, length);
+        }
+        m_scratch.append(block.text);
+        return;
+    }
+
+    int64_t previousId{0};
+    for (const auto id : block.id)
+    {
+        AppendVarint(m_scratch, ZigZagEncode(static_cast<int64_t>(id) - previousId));
+        previousId = id;
+    }
+
+    // Values for the previous record of each Node/series in this block
+    m_previous.clear();
+    for (auto i = 0u; i < count; i++)
+    {
+        auto& previous = m_previous[block.id[i]];
+        AppendVarint(m_scratch, ZigZagEncode(block.nanoseconds[i] - previous.nanoseconds));
+        previous.nanoseconds = block.nanoseconds[i];
+    }
+
+    if (scale == 0.0)
+    {
+        AppendColumn(m_scratch, block.x);
+        AppendColumn(m_scratch, block.y);
+        if (isPosition)
+        {
+            AppendColumn(m_scratch, block.z);
+        }
+        return;
+    }
+
+    for (auto i = 0u; i < count; i++)
+    {
+        auto& previous = m_previous[block.id[i]];
+        const int64_t quantized[3]{std::llround(block.x[i] * scale),
+                                   std::llround(block.y[i] * scale),
+                                   std::llround(block.z[i] * scale)};
+
+        for (auto axis = 0u; axis < 3u; axis++)
+        {
+            AppendVarint(m_scratch, ZigZagEncode(quantized[axis] - previous.position[axis]));
+            previous.position[axis] = quantized[axis];
+        }
+    }
+}
+
+void
+BinaryOutputWriter::WriteBytes(const std::string& bytes)
+{
+    m_output.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    m_offset += bytes.size();
+}
+
+BinaryOutputReader::BinaryOutputReader(std::istream& input)
+    : m_input(input)
+{
+    NS_LOG_FUNCTION(this);
+    const auto magic = ReadBytes(m_input, sizeof(BinaryFormat::Magic));
+    NS_ABORT_MSG_IF(std::memcmp(magic.data(), BinaryFormat::Magic, magic.size()) != 0,
+                    "Not a NetSimulyzer binary output file");
+
+    const auto version = ReadValue<uint32_t>(m_input);
+    NS_ABORT_MSG_IF(version != BinaryFormat::Version,
+                    "Unsupported NetSimulyzer binary output version: " << version);
+
+    m_header = ReadJsonSection(m_input);
+
+    m_input.seekg(-static_cast<std::streamoff>(FooterSize), std::ios::end);
+    const auto trailerOffset = ReadValue<uint64_t>(m_input);
+    const auto indexOffset = ReadValue<uint64_t>(m_input);
+    const auto endMagic = ReadBytes(m_input, sizeof(BinaryFormat::Magic));
+    NS_ABORT_MSG_IF(std::memcmp(endMagic.data(), BinaryFormat::Magic, endMagic.size()) != 0,
+                    "NetSimulyzer binary output is incomplete, the footer is missing");
+
+    m_trailerOffset = trailerOffset;
+    m_input.seekg(static_cast<std::streamoff>(trailerOffset));
+    m_trailer = ReadJsonSection(m_input);
+
+    m_input.seekg(static_cast<std::streamoff>(indexOffset));
+    const auto blockCount = ReadValue<uint32_t>(m_input);
+    m_index.reserve(blockCount);
+    for (auto i = 0u; i < blockCount; i++)
+    {
+        BinaryFormat::BlockIndexEntry entry;
+        entry.type = static_cast<BinaryFormat::BlockType>(ReadValue<uint8_t>(m_input));
+        entry.count = ReadValue<uint32_t>(m_input);
+        entry.offset = ReadValue<uint64_t>(m_input);
+        entry.firstNanoseconds = ReadValue<int64_t>(m_input);
+        entry.lastNanoseconds = ReadValue<int64_t>(m_input);
+        m_index.emplace_back(entry);
+    }
+}
+
+const nlohmann::json&
+BinaryOutputReader::GetHeader(void) const
+{
+    return m_header;
+}
+
+const nlohmann::json&
+BinaryOutputReader::GetTrailer(void) const
+{
+    return m_trailer;
+}
+
+const std::vector<BinaryFormat::BlockIndexEntry>&
+BinaryOutputReader::GetIndex(void) const
+{
+    return m_index;
+}
+
+void
+BinaryOutputReader::WriteJson(std::ostream& output)
+{
+    NS_LOG_FUNCTION(this);
+    auto document = m_header;
+    document.update(m_trailer);
+    document["events"] = nlohmann::json::array();
+
+    // Same order as the JSON output, which is sorted by key
+    output << '{';
+    auto first = true;
+    for (const auto& [key, value] : document.items())
+    {
+        if (!first)
+        {
+            output << ',';
+        }
+        first = false;
+
+        output << '"' << key << "\":";
+        if (key == "events")
+        {
+            output << '[';
+            WriteEvents(output);
+            output << ']';
+        }
+        else
+        {
+            output << value;
+        }
+    }
+    output << '}';
+}
+
+void
+BinaryOutputReader::DecodeBlock(const BinaryFormat::BlockIndexEntry& entry,
+                                uint64_t end,
+                                BinaryFormat::ColumnBlock& block)
+{
+    NS_ABORT_MSG_IF(end < entry.offset, "NetSimulyzer binary output block index is out of order");
+    m_input.seekg(static_cast<std::streamoff>(entry.offset));
+    const auto bytes = ReadBytes(m_input, end - entry.offset);
+    ByteReader reader{bytes};
+
+    const auto type = static_cast<BinaryFormat::BlockType>(reader.Value<uint8_t>());
+    const auto encoding = static_cast<BinaryFormat::Encoding>(reader.Value<uint8_t>());
+    const auto count = reader.Value<uint32_t>();
+    NS_ABORT_MSG_IF(type != entry.type || count != entry.count,
+                    "NetSimulyzer binary output block does not match the index");
+    NS_ABORT_MSG_IF(type != BinaryFormat::BlockType::NodePosition &&
+                        type != BinaryFormat::BlockType::XYSeriesAppend &&
+                        type != BinaryFormat::BlockType::Json,
+                    "Unknown NetSimulyzer binary output block type: " << static_cast<int>(type));
+
+    block.Clear();
+    block.type = type;
+    const auto isPosition = type == BinaryFormat::BlockType::NodePosition;
+    const auto isJson = type == BinaryFormat::BlockType::Json;
+
+    if (encoding == BinaryFormat::Encoding::Raw)
+    {
+        reader.Column(count, block.sequence);
+        reader.Column(count, block.nanoseconds);
+        if (!isJson)
+        {
+            reader.Column(count, block.id);
+            reader.Column(count, block.x);
+            reader.Column(count, block.y);
+        }
+        if (isPosition)
+        {
+            reader.Column(count, block.z);
+        }
+        if (isJson)
+        {
+            reader.Column(count, block.length);
+        }
+    }
+    else if (encoding == BinaryFormat::Encoding::Delta)
+    {
+        const auto scale = reader.Value<double>();
+
+        uint64_t sequence{0u};
+        block.sequence.resize(count);
+        for (auto& value : block.sequence)
+        {
+            sequence += reader.Varint();
+            value = sequence;
+        }
+
+        if (isJson)
+        {
+            int64_t nanoseconds{0};
+            block.nanoseconds.resize(count);
+            for (auto& value : block.nanoseconds)
+            {
+                nanoseconds += reader.SignedVarint();
+                value = nanoseconds;
+            }
+
+            block.length.resize(count);
+            for (auto& value : block.length)
+            {
+                value = static_cast<uint32_t>(reader.Varint());
+            }
+        }
+        else
+        {
+            int64_t id{0};
+            block.id.resize(count);
+            for (auto& value : block.id)
+            {
+                id += reader.SignedVarint();
+                value = static_cast<uint32_t>(id);
+            }
+
+            m_previous.clear();
+            block.nanoseconds.resize(count);
+            for (auto i = 0u; i < count; i++)
+            {
+                auto& previous = m_previous[block.id[i]];
+                previous.nanoseconds += reader.SignedVarint();
+                block.nanoseconds[i] = previous.nanoseconds;
+            }
+
+            if (scale == 0.0)
+            {
+                reader.Column(count, block.x);
+                reader.Column(count, block.y);
+                if (isPosition)
+                {
+                    reader.Column(count, block.z);
+                }
+            }
+            else
+            {
+                block.x.resize(count);
+                block.y.resize(count);
+                block.z.resize(count);
+                for (auto i = 0u; i < count; i++)
+                {
+                    auto& previous = m_previous[block.id[i]];
+                    for (auto axis = 0u; axis < 3u; axis++)
+                    {
+                        previous.position[axis] += reader.SignedVarint();
+                    }
+
+                    // Divide, rather than multiplying by the resolution,
+                    // so e.g. 1234 mm is exactly 1.234, not 1.2340000000000002
+                    block.x[i] = static_cast<double>(previous.position[0]) / scale;
+                    block.y[i] = static_cast<double>(previous.position[1]) / scale;
+                    block.z[i] = static_cast<double>(previous.position[2]) / scale;
+                }
+            }
+        }
+    }
+    else
+    {
+        NS_ABORT_MSG("Unsupported NetSimulyzer binary output block encoding: "
+                     << static_cast<int>(encoding));
+    }
+
+    if (isJson)
+    {
+        std::size_t textSize = 0u;
+        for (const auto length : block.length)
+        {
+            textSize += length;
+        }
+        block.text = reader.Bytes(textSize);
+    }
+}
+
+void
+BinaryOutputReader::WriteEvents(std::ostream& output)
+{
+    // One block of each type is decoded at a time,
+    // and the records are merged back into their original order
+    struct Cursor
+    {
+        explicit Cursor(BinaryFormat::BlockType blockType)
+            : block(blockType)
+        {
+        }
+
+        BinaryFormat::ColumnBlock block;
+        std::vector<std::size_t> blocks;
+        std::size_t nextBlock{0u};
+        std::size_t position{0u};
+        std::size_t textOffset{0u};
+    };
+
+    std::vector<Cursor> cursors{Cursor{BinaryFormat::BlockType::NodePosition},
+                                Cursor{BinaryFormat::BlockType::XYSeriesAppend},
+                                Cursor{BinaryFormat::BlockType::Json}};
+    for (auto i = 0u; i < m_index.size(); i++)
+    {
+        for (auto& cursor : cursors)
+        {
+            if (cursor.block.type == m_index[i].type)
+            {
+                cursor.blocks.emplace_back(i);
+            }
+        }
+    }
+
+    // Each block ends where the next one in the file begins,
+    // and the last one ends at the trailer
+    std::vector<uint64_t> offsets;
+    offsets.reserve(m_index.size() + 1u);
+    for (const auto& entry : m_index)
+    {
+        offsets.emplace_back(entry.offset);
+    }
+    offsets.emplace_back(m_trailerOffset);
+    std::sort(offsets.begin(), offsets.end());
+
+    // Decode the next block for `cursor`, or empty it if there are none left
+    auto loadBlock = [this, &offsets](Cursor& cursor) {
+        cursor.position = 0u;
+        cursor.textOffset = 0u;
+        if (cursor.nextBlock >= cursor.blocks.size())
+        {
+            cursor.block.Clear();
+            return;
+        }
+
+        const auto& entry = m_index[cursor.blocks[cursor.nextBlock++]];
+        const auto end = *std::upper_bound(offsets.begin(), offsets.end(), entry.offset);
+        DecodeBlock(entry, end, cursor.block);
+    };
+
+    for (auto& cursor : cursors)
+    {
+        loadBlock(cursor);
+    }
+
+    std::string buffer;
+    JsonEventEmitter emitter{buffer};
+    auto first = true;
+    while (true)
+    {
+        Cursor* next = nullptr;
+        for (auto& cursor : cursors)
+        {
+            if (cursor.position < cursor.block.sequence.size() &&
+                (!next ||
+                 cursor.block.sequence[cursor.position] < next->block.sequence[next->position]))
+            {
+                next = &cursor;
+            }
+        }
+
+        if (!next)
+        {
+            break;
+        }
+
+        if (!first)
+        {
+            output << ',';
+        }
+        first = false;
+
+        const auto& block = next->block;
+        const auto i = next->position;
+        const auto time = NanoSeconds(block.nanoseconds[i]);
+        buffer.clear();
+        switch (block.type)
+        {
+        case BinaryFormat::BlockType::NodePosition:
+            emitter.Write(CourseChangeEvent{time, block.id[i], {block.x[i], block.y[i], block.z[i]}});
+            output << buffer;
+            break;
+        case BinaryFormat::BlockType::XYSeriesAppend:
+            emitter.Write(XYSeriesAppendEvent{time, block.id[i], block.x[i], block.y[i]});
+            output << buffer;
+            break;
+        case BinaryFormat::BlockType::Json:
+            output.write(block.text.data() + next->textOffset,
+                         static_cast<std::streamsize>(block.length[i]));
+            next->textOffset += block.length[i];
+            break;
+        }
+
+        next->position++;
+        if (next->position >= block.sequence.size())
+        {
+            loadBlock(*next);
+        }
+    }
+}
+
+} // namespace ns3::netsimulyzer
@@ -0,0 +1,471 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#ifndef BINARY_OUTPUT_H
+#define BINARY_OUTPUT_H
+
+#include "event-message.h"
+
+#include <ns3/json.hpp>
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3::netsimulyzer
+{
+
+/**
+ * Layout of the binary output container.
+ *
+ * All integers are little-endian, doubles are stored as their IEEE-754 bits.
+ *
+ * - Magic (`BinaryFormat::Magic`), format version (u32)
+ * - Header: length (u64), then the JSON of the sections known
+ *   when the simulation starts (`nodes`, `buildings`, etc.)
+ * - Column blocks, see `BinaryFormat::BlockType`. Each is:
+ *   type (u8), encoding (u8), record count (u32), then each column,
+ *   stored as described by `BinaryFormat::Encoding`
+ * - Trailer: length (u64), then the JSON of the sections written
+ *   when the output is closed (`configuration`, `series`, `streams`)
+ * - Block index: block count (u32), then per block:
+ *   type (u8), record count (u32), offset (u64), first & last nanoseconds (i64)
+ * - Footer: trailer offset (u64), index offset (u64), magic
+ *
+ * Every record carries its sequence number across all blocks,
+ * so the original order of events may be restored
+ */
+namespace BinaryFormat
+{
+/**
+ * Identifies the file as NetSimulyzer binary output.
+ * Written at both the start & the end of the file
+ */
+constexpr char Magic[4]{'N', 'S', 'Z', 'B'};
+
+/**
+ * Version of the container layout
+ */
+constexpr uint32_t Version = 1u;
+
+/**
+ * The kinds of column blocks, and the columns each contains
+ */
+enum class BlockType : uint8_t
+{
+    /**
+     * `node-position` events.
+     * Columns: sequence (u64), nanoseconds (i64), id (u32), x, y, z (f64)
+     */
+    NodePosition = 1u,
+    /**
+     * `xy-series-append` events.
+     * Columns: sequence (u64), nanoseconds (i64), series id (u32), x, y (f64)
+     */
+    XYSeriesAppend = 2u,
+    /**
+     * Every other event, as the JSON the JSON output would contain.
+     * Columns: sequence (u64), nanoseconds (i64), length (u32), text (bytes)
+     */
+    Json = 3u
+};
+
+/**
+ * How the columns of a block are stored
+ */
+enum class Encoding : uint8_t
+{
+    /**
+     * Every value is written in full, at its fixed size.
+     * Columns are in the order listed in `BinaryFormat::BlockType`
+     */
+    Raw = 0u,
+    /**
+     * Integers are delta coded, then written as zigzag varints.
+     * Deltas start from zero at the beginning of each block,
+     * so blocks may be decoded independently.
+     *
+     * The block begins with the position scale (f64), and the id
+     * column comes before the nanoseconds column.
+     *
+     * - sequence: delta from the previous record
+     * - id: delta from the previous record
+     * - nanoseconds: delta from the previous record with the same id,
+     *   or the previous record for `Json` blocks
+     * - node-position x, y, z: if the scale is non-zero, each coordinate
+     *   is multiplied by the scale & rounded, then delta coded against the
+     *   previous position of the same Node. Otherwise written in full
+     * - xy-series-append x, y: written in full
+     * - Json length: varint
+     */
+    Delta = 1u
+};
+
+/**
+ * Entry in the block index, locating one column block in the file
+ */
+struct BlockIndexEntry
+{
+    BlockType type;
+    uint32_t count;
+    uint64_t offset;
+    int64_t firstNanoseconds;
+    int64_t lastNanoseconds;
+};
+
+/**
+ * The records of one block, stored by column.
+ * Only the columns used by `type` are filled
+ */
+struct ColumnBlock
+{
+    explicit ColumnBlock(BlockType blockType)
+        : type(blockType)
+    {
+    }
+
+    /**
+     * Empty every column
+     */
+    void Clear(void)
+    {
+        sequence.clear();
+        nanoseconds.clear();
+        id.clear();
+        x.clear();
+        y.clear();
+        z.clear();
+        length.clear();
+        text.clear();
+    }
+
+    BlockType type;
+    std::vector<uint64_t> sequence;
+    std::vector<int64_t> nanoseconds;
+    std::vector<uint32_t> id;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    std::vector<uint32_t> length;
+    std::string text;
+};
+
+/**
+ * The last values coded for a single Node or series,
+ * which the next values for it are delta coded against
+ * in `Encoding::Delta` blocks
+ */
+struct PreviousValues
+{
+    int64_t nanoseconds{0};
+    int64_t position[3]{0, 0, 0};
+};
+} // namespace BinaryFormat
+
+/**
+ * Writes events into the binary container described in `BinaryFormat`.
+ *
+ * Events are collected into one column block per `BinaryFormat::BlockType`,
+ * and each block is written once it holds `blockSize` records
+ */
+class BinaryOutputWriter
+{
+  public:
+    /**
+     * Create a writer for `output`. Nothing is written until `WriteHeader()`
+     *
+     * @param output
+     * The stream to write to, should be opened in binary mode.
+     * Must outlive the writer
+     *
+     * @param blockSize
+     * The number of records to collect in a block before it is written
+     *
+     * @param encoding
+     * How the columns of each block are stored
+     *
+     * @param positionResolution
+     * The distance to round Node positions to, e.g. 0.001 for millimeters.
+     * 0 keeps positions exact. Only used with `BinaryFormat::Encoding::Delta`
+     */
+    BinaryOutputWriter(std::ostream& output,
+                       uint32_t blockSize,
+                       BinaryFormat::Encoding encoding = BinaryFormat::Encoding::Raw,
+                       double positionResolution = 0.0);
+
+    /**
+     * Write the file magic, version, & `header`.
+     * Must be called before any events are written
+     *
+     * @param header
+     * The sections of the document which are complete when the simulation starts
+     */
+    void WriteHeader(const nlohmann::json& header);
+
+    /**
+     * Add `event` to its column block, and write that block if it is full
+     *
+     * @param event
+     * The event to write
+     */
+    void Write(const EventRecord& event);
+
+    /**
+     * Write any partial blocks, `trailer`, the block index, & the footer.
+     * No more events may be written after this call
+     *
+     * @param trailer
+     * The sections of the document which may change during the simulation
+     */
+    void Finish(const nlohmann::json& trailer);
+
+  private:
+    /**
+     * Start a record in `block`, and write the block if
+     * the record fills it
+     *
+     * @param block
+     * The block the record was added to. The other columns must already be filled
+     *
+     * @param time
+     * The time of the event
+     */
+    void FinishRecord(BinaryFormat::ColumnBlock& block, Time time);
+
+    /**
+     * Write the columns of `block` to the output, record it
+     * in the index, & empty it
+     *
+     * @param block
+     * The block to write. Ignored if empty
+     */
+    void WriteBlock(BinaryFormat::ColumnBlock& block);
+
+    /**
+     * Append the columns of `block` to `m_scratch`,
+     * using `BinaryFormat::Encoding::Raw`
+     *
+     * @param block
+     * The block to encode
+     */
+    void AppendRawColumns(const BinaryFormat::ColumnBlock& block);
+
+    /**
+     * Append the columns of `block` to `m_scratch`,
+     * using `BinaryFormat::Encoding::Delta`
+     *
+     * @param block
+     * The block to encode
+     */
+    void EncodeDelta(const BinaryFormat::ColumnBlock& block);
+
+    /**
+     * Write `bytes` to the output, & track the offset
+     *
+     * @param bytes
+     * The data to write
+     */
+    void WriteBytes(const std::string& bytes);
+
+    /**
+     * The stream to write to
+     */
+    std::ostream& m_output;
+
+    /**
+     * Number of records to collect in a block before it is written
+     */
+    uint32_t m_blockSize;
+
+    /**
+     * How the columns of each block are stored
+     */
+    BinaryFormat::Encoding m_encoding;
+
+    /**
+     * Multiplier applied to Node positions before rounding them.
+     * 0 when positions are kept exact
+     */
+    double m_positionScale{0.0};
+
+    /**
+     * Number of bytes written so far, used for the offsets in the index
+     */
+    uint64_t m_offset{0u};
+
+    /**
+     * Sequence number of the next event
+     */
+    uint64_t m_nextSequence{0u};
+
+    /**
+     * Blocks of `node-position` events
+     */
+    BinaryFormat::ColumnBlock m_positions{BinaryFormat::BlockType::NodePosition};
+
+    /**
+     * Blocks of `xy-series-append` events
+     */
+    BinaryFormat::ColumnBlock m_xySeriesAppends{BinaryFormat::BlockType::XYSeriesAppend};
+
+    /**
+     * Blocks of every other event
+     */
+    BinaryFormat::ColumnBlock m_json{BinaryFormat::BlockType::Json};
+
+    /**
+     * Index of every block written so far
+     */
+    std::vector<BinaryFormat::BlockIndexEntry> m_index;
+
+    /**
+     * Reused buffer for serializing a block
+     */
+    std::string m_scratch;
+
+    /**
+     * Previous values for each id in the block being encoded.
+     * Reset for every block
+     */
+    std::unordered_map<uint32_t, BinaryFormat::PreviousValues> m_previous;
+};
+
+/**
+ * Reads a file written by `BinaryOutputWriter`, and converts it
+ * back to the JSON output format.
+ *
+ * Aborts on a malformed file
+ */
+class BinaryOutputReader
+{
+  public:
+    /**
+     * Read the header, trailer, & block index from `input`
+     *
+     * @param input
+     * The stream to read from, opened in binary mode.
+     * Must outlive the reader
+     */
+    explicit BinaryOutputReader(std::istream& input);
+
+    /**
+     * @return
+     * The sections written when the simulation started
+     */
+    const nlohmann::json& GetHeader(void) const;
+
+    /**
+     * @return
+     * The sections written when the output was closed
+     */
+    const nlohmann::json& GetTrailer(void) const;
+
+    /**
+     * @return
+     * Where each block is in the file
+     */
+    const std::vector<BinaryFormat::BlockIndexEntry>& GetIndex(void) const;
+
+    /**
+     * Write the complete JSON document, the same as the
+     * JSON output would have, to `output`
+     *
+     * @param output
+     * Where to write the document
+     */
+    void WriteJson(std::ostream& output);
+
+  private:
+    /**
+     * Load & decode the block described by `entry`
+     *
+     * @param entry
+     * The block to read
+     *
+     * @param end
+     * Offset one past the last byte of the block
+     *
+     * @param block
+     * Where to store the decoded records. Replaces any existing contents
+     */
+    void DecodeBlock(const BinaryFormat::BlockIndexEntry& entry,
+                     uint64_t end,
+                     BinaryFormat::ColumnBlock& block);
+
+    /**
+     * Write every event, in their original order,
+     * as the contents of the `events` array
+     *
+     * @param output
+     * Where to write the events
+     */
+    void WriteEvents(std::ostream& output);
+
+    /**
+     * The stream to read from
+     */
+    std::istream& m_input;
+
+    /**
+     * Sections from the header
+     */
+    nlohmann::json m_header;
+
+    /**
+     * Sections from the trailer
+     */
+    nlohmann::json m_trailer;
+
+    /**
+     * Where each block is in the file
+     */
+    std::vector<BinaryFormat::BlockIndexEntry> m_index;
+
+    /**
+     * Offset of the trailer, which follows the last block
+     */
+    uint64_t m_trailerOffset{0u};
+
+    /**
+     * Previous values for each id in the block being decoded.
+     * Reset for every block
+     */
+    std::unordered_map<uint32_t, BinaryFormat::PreviousValues> m_previous;
+};
+
+} // namespace ns3::netsimulyzer
+
+#endif // BINARY_OUTPUT_H
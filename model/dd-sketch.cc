@@ -0,0 +1,197 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "dd-sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3::netsimulyzer
+{
+
+DdSketch::DdSketch(double relativeError)
+    : m_relativeError(relativeError),
+      m_gamma((1.0 + relativeError) / (1.0 - relativeError)),
+      m_logGamma(std::log(m_gamma))
+{
+}
+
+void
+DdSketch::Add(double value)
+{
+    m_count++;
+
+    // Infinities have no bucket index, so they have their own buckets at either end
+    if (std::isinf(value))
+    {
+        if (value > 0.0)
+            m_positiveInfinityCount++;
+        else
+            m_negativeInfinityCount++;
+        return;
+    }
+
+    const auto magnitude = std::abs(value);
+    if (!(magnitude >= std::numeric_limits<double>::min()))
+    {
+        // Also catches NaN, which is counted as zero
+        m_zeroCount++;
+        return;
+    }
+
+    if (value > 0.0)
+        m_positive[GetIndex(magnitude)]++;
+    else
+        m_negative[GetIndex(magnitude)]++;
+}
+
+template <typename F>
+void
+DdSketch::ForEachBucket(F f) const
+{
+    if (m_negativeInfinityCount > 0u)
+        f(-std::numeric_limits<double>::infinity(), m_negativeInfinityCount);
+
+    // Largest negative magnitude first
+    for (auto iter = m_negative.rbegin(); iter != m_negative.rend(); iter++)
+        f(-GetValue(iter->first), iter->second);
+
+    if (m_zeroCount > 0u)
+        f(0.0, m_zeroCount);
+
+    for (const auto& [index, count] : m_positive)
+        f(GetValue(index), count);
+
+    if (m_positiveInfinityCount > 0u)
+        f(std::numeric_limits<double>::infinity(), m_positiveInfinityCount);
+}
+
+double
+DdSketch::GetQuantile(double q) const
+{
+    if (m_count == 0u)
+        return 0.0;
+
+    // The rank of the value at `q`, starting from 0
+    const auto rank = q * static_cast<double>(m_count - 1u);
+    uint64_t seen = 0u;
+    auto quantile = 0.0;
+    auto found = false;
+    ForEachBucket([rank, &seen, &quantile, &found](double value, uint64_t count) {
+        seen += count;
+        if (!found && static_cast<double>(seen) > rank)
+        {
+            quantile = value;
+            found = true;
+        }
+    });
+
+    return quantile;
+}
+
+void
+DdSketch::GetQuantiles(std::size_t count, std::vector<double>& values) const
+{
+    values.clear();
+    if (m_count == 0u || count == 0u)
+        return;
+
+    values.reserve(count);
+    const auto last = static_cast<double>(m_count - 1u);
+    uint64_t seen = 0u;
+    ForEachBucket([count, last, &seen, &values](double value, uint64_t bucketCount) {
+        seen += bucketCount;
+
+        // The value of every quantile whose rank falls in this bucket
+        while (values.size() < count &&
+               static_cast<double>(seen) >
+                   static_cast<double>(values.size() + 1u) / static_cast<double>(count) * last)
+        {
+            values.push_back(value);
+        }
+    });
+}
+
+double
+DdSketch::GetCdf(double value) const
+{
+    if (m_count == 0u)
+        return 0.0;
+
+    uint64_t below = 0u;
+    ForEachBucket([value, &below](double bucketValue, uint64_t count) {
+        if (bucketValue <= value)
+            below += count;
+    });
+
+    return static_cast<double>(below) / static_cast<double>(m_count);
+}
+
+uint64_t
+DdSketch::GetCount(void) const
+{
+    return m_count;
+}
+
+std::size_t
+DdSketch::GetBucketCount(void) const
+{
+    return m_positive.size() + m_negative.size() + (m_zeroCount > 0u ? 1u : 0u) +
+           (m_negativeInfinityCount > 0u ? 1u : 0u) + (m_positiveInfinityCount > 0u ? 1u : 0u);
+}
+
+double
+DdSketch::GetRelativeError(void) const
+{
+    return m_relativeError;
+}
+
+int64_t
+DdSketch::GetIndex(double magnitude) const
+{
+    // Only a relative error too small to represent
+    // gets near the range of the index, keep it in range anyway
+    constexpr auto limit = static_cast<double>(std::numeric_limits<int64_t>::max() / 2);
+    const auto index = std::ceil(std::log(magnitude) / m_logGamma);
+    return static_cast<int64_t>(std::min(std::max(index, -limit), limit));
+}
+
+double
+DdSketch::GetValue(int64_t index) const
+{
+    // Bucket `index` holds (gamma^(index - 1), gamma^index]
+    return 2.0 * std::pow(m_gamma, index) / (m_gamma + 1.0);
+}
+
+} // namespace ns3::netsimulyzer
@@ -0,0 +1,201 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#ifndef DD_SKETCH_H
+#define DD_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace ns3::netsimulyzer
+{
+
+/**
+ * A DDSketch of a distribution of values.
+ *
+ * Values are counted in buckets of exponentially increasing width,
+ * so any quantile is estimated within a relative error of the true value.
+ * The number of buckets only grows with the range of magnitudes of the values,
+ * not the number of values
+ */
+class DdSketch
+{
+  public:
+    /**
+     * Set up an empty sketch
+     *
+     * @param relativeError
+     * The largest error of an estimated quantile,
+     * relative to the true value. Should be between 0 & 1, exclusive
+     */
+    explicit DdSketch(double relativeError);
+
+    /**
+     * Count a value
+     *
+     * @param value
+     * The value to count. Infinities are counted in their own buckets,
+     * below & above every other value. NaN is counted as zero
+     */
+    void Add(double value);
+
+    /**
+     * @param q
+     * The quantile to estimate, from 0 to 1 inclusive
+     *
+     * @return
+     * The estimated value of quantile `q`. Zero if the sketch is empty
+     */
+    double GetQuantile(double q) const;
+
+    /**
+     * Estimate `count` evenly spaced quantiles, with a single pass over the buckets
+     *
+     * @param count
+     * The number of quantiles to estimate. Quantile `k / count`
+     * is estimated for each `k` from 1 to `count`
+     *
+     * @param[out] values
+     * Replaced with the estimated value of each quantile, from smallest to largest.
+     * Empty if the sketch is empty
+     */
+    void GetQuantiles(std::size_t count, std::vector<double>& values) const;
+
+    /**
+     * @param value
+     * The value to check
+     *
+     * @return
+     * The estimated fraction of counted values less than or equal to `value`.
+     * Zero if the sketch is empty
+     */
+    double GetCdf(double value) const;
+
+    /**
+     * @return
+     * The number of values counted
+     */
+    uint64_t GetCount(void) const;
+
+    /**
+     * @return
+     * The number of non-empty buckets
+     */
+    std::size_t GetBucketCount(void) const;
+
+    /**
+     * @return
+     * The relative error the sketch was set up with
+     */
+    double GetRelativeError(void) const;
+
+  private:
+    /**
+     * Call `f` with the estimated value & count of each bucket,
+     * from the smallest value to the largest
+     *
+     * @param f
+     * Called with the value (`double`) and its count (`uint64_t`)
+     */
+    template <typename F>
+    void ForEachBucket(F f) const;
+
+    /**
+     * @param magnitude
+     * The absolute value of a value to count. Must be positive & finite
+     *
+     * @return
+     * The index of the bucket containing `magnitude`
+     */
+    int64_t GetIndex(double magnitude) const;
+
+    /**
+     * @param index
+     * The index of a bucket
+     *
+     * @return
+     * The magnitude estimating every value in the bucket
+     */
+    double GetValue(int64_t index) const;
+
+    /**
+     * The relative error the sketch was set up with
+     */
+    double m_relativeError;
+
+    /**
+     * The ratio of the upper & lower bounds of each bucket
+     */
+    double m_gamma;
+
+    /**
+     * The natural logarithm of `m_gamma`
+     */
+    double m_logGamma;
+
+    /**
+     * The count of each bucket of positive values, by index
+     */
+    std::map<int64_t, uint64_t> m_positive;
+
+    /**
+     * The count of each bucket of negative values, by the index of their magnitude
+     */
+    std::map<int64_t, uint64_t> m_negative;
+
+    /**
+     * The number of values too close to zero to be indexed
+     */
+    uint64_t m_zeroCount{0u};
+
+    /**
+     * The number of values counted which were negative infinity
+     */
+    uint64_t m_negativeInfinityCount{0u};
+
+    /**
+     * The number of values counted which were positive infinity
+     */
+    uint64_t m_positiveInfinityCount{0u};
+
+    /**
+     * The total number of values counted
+     */
+    uint64_t m_count{0u};
+};
+
+} // namespace ns3::netsimulyzer
+
+#endif
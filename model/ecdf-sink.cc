@@ -34,17 +34,26 @@
 #include "ecdf-sink.h"
 
 #include "netsimulyzer-ns3-compatibility.h"
+#include "orchestrator.h"
 
+#include "ns3/abort.h"
+#include "ns3/assert.h"
 #include "ns3/double.h"
 #include "ns3/enum.h"
 #include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
 
 namespace ns3::netsimulyzer
 {
 
 EcdfSink::EcdfSink(Ptr<Orchestrator> orchestrator, const std::string& name)
+    : m_orchestrator(orchestrator)
 {
     m_series = CreateObject<XYSeries>(orchestrator);
     m_series->SetAttribute("Connection", EnumValue(XYSeries::ConnectionType::None));
@@ -56,8 +65,6 @@ EcdfSink::EcdfSink(Ptr<Orchestrator> orchestrator, const std::string& name)
     yAxis->SetAttribute("Maximum", DoubleValue(1.0));
 
     m_series->SetAttribute("Name", StringValue(name));
-
-    m_timer.SetFunction(&EcdfSink::Flush, this);
 }
 
 TypeId
@@ -106,6 +113,37 @@ EcdfSink::GetTypeId(void)
                           TimeValue(Seconds(1.0)),
                           MakeTimeAccessor(&EcdfSink::SetInterval, &EcdfSink::GetInterval),
                           MakeTimeChecker())
+            .AddAttribute("MinFlushInterval",
+                          "The shortest time between updates of the plot "
+                          "when the `FlushMode` attribute is set to `OnWrite`. "
+                          "Values appended sooner are written by a single update "
+                          "once the interval passes. Zero updates on every append",
+                          TimeValue(Time()),
+                          MakeTimeAccessor(&EcdfSink::m_minFlushInterval),
+                          MakeTimeChecker(Time()))
+            .AddAttribute("BinWidth",
+                          "Round appended values to the nearest multiple of this width, "
+                          "counting them in fixed bins. Zero counts each distinct value. "
+                          "Must be set before any value is appended",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&EcdfSink::SetBinWidth, &EcdfSink::GetBinWidth),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("SketchRelativeError",
+                          "Count appended values in a DDSketch, with at most this error "
+                          "relative to each value, keeping memory bounded. "
+                          "The plot is drawn from `SketchPoints` quantiles. "
+                          "Zero counts each distinct value. "
+                          "Must be set before any value is appended",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&EcdfSink::SetSketchRelativeError,
+                                             &EcdfSink::GetSketchRelativeError),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("SketchPoints",
+                          "The number of evenly spaced quantiles drawn "
+                          "when `SketchRelativeError` is set",
+                          UintegerValue(100u),
+                          MakeUintegerAccessor(&EcdfSink::m_sketchPoints),
+                          MakeUintegerChecker<uint32_t>(1u))
             .AddAttribute("XAxis",
                           "The X axis of the internal series",
                           TypeId::ATTR_GET,
@@ -154,11 +192,7 @@ void
 EcdfSink::SetFlushMode(EcdfSink::FlushMode mode)
 {
     m_flushMode = mode;
-
-    if (m_flushMode == FlushMode::Interval && m_timer.GetDelay().IsPositive())
-        m_timer.Schedule();
-    else
-        m_timer.Cancel();
+    UpdateClock();
 }
 
 XYSeries::ConnectionType
@@ -178,44 +212,162 @@ void
 EcdfSink::SetConnectionType(XYSeries::ConnectionType value)
 {
     m_series->SetAttribute("Connection", EnumValue(value));
+
+    // The steps written depend on the connection type
+    m_changed = true;
 }
 
 void
 EcdfSink::Append(double value)
 {
-    auto iter = std::find_if(m_data.begin(), m_data.end(), [value](const auto& item) {
-        return item.point == value;
-    });
-    if (iter != m_data.end())
-        iter->frequency++;
+    if (m_sketch.has_value())
+        m_sketch->Add(value);
+    else if (m_binWidth <= 0.0)
+        m_data[value]++;
     else
-        m_data.push_back(PointFrequency{value, 1u});
-
-    std::sort(m_data.begin(), m_data.end());
+        AddToBin(value);
 
     m_totalPoints++;
+    m_changed = true;
 
-    if (m_flushMode == FlushMode::OnWrite)
-        Flush();
+    if (m_flushMode != FlushMode::OnWrite)
+        return;
+
+    if (m_minFlushInterval.IsPositive() && m_lastFlush.has_value())
+    {
+        const auto next = m_lastFlush.value() + m_minFlushInterval;
+        if (Simulator::Now() < next)
+        {
+            // Write every append until `next` with one flush,
+            // unless it would not be written
+            if (!m_deferredFlush.has_value() && next <= m_orchestrator->GetStopTime())
+                m_deferredFlush =
+                    Simulator::Schedule(next - Simulator::Now(), &EcdfSink::Flush, this);
+            return;
+        }
+    }
+
+    Flush();
 }
 
 void
-EcdfSink::SetInterval(Time interval)
+EcdfSink::AddToBin(double value)
 {
-    NS_ASSERT_MSG(interval.IsPositive(), "`interval` must be greater than 0");
-    if (m_timer.IsRunning())
-        m_timer.Cancel();
+    NS_ABORT_MSG_IF(!std::isfinite(value),
+                    "EcdfSink with `BinWidth` set cannot count a non-finite value: " << value);
+
+    // Checked before converting, since a value far from
+    // the others may not fit in an `int64_t`. Leaves room
+    // for `m_firstBin` & the bins grown past it
+    const auto scaled = std::round(value / m_binWidth);
+    constexpr auto binRange = static_cast<double>(std::numeric_limits<int64_t>::max() / 4);
+    NS_ABORT_MSG_IF(!(std::abs(scaled) <= binRange),
+                    "EcdfSink value: " << value << " is too large for `BinWidth` " << m_binWidth);
+
+    const auto empty = m_bins.GetSize() == 0u;
+    const auto low = empty ? scaled : std::min(scaled, static_cast<double>(m_minBin));
+    const auto high = empty ? scaled : std::max(scaled, static_cast<double>(m_maxBin));
+    NS_ABORT_MSG_IF(high - low >= static_cast<double>(MaxBins),
+                    "EcdfSink values span more than " << MaxBins << " bins of `BinWidth` "
+                                                      << m_binWidth << ", at value: " << value
+                                                      << ". Use a larger `BinWidth`");
+
+    const auto bin = static_cast<int64_t>(scaled);
+
+    // Grow by at least the current size, so repeated growth is amortized,
+    // without allocating much past `MaxBins`
+    const auto slack = m_bins.GetSize() < MaxBins
+                           ? std::min(m_bins.GetSize(), MaxBins - m_bins.GetSize())
+                           : std::size_t{0u};
+    if (empty)
+    {
+        m_firstBin = bin;
+        m_minBin = bin;
+        m_maxBin = bin;
+        m_bins.Extend(1u);
+    }
+    else if (bin < m_firstBin)
+    {
+        const auto grow = std::max(static_cast<std::size_t>(m_firstBin - bin), slack);
+        m_bins.Prepend(grow);
+        m_firstBin -= static_cast<int64_t>(grow);
+    }
+    else if (static_cast<std::size_t>(bin - m_firstBin) >= m_bins.GetSize())
+    {
+        const auto needed = static_cast<std::size_t>(bin - m_firstBin) + 1u - m_bins.GetSize();
+        m_bins.Extend(std::max(needed, slack));
+    }
 
-    m_timer.SetDelay(interval);
+    m_minBin = std::min(m_minBin, bin);
+    m_maxBin = std::max(m_maxBin, bin);
+    m_bins.Add(static_cast<std::size_t>(bin - m_firstBin), 1u);
+}
 
-    if (m_flushMode == FlushMode::Interval)
-        m_timer.Schedule();
+void
+EcdfSink::SetInterval(Time interval)
+{
+    NS_ASSERT_MSG(interval.IsPositive(), "`interval` must be greater than 0");
+    m_interval = interval;
+    UpdateClock();
 }
 
 Time
 EcdfSink::GetInterval(void) const
 {
-    return m_timer.GetDelay();
+    return m_interval;
+}
+
+void
+EcdfSink::UpdateClock(void)
+{
+    if (m_clock)
+    {
+        m_clock->Unregister(m_clockSlot);
+        m_clock.reset();
+    }
+
+    if (m_flushMode != FlushMode::Interval || !m_interval.IsStrictlyPositive() || !m_orchestrator)
+        return;
+
+    m_clock = m_orchestrator->GetSinkClock(m_interval);
+    m_clockSlot = m_clock->Register([this](uint64_t, Time) { Flush(); });
+}
+
+void
+EcdfSink::SetBinWidth(double width)
+{
+    NS_ABORT_MSG_IF(m_totalPoints > 0u, "`BinWidth` must be set before any value is appended");
+    NS_ABORT_MSG_IF(width > 0.0 && m_sketch.has_value(),
+                    "`BinWidth` may not be used with `SketchRelativeError`");
+    NS_ASSERT_MSG(width >= 0.0, "`width` must not be negative");
+    m_binWidth = width;
+}
+
+double
+EcdfSink::GetBinWidth(void) const
+{
+    return m_binWidth;
+}
+
+void
+EcdfSink::SetSketchRelativeError(double error)
+{
+    NS_ABORT_MSG_IF(m_totalPoints > 0u,
+                    "`SketchRelativeError` must be set before any value is appended");
+    NS_ABORT_MSG_IF(error > 0.0 && m_binWidth > 0.0,
+                    "`SketchRelativeError` may not be used with `BinWidth`");
+    NS_ABORT_MSG_IF(error < 0.0 || error >= 1.0, "`error` must be in [0, 1)");
+
+    if (error > 0.0)
+        m_sketch.emplace(error);
+    else
+        m_sketch.reset();
+}
+
+double
+EcdfSink::GetSketchRelativeError(void) const
+{
+    return m_sketch.has_value() ? m_sketch->GetRelativeError() : 0.0;
 }
 
 void
@@ -230,57 +382,130 @@ EcdfSink::SetRangeScaling(double min, double max)
     m_series->GetXAxis()->ScalingRange(min, max);
 }
 
+template <typename F>
 void
-EcdfSink::Flush(void)
+EcdfSink::ForEachPoint(F f)
 {
-    m_series->Clear();
-    double total = 0.0;
-
-    auto connectionMode = MakeEnumValueCompat<XYSeries::ConnectionType>();
-    m_series->GetAttribute("Connection", connectionMode);
-
-    if (connectionMode.Get() == XYSeries::ConnectionType::None)
+    const auto totalPoints = static_cast<double>(m_totalPoints);
+    if (m_sketch.has_value())
     {
-        for (const auto& [point, count] : m_data)
+        // Each quantile is an even share, merged where quantiles share a bucket
+        m_sketch->GetQuantiles(m_sketchPoints, m_quantiles);
+        const auto share = 1.0 / static_cast<double>(m_quantiles.size());
+        for (std::size_t i = 0u; i < m_quantiles.size();)
         {
-            auto percent = static_cast<double>(count) / m_totalPoints;
-            m_series->Append(point, percent + total);
-            total += percent;
+            auto end = i + 1u;
+            while (end < m_quantiles.size() && m_quantiles[end] == m_quantiles[i])
+                end++;
+
+            f(m_quantiles[i], static_cast<double>(end - i) * share);
+            i = end;
         }
+        return;
+    }
 
+    if (m_binWidth <= 0.0)
+    {
+        for (const auto& [point, count] : m_data)
+            f(point, static_cast<double>(count) / totalPoints);
         return;
     }
 
-    // Line/spline
+    if (m_bins.GetSize() == 0u)
+        return;
 
-    double lastY = 0.0;
-    for (const auto& [point, count] : m_data)
+    // Only the bins with values, not those added for growth
+    const auto last = static_cast<std::size_t>(m_maxBin - m_firstBin);
+    for (auto index = static_cast<std::size_t>(m_minBin - m_firstBin); index <= last; index++)
     {
-        auto percent = static_cast<double>(count) / m_totalPoints;
-        m_series->Append(point, lastY);
-
-        const auto y = percent + total;
-        m_series->Append(point, y);
-        lastY = y;
+        const auto count = m_bins.Get(index);
+        if (count > 0u)
+            f(static_cast<double>(m_firstBin + static_cast<int64_t>(index)) * m_binWidth,
+              static_cast<double>(count) / totalPoints);
+    }
+}
 
-        total += percent;
+void
+EcdfSink::Flush(void)
+{
+    if (m_deferredFlush.has_value())
+    {
+        Simulator::Cancel(m_deferredFlush.value());
+        m_deferredFlush.reset();
     }
 
-    if (m_flushMode == FlushMode::Interval)
-        m_timer.Schedule();
+    // The graph would be rewritten the same
+    if (!m_changed)
+        return;
+
+    m_changed = false;
+    m_lastFlush = Simulator::Now();
+
+    auto connectionMode = MakeEnumValueCompat<XYSeries::ConnectionType>();
+    m_series->GetAttribute("Connection", connectionMode);
+    const auto steps = connectionMode.Get() != XYSeries::ConnectionType::None;
+
+    // Write the whole graph as a single event, rather than one event per point
+    m_points.clear();
+    double total = 0.0;
+    ForEachPoint([this, &total, steps](double point, double fraction) {
+        // Line/spline, step up from the previous value
+        if (steps)
+            m_points.push_back({point, total});
+
+        total += fraction;
+        m_points.push_back({point, total});
+    });
+
+    m_series->Clear();
+    m_series->Append(m_points);
 }
 
 void
 EcdfSink::DoDispose(void)
 {
-    m_timer.Cancel();
+    if (m_clock)
+    {
+        m_clock->Unregister(m_clockSlot);
+        m_clock.reset();
+    }
+    m_orchestrator = nullptr;
+    if (m_deferredFlush.has_value())
+    {
+        Simulator::Cancel(m_deferredFlush.value());
+        m_deferredFlush.reset();
+    }
     Object::DoDispose();
 }
 
-bool
-EcdfSink::PointFrequency::operator<(const EcdfSink::PointFrequency& other) const
+double
+EcdfSink::GetCdf(double value) const
 {
-    return point < other.point;
+    if (m_totalPoints == 0u)
+        return 0.0;
+
+    if (m_sketch.has_value())
+        return m_sketch->GetCdf(value);
+
+    if (m_binWidth > 0.0)
+    {
+        // Compared before converting, as `value` may be far outside the bins, or not finite
+        const auto scaled = std::round(value / m_binWidth);
+        if (std::isnan(scaled) || scaled < static_cast<double>(m_minBin))
+            return 0.0;
+        if (scaled >= static_cast<double>(m_maxBin))
+            return 1.0;
+
+        const auto index = static_cast<std::size_t>(static_cast<int64_t>(scaled) - m_firstBin);
+        return static_cast<double>(m_bins.GetPrefixSum(index)) /
+               static_cast<double>(m_totalPoints);
+    }
+
+    uint64_t count = 0u;
+    for (auto iter = m_data.begin(); iter != m_data.end() && iter->first <= value; iter++)
+        count += iter->second;
+
+    return static_cast<double>(count) / static_cast<double>(m_totalPoints);
 }
 
 } // namespace ns3::netsimulyzer
@@ -34,15 +34,24 @@
 #ifndef ECDF_SINK_H
 #define ECDF_SINK_H
 
+#include "dd-sketch.h"
+#include "fenwick-tree.h"
+#include "sink-clock.h"
 #include "value-axis.h"
 #include "xy-series.h"
 
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
 #include "ns3/object.h"
 #include "ns3/pointer.h"
 #include "ns3/ptr.h"
 #include "ns3/string.h"
-#include "ns3/timer.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
 #include <vector>
 
 namespace ns3::netsimulyzer
@@ -61,13 +70,20 @@ class Orchestrator;
 class EcdfSink : public Object
 {
   public:
+    /**
+     * The most bins values may span when `BinWidth` is set.
+     * Appending a value outside this span aborts
+     */
+    static constexpr std::size_t MaxBins{1u << 20u};
+
     /**
      * Possible modes for when the data should be used to refresh the
      * graph.
      *
      * `OnWrite`: Updates the graph every time `Append()` is called
      *
-     * `Interval`: Updates the graph when the contained timer expires
+     * `Interval`: Updates the graph every interval, between the
+     * `StartTime` & `StopTime` of the Orchestrator
      *
      * `Manual`: Only updates the graph when `Flush()` is called by the user
      *
@@ -179,17 +195,56 @@ class EcdfSink : public Object
     void SetInterval(Time interval);
 
     /**
-     * Gets the interval set for the internal flush timer.
+     * Gets the interval between flushes.
      *
      * Only used when `FlushMode::Interval` is used
      *
      * @see FlushMode
      *
      * @return
-     * The interval of the contained timer.
+     * The interval between flushes.
      */
     Time GetInterval(void) const;
 
+    /**
+     * Round appended values to the nearest multiple of `width`,
+     * counting them in fixed bins instead of by distinct value.
+     *
+     * Bins span from the smallest to the largest value appended,
+     * so `width` should be chosen for the expected range of values.
+     * Must be set before any value is appended
+     *
+     * @param width
+     * The width of each bin. Zero counts each distinct value
+     */
+    void SetBinWidth(double width);
+
+    /**
+     * @return
+     * The width of each bin. Zero if each distinct value is counted
+     */
+    double GetBinWidth(void) const;
+
+    /**
+     * Count appended values in a DDSketch instead of by distinct value,
+     * so memory only grows with the range of magnitudes of the values.
+     *
+     * The graph is drawn from `SketchPoints` evenly spaced quantiles,
+     * each within `error` of the true value, relative to that value.
+     * Must be set before any value is appended, and may not be used with `BinWidth`
+     *
+     * @param error
+     * The largest relative error of each drawn quantile, less than 1.
+     * Zero counts each distinct value
+     */
+    void SetSketchRelativeError(double error);
+
+    /**
+     * @return
+     * The relative error of the sketch. Zero if each distinct value is counted
+     */
+    double GetSketchRelativeError(void) const;
+
     /**
      * Convenience method to set up the value (X) axis with a
      * fixed range.
@@ -230,8 +285,8 @@ class EcdfSink : public Object
      * if the flush mode is `FlushMode::OnWrite`, then this
      * also triggers a `Flush()`
      *
-     * An individual value may appear at most approximately `4.29 · 10^9` times,
-     * although this value may be higher on some platforms
+     * O(log n) in the number of distinct values,
+     * or bins/buckets if `BinWidth`/`SketchRelativeError` is set
      *
      * @param value
      * The measured value to plot
@@ -240,7 +295,8 @@ class EcdfSink : public Object
 
     /**
      * Regenerates the graph based on the contained data and
-     * connection mode
+     * connection mode, as a single batch of points.
+     * Nothing is written if no value was appended since the last flush
      *
      * May be called when using any flush mode, but must be
      * called at some point if using `FlushMode::Manual`
@@ -249,22 +305,52 @@ class EcdfSink : public Object
      */
     void Flush(void);
 
+    /**
+     * Get the fraction of appended values less than or equal to `value`.
+     *
+     * O(log n) if `BinWidth` is set, where `value` is rounded the same
+     * as appended values. Otherwise, linear in the number of distinct values
+     *
+     * @param value
+     * The value to find the fraction for
+     *
+     * @return
+     * The fraction of appended values at or below `value`.
+     * Zero if no values have been appended
+     */
+    double GetCdf(double value) const;
+
   protected:
     void DoDispose(void) override;
 
   private:
     /**
-     * Internal structure which stores a given
-     * data point and how often it occurs
+     * Call `f` with each distinct value, bin, or quantile with a count,
+     * and the fraction of all values it holds, from the smallest value to the largest
      *
-     * Default sorted by the `frequency` value
+     * @param f
+     * Called with the value (`double`) and its fraction (`double`)
      */
-    struct PointFrequency
-    {
-        double point;
-        unsigned int frequency = 0u;
-        bool operator<(const PointFrequency& other) const;
-    };
+    template <typename F>
+    void ForEachPoint(F f);
+
+    /**
+     * Count `value` in the bin it rounds to,
+     * adding bins as needed.
+     *
+     * Aborts if `value` is not finite, or the values
+     * would span more than `MaxBins` bins
+     *
+     * @param value
+     * The appended value. `m_binWidth` must be set
+     */
+    void AddToBin(double value);
+
+    /**
+     * Register with the clock for `m_interval` if the flush mode is `Interval`,
+     * leaving any previous clock
+     */
+    void UpdateClock(void);
 
     /**
      * The series used to generate the graph
@@ -277,23 +363,115 @@ class EcdfSink : public Object
     FlushMode m_flushMode;
 
     /**
-     * The timer used when the flush mode is set to `Interval`
+     * The Orchestrator managing the series
+     */
+    Ptr<Orchestrator> m_orchestrator;
+
+    /**
+     * The interval between flushes when the flush mode is set to `Interval`
+     *
+     * @see FlushMode
+     */
+    Time m_interval;
+
+    /**
+     * The clock flushing the graph when the flush mode is set to `Interval`.
+     * Null in every other mode
      *
      * @see FlushMode
      */
-    Timer m_timer;
+    std::shared_ptr<SinkClock> m_clock;
+
+    /**
+     * This sink's slot in `m_clock`
+     */
+    std::size_t m_clockSlot{0u};
+
+    /**
+     * The shortest time between flushes in `FlushMode::OnWrite`.
+     * Set by the `MinFlushInterval` attribute
+     */
+    Time m_minFlushInterval;
+
+    /**
+     * The time of the last flush which wrote the graph
+     */
+    std::optional<Time> m_lastFlush;
+
+    /**
+     * The flush writing appends held back by `m_minFlushInterval`
+     */
+    std::optional<EventId> m_deferredFlush;
+
+    /**
+     * Flag for a value appended since the last flush
+     */
+    bool m_changed{false};
+
+    /**
+     * The points written by the last flush.
+     * Kept to reuse the allocation
+     */
+    std::vector<XYPoint> m_points;
+
+    /**
+     * The number of times each distinct value was appended.
+     * Only used if `m_binWidth` is zero
+     */
+    std::map<double, uint64_t> m_data;
+
+    /**
+     * The width of each bin. Zero to count each distinct value in `m_data`.
+     * Set by the `BinWidth` attribute
+     */
+    double m_binWidth{0.0};
+
+    /**
+     * The count of each bin, from `m_firstBin` up.
+     * Only used if `m_binWidth` is set
+     */
+    FenwickTree m_bins;
+
+    /**
+     * The multiple of `m_binWidth` of index 0 of `m_bins`
+     */
+    int64_t m_firstBin{0};
+
+    /**
+     * The smallest bin with a value.
+     * Only meaningful once `m_bins` is not empty
+     */
+    int64_t m_minBin{0};
+
+    /**
+     * The largest bin with a value.
+     * Only meaningful once `m_bins` is not empty
+     */
+    int64_t m_maxBin{0};
+
+    /**
+     * The sketch of the appended values.
+     * Only set by the `SketchRelativeError` attribute
+     */
+    std::optional<DdSketch> m_sketch;
+
+    /**
+     * The number of quantiles to draw from `m_sketch`.
+     * Set by the `SketchPoints` attribute
+     */
+    uint32_t m_sketchPoints{100u};
 
     /**
-     * The vector containing one record of each unique appended data point
-     * and the frequency it occurs
+     * The quantiles drawn by the last flush.
+     * Kept to reuse the allocation
      */
-    std::vector<PointFrequency> m_data;
+    std::vector<double> m_quantiles;
 
     /**
      * Total number of appended points,
      * includes unique and non-unique values
      */
-    double m_totalPoints{0.0};
+    uint64_t m_totalPoints{0u};
 };
 
 } // namespace ns3::netsimulyzer
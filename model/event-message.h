@@ -42,10 +42,23 @@
 
 #include <cstdint>
 #include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
 
 namespace ns3::netsimulyzer
 {
 
+/**
+ * Representation of a single point on an XYSeries
+ */
+struct XYPoint
+{
+    double x;
+    double y;
+};
+
 struct CourseChangeEvent
 {
     Time time;
@@ -118,6 +131,178 @@ struct LogMessageEvent
     std::string message;
 };
 
+struct XYSeriesAppendEvent
+{
+    Time time;
+    uint32_t id;
+    double x;
+    double y;
+};
+
+struct XYSeriesAppendArrayEvent
+{
+    Time time;
+    uint32_t id;
+    std::vector<XYPoint> points;
+};
+
+struct XYSeriesClearEvent
+{
+    Time time;
+    uint32_t id;
+};
+
+struct CategorySeriesAppendEvent
+{
+    Time time;
+    uint32_t id;
+    int category;
+    double value;
+};
+
+struct LogicalLinkEvent
+{
+    enum class EventType
+    {
+        Create,
+        Update
+    };
+
+    Time time;
+    EventType type;
+    uint32_t id;
+    std::pair<uint32_t, uint32_t> nodes;
+    bool active;
+    Color3 color;
+    double diameter;
+};
+
+/**
+ * Position & orientation of a Node changing at the same time.
+ * Replaces a `CourseChangeEvent` & `NodeOrientationChangeEvent` pair
+ */
+struct NodePoseEvent
+{
+    Time time;
+    uint32_t nodeId;
+    Vector3D position;
+    Vector3D orientation;
+};
+
+/**
+ * Straight line motion of a Node from `start` to `end`,
+ * replacing the individual positions written during that time.
+ *
+ * The position of the Node at time `t` in [`start`, `end`]
+ * is `position + velocity * (t - start)`, with time in seconds.
+ * Written once the segment ends, so `time` is when
+ * the segment was closed, which may be after `end`
+ */
+struct NodeSegmentEvent
+{
+    Time time;
+    uint32_t nodeId;
+    Time start;
+    Time end;
+    Vector3D position;
+    Vector3D velocity;
+};
+
+/**
+ * The latest position and/or orientation of each Node
+ * which changed during a single frame of `FrameMode`
+ */
+struct NodeFrameEvent
+{
+    struct NodeState
+    {
+        uint32_t id;
+        std::optional<Vector3D> position;
+        std::optional<Vector3D> orientation;
+    };
+
+    Time time;
+    std::vector<NodeState> nodes;
+};
+
+/**
+ * A Node crossing the bounds of an area
+ */
+struct AreaCrossingEvent
+{
+    Time time;
+    uint32_t nodeId;
+    uint32_t areaId;
+    // True if the Node entered the area, false if it exited
+    bool entered;
+};
+
+/**
+ * Snapshot of the state of every Node, Decoration, & Logical Link,
+ * so the application may start playback from this point,
+ * rather than replaying every prior event
+ */
+struct KeyframeEvent
+{
+    struct NodeState
+    {
+        uint32_t id;
+        Vector3D position;
+        Vector3D orientation;
+        std::optional<Color3> baseColor;
+        std::optional<Color3> highlightColor;
+        bool visible;
+        std::string model;
+    };
+
+    struct DecorationState
+    {
+        uint32_t id;
+        Vector3D position;
+        Vector3D orientation;
+    };
+
+    struct LinkState
+    {
+        uint32_t id;
+        std::pair<uint32_t, uint32_t> nodes;
+        bool active;
+        Color3 color;
+        double diameter;
+    };
+
+    Time time;
+    std::vector<NodeState> nodes;
+    std::vector<DecorationState> decorations;
+    std::vector<LinkState> links;
+};
+
+/**
+ * A single event waiting to be written to the output.
+ *
+ * Events are kept in this form until they are written,
+ * since it is far more compact than the JSON representation
+ */
+using EventRecord = std::variant<CourseChangeEvent,
+                                 TransmitEvent,
+                                 NodeOrientationChangeEvent,
+                                 NodeColorChangeEvent,
+                                 NodeVisibilityChangeEvent,
+                                 NodeModelChangeEvent,
+                                 DecorationMoveEvent,
+                                 DecorationOrientationChangeEvent,
+                                 LogMessageEvent,
+                                 XYSeriesAppendEvent,
+                                 XYSeriesAppendArrayEvent,
+                                 XYSeriesClearEvent,
+                                 CategorySeriesAppendEvent,
+                                 LogicalLinkEvent,
+                                 KeyframeEvent,
+                                 NodeSegmentEvent,
+                                 NodePoseEvent,
+                                 AreaCrossingEvent,
+                                 NodeFrameEvent>;
+
 } // namespace ns3::netsimulyzer
 
 #endif /* EVENT_MESSAGE_H */
@@ -0,0 +1,106 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "event-reorder-buffer.h"
+
+#include <algorithm>
+#include <utility>
+#include <variant>
+
+namespace ns3::netsimulyzer
+{
+
+EventReorderBuffer::EventReorderBuffer(int64_t window)
+    : m_window(window)
+{
+}
+
+bool
+EventReorderBuffer::Push(EventRecord&& event)
+{
+    const auto nanoseconds =
+        std::visit([](const auto& e) { return e.time.GetNanoSeconds(); }, event);
+    if (nanoseconds < m_released)
+    {
+        return false;
+    }
+
+    m_latest = std::max(m_latest, nanoseconds);
+    m_heap.push_back({nanoseconds, m_sequence++, std::move(event)});
+    std::push_heap(m_heap.begin(), m_heap.end(), &EventReorderBuffer::Later);
+    return true;
+}
+
+bool
+EventReorderBuffer::PopReady(EventRecord& event)
+{
+    if (m_heap.empty() || m_heap.front().nanoseconds > m_latest - m_window)
+    {
+        return false;
+    }
+
+    return Pop(event);
+}
+
+bool
+EventReorderBuffer::Pop(EventRecord& event)
+{
+    if (m_heap.empty())
+    {
+        return false;
+    }
+
+    std::pop_heap(m_heap.begin(), m_heap.end(), &EventReorderBuffer::Later);
+    m_released = m_heap.back().nanoseconds;
+    event = std::move(m_heap.back().event);
+    m_heap.pop_back();
+    return true;
+}
+
+std::size_t
+EventReorderBuffer::GetSize(void) const
+{
+    return m_heap.size();
+}
+
+bool
+EventReorderBuffer::Later(const Entry& left, const Entry& right)
+{
+    if (left.nanoseconds != right.nanoseconds)
+    {
+        return left.nanoseconds > right.nanoseconds;
+    }
+    return left.sequence > right.sequence;
+}
+
+} // namespace ns3::netsimulyzer
@@ -0,0 +1,152 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#ifndef EVENT_REORDER_BUFFER_H
+#define EVENT_REORDER_BUFFER_H
+
+#include "event-message.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ns3::netsimulyzer
+{
+
+/**
+ * Restores time order to events which arrive at most
+ * a fixed window behind the latest event seen.
+ *
+ * Events are held in a min-heap by time until the latest time seen
+ * is more than the window past them, then released in order.
+ * Events with the same time are released in the order they were pushed.
+ *
+ * An event older than the last one released can no longer be placed in order,
+ * and is rejected by `Push()` as late
+ */
+class EventReorderBuffer
+{
+  public:
+    /**
+     * @param window
+     * How far, in nanoseconds, an event may be behind
+     * the latest event seen, and still be placed in order
+     */
+    explicit EventReorderBuffer(int64_t window);
+
+    /**
+     * Hold `event` until it may be released in order
+     *
+     * @param event
+     * The event to hold. Not moved from if the event is late
+     *
+     * @return
+     * False if `event` is late, and was not added
+     */
+    bool Push(EventRecord&& event);
+
+    /**
+     * Release the earliest held event, if the window has passed it
+     *
+     * @param event
+     * Where to store the released event
+     *
+     * @return
+     * True if an event was released
+     */
+    bool PopReady(EventRecord& event);
+
+    /**
+     * Release the earliest held event, regardless of the window.
+     * Used to empty the buffer once no more events will arrive
+     *
+     * @param event
+     * Where to store the released event
+     *
+     * @return
+     * True if an event was released, false if the buffer is empty
+     */
+    bool Pop(EventRecord& event);
+
+    /**
+     * @return
+     * The number of events being held
+     */
+    std::size_t GetSize(void) const;
+
+  private:
+    /**
+     * A held event, & the values it is ordered by
+     */
+    struct Entry
+    {
+        int64_t nanoseconds;
+        uint64_t sequence;
+        EventRecord event;
+    };
+
+    /**
+     * Ordering for `std::push_heap()` & `std::pop_heap()`,
+     * so the earliest event is at the front of the heap
+     */
+    static bool Later(const Entry& left, const Entry& right);
+
+    /**
+     * How far an event may be behind the latest event seen
+     */
+    int64_t m_window;
+
+    /**
+     * Held events, as a heap ordered by `Later()`
+     */
+    std::vector<Entry> m_heap;
+
+    /**
+     * Number of events pushed so far, to keep events with the same time in order
+     */
+    uint64_t m_sequence{0u};
+
+    /**
+     * Latest time of any event pushed
+     */
+    int64_t m_latest{std::numeric_limits<int64_t>::min()};
+
+    /**
+     * Time of the last event released. Any event before this is late
+     */
+    int64_t m_released{std::numeric_limits<int64_t>::min()};
+};
+
+} // namespace ns3::netsimulyzer
+
+#endif // EVENT_REORDER_BUFFER_H
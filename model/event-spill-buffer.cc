@@ -0,0 +1,452 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "event-spill-buffer.h"
+
+#include "json-event-emitter.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace
+{
+
+/**
+ * @param event
+ * The event to get the time of
+ *
+ * @return
+ * The time of `event`, in nanoseconds
+ */
+int64_t
+GetNanoseconds(const ns3::netsimulyzer::EventRecord& event)
+{
+    return std::visit([](const auto& e) { return e.time.GetNanoSeconds(); }, event);
+}
+
+/**
+ * Write the bytes of `value` to `file`, in the native byte order.
+ * Runs are only read back by the same process, so this need not be portable
+ *
+ * @param file
+ * The run to write to
+ *
+ * @param value
+ * The value to write
+ */
+template <typename T>
+void
+WriteValue(std::ofstream& file, T value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * Read a value written by `WriteValue()`
+ *
+ * @param file
+ * The run to read from
+ *
+ * @param value
+ * Where to store the value
+ *
+ * @return
+ * True if the whole value was read
+ */
+template <typename T>
+bool
+ReadValue(std::ifstream& file, T& value)
+{
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+/**
+ * Reads the events of a single run, one at a time
+ */
+struct RunReader
+{
+    explicit RunReader(const std::string& path)
+        : file(path, std::ios::in | std::ios::binary)
+    {
+        NS_ABORT_MSG_IF(!file, "Failed to open event run: " << path);
+    }
+
+    /**
+     * Read the next event from the run
+     *
+     * @return
+     * False if the run has no events left
+     */
+    bool Next(void)
+    {
+        if (!ReadValue(file, nanoseconds))
+        {
+            return false;
+        }
+
+        uint8_t keyframeFlag{0u};
+        uint32_t length{0u};
+        NS_ABORT_MSG_IF(!ReadValue(file, keyframeFlag) || !ReadValue(file, length),
+                        "Truncated event run");
+        keyframe = keyframeFlag != 0u;
+
+        json.resize(length);
+        NS_ABORT_MSG_IF(!file.read(json.data(), length), "Truncated event run");
+        return true;
+    }
+
+    std::ifstream file;
+    int64_t nanoseconds{0};
+    bool keyframe{false};
+    std::string json;
+};
+
+/**
+ * Write a single event to a run, in the format read by `RunReader`
+ *
+ * @param file
+ * The run to write to
+ *
+ * @param nanoseconds
+ * The time of the event
+ *
+ * @param keyframe
+ * If the event is a `KeyframeEvent`
+ *
+ * @param json
+ * The event as JSON
+ */
+void
+WriteEvent(std::ofstream& file, int64_t nanoseconds, bool keyframe, std::string_view json)
+{
+    WriteValue(file, nanoseconds);
+    WriteValue(file, static_cast<uint8_t>(keyframe));
+    WriteValue(file, static_cast<uint32_t>(json.size()));
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+}
+
+/**
+ * Pass every event from `readers`, in time order, to `callback`
+ *
+ * @param readers
+ * The runs to merge, in the order they were written.
+ * Ties go to the earlier run to keep the order events were added
+ *
+ * @param callback
+ * Called once per event, with the reader holding it
+ */
+template <typename Callback>
+void
+MergeReaders(std::vector<RunReader>& readers, Callback&& callback)
+{
+    auto later = [&readers](std::size_t left, std::size_t right) {
+        if (readers[left].nanoseconds != readers[right].nanoseconds)
+        {
+            return readers[left].nanoseconds > readers[right].nanoseconds;
+        }
+        return left > right;
+    };
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(later)> heap{later};
+
+    for (auto i = 0u; i < readers.size(); i++)
+    {
+        if (readers[i].Next())
+        {
+            heap.push(i);
+        }
+    }
+
+    while (!heap.empty())
+    {
+        const auto next = heap.top();
+        heap.pop();
+
+        auto& reader = readers[next];
+        callback(reader);
+
+        if (reader.Next())
+        {
+            heap.push(next);
+        }
+    }
+}
+
+} // namespace
+
+namespace ns3::netsimulyzer
+{
+
+NS_LOG_COMPONENT_DEFINE("EventSpillBuffer");
+
+EventSpillBuffer::EventSpillBuffer(std::string runPrefix, std::size_t memoryLimit)
+    : m_runPrefix(std::move(runPrefix)),
+      m_memoryLimit(memoryLimit)
+{
+}
+
+EventSpillBuffer::~EventSpillBuffer()
+{
+    RemoveRuns();
+}
+
+void
+EventSpillBuffer::Add(EventRecord&& event)
+{
+    m_memoryUsed += EstimateSize(event);
+    m_events.emplace_back(std::move(event));
+
+    if (m_memoryUsed > m_memoryLimit)
+    {
+        Spill();
+    }
+}
+
+std::size_t
+EventSpillBuffer::GetRunCount(void) const
+{
+    return m_runs.size();
+}
+
+void
+EventSpillBuffer::Merge(const std::function<void(const SortedEvent&)>& callback)
+{
+    NS_LOG_FUNCTION(this);
+    JsonEventEmitter emitter{m_scratch};
+
+    // Never went over budget, so just sort what we have
+    if (m_runs.empty())
+    {
+        for (const auto i : SortedOrder())
+        {
+            const auto& event = m_events[i];
+            m_scratch.clear();
+            emitter.Write(event);
+            callback({GetNanoseconds(event),
+                      std::holds_alternative<KeyframeEvent>(event),
+                      m_scratch});
+        }
+
+        m_events.clear();
+        m_memoryUsed = 0u;
+        return;
+    }
+
+    // Otherwise, make the remaining events the last run,
+    // so every event is merged the same way
+    if (!m_events.empty())
+    {
+        Spill();
+    }
+
+    // Each run is held open while merging, so merge in groups
+    // until few enough remain to stay under the open file limit
+    while (m_runs.size() > MaxMergeFanIn)
+    {
+        CompactRuns();
+    }
+
+    std::vector<RunReader> readers;
+    readers.reserve(m_runs.size());
+    for (const auto& run : m_runs)
+    {
+        readers.emplace_back(run);
+    }
+
+    MergeReaders(readers, [&callback](const RunReader& reader) {
+        callback({reader.nanoseconds, reader.keyframe, reader.json});
+    });
+
+    readers.clear();
+    RemoveRuns();
+}
+
+std::size_t
+EventSpillBuffer::EstimateSize(const EventRecord& event)
+{
+    auto size = sizeof(EventRecord);
+    std::visit(
+        [&size](const auto& e) {
+            using T = std::decay_t<decltype(e)>;
+            if constexpr (std::is_same_v<T, NodeModelChangeEvent>)
+            {
+                size += e.model.capacity();
+            }
+            else if constexpr (std::is_same_v<T, LogMessageEvent>)
+            {
+                size += e.message.capacity();
+            }
+            else if constexpr (std::is_same_v<T, XYSeriesAppendArrayEvent>)
+            {
+                size += e.points.capacity() * sizeof(XYPoint);
+            }
+            else if constexpr (std::is_same_v<T, KeyframeEvent>)
+            {
+                size += e.nodes.capacity() * sizeof(KeyframeEvent::NodeState);
+                for (const auto& node : e.nodes)
+                {
+                    size += node.model.capacity();
+                }
+                size += e.decorations.capacity() * sizeof(KeyframeEvent::DecorationState);
+                size += e.links.capacity() * sizeof(KeyframeEvent::LinkState);
+            }
+            else if constexpr (std::is_same_v<T, NodeFrameEvent>)
+            {
+                size += e.nodes.capacity() * sizeof(NodeFrameEvent::NodeState);
+            }
+        },
+        event);
+
+    return size;
+}
+
+void
+EventSpillBuffer::Spill(void)
+{
+    const auto path = NextRunPath();
+    NS_LOG_FUNCTION(this << path << m_events.size());
+
+    std::ofstream file{path, std::ios::out | std::ios::trunc | std::ios::binary};
+    NS_ABORT_MSG_IF(!file, "Failed to create event run: " << path);
+    m_runs.emplace_back(path);
+
+    JsonEventEmitter emitter{m_scratch};
+    for (const auto i : SortedOrder())
+    {
+        const auto& event = m_events[i];
+        m_scratch.clear();
+        emitter.Write(event);
+
+        WriteEvent(file,
+                   GetNanoseconds(event),
+                   std::holds_alternative<KeyframeEvent>(event),
+                   m_scratch);
+    }
+
+    file.close();
+    NS_ABORT_MSG_IF(!file, "Failed to write event run: " << path);
+
+    m_events.clear();
+    m_memoryUsed = 0u;
+}
+
+void
+EventSpillBuffer::CompactRuns(void)
+{
+    NS_LOG_FUNCTION(this << m_runs.size());
+    std::vector<std::string> compacted;
+
+    for (std::size_t first = 0u; first < m_runs.size(); first += MaxMergeFanIn)
+    {
+        const auto last = std::min(first + MaxMergeFanIn, m_runs.size());
+
+        // Nothing to merge a lone run with
+        if (last - first == 1u)
+        {
+            compacted.emplace_back(m_runs[first]);
+            continue;
+        }
+
+        const auto path = NextRunPath();
+        std::ofstream file{path, std::ios::out | std::ios::trunc | std::ios::binary};
+        NS_ABORT_MSG_IF(!file, "Failed to create event run: " << path);
+
+        {
+            std::vector<RunReader> readers;
+            readers.reserve(last - first);
+            for (auto i = first; i < last; i++)
+            {
+                readers.emplace_back(m_runs[i]);
+            }
+
+            MergeReaders(readers, [&file](const RunReader& reader) {
+                WriteEvent(file, reader.nanoseconds, reader.keyframe, reader.json);
+            });
+        }
+
+        file.close();
+        NS_ABORT_MSG_IF(!file, "Failed to write event run: " << path);
+
+        for (auto i = first; i < last; i++)
+        {
+            std::remove(m_runs[i].c_str());
+        }
+        compacted.emplace_back(path);
+    }
+
+    // Groups are consecutive, so the compacted runs
+    // are still in the order their events were added
+    m_runs = std::move(compacted);
+}
+
+std::string
+EventSpillBuffer::NextRunPath(void)
+{
+    return m_runPrefix + std::to_string(m_nextRun++);
+}
+
+std::vector<std::size_t>
+EventSpillBuffer::SortedOrder(void) const
+{
+    std::vector<std::size_t> order(m_events.size());
+    for (auto i = 0u; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+
+    // Stable, so events with the same time keep the order they were added
+    std::stable_sort(order.begin(), order.end(), [this](std::size_t left, std::size_t right) {
+        return GetNanoseconds(m_events[left]) < GetNanoseconds(m_events[right]);
+    });
+
+    return order;
+}
+
+void
+EventSpillBuffer::RemoveRuns(void)
+{
+    for (const auto& run : m_runs)
+    {
+        std::remove(run.c_str());
+    }
+    m_runs.clear();
+}
+
+} // namespace ns3::netsimulyzer
@@ -0,0 +1,207 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#ifndef EVENT_SPILL_BUFFER_H
+#define EVENT_SPILL_BUFFER_H
+
+#include "event-message.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ns3::netsimulyzer
+{
+
+/**
+ * Holds events in memory up to a fixed budget. Once over the budget,
+ * the held events are sorted by time and written to a temporary file (a run).
+ *
+ * `Merge()` then combines the runs back into a single time ordered sequence.
+ * Events with the same time are kept in the order they were added
+ */
+class EventSpillBuffer
+{
+  public:
+    /**
+     * The most runs read at once by `Merge()`.
+     * Past this, runs are first merged in groups of this size
+     */
+    static constexpr std::size_t MaxMergeFanIn{64u};
+
+    /**
+     * A single event, in time order, as passed to the `Merge()` callback
+     */
+    struct SortedEvent
+    {
+        /**
+         * Time of the event
+         */
+        int64_t nanoseconds;
+
+        /**
+         * If the event is a `KeyframeEvent`
+         */
+        bool keyframe;
+
+        /**
+         * The event as JSON. Only valid during the callback
+         */
+        std::string_view json;
+    };
+
+    /**
+     * Create an empty buffer. No files are created until the budget is exceeded
+     *
+     * @param runPrefix
+     * Path prefix for run files. Each run is written to `runPrefix` followed by a number
+     *
+     * @param memoryLimit
+     * Approximate number of bytes of events to hold before writing a run
+     */
+    EventSpillBuffer(std::string runPrefix, std::size_t memoryLimit);
+
+    EventSpillBuffer(const EventSpillBuffer&) = delete;
+    EventSpillBuffer& operator=(const EventSpillBuffer&) = delete;
+
+    /**
+     * Removes any run files left behind
+     */
+    ~EventSpillBuffer();
+
+    /**
+     * Hold `event`, writing a run if the buffer is over budget
+     *
+     * @param event
+     * The event to add
+     */
+    void Add(EventRecord&& event);
+
+    /**
+     * @return
+     * The number of runs written to disk so far
+     */
+    std::size_t GetRunCount(void) const;
+
+    /**
+     * Pass every event added, in time order, to `callback`,
+     * then empty the buffer & remove the run files
+     *
+     * @param callback
+     * Called once per event
+     */
+    void Merge(const std::function<void(const SortedEvent&)>& callback);
+
+    /**
+     * Estimate the memory used to hold `event`
+     *
+     * @param event
+     * The event to estimate
+     *
+     * @return
+     * The approximate number of bytes used by `event`,
+     * including memory it has allocated
+     */
+    static std::size_t EstimateSize(const EventRecord& event);
+
+  private:
+    /**
+     * Sort the held events by time, then write them to a new run
+     */
+    void Spill(void);
+
+    /**
+     * Merge each group of `MaxMergeFanIn` runs into a single run
+     */
+    void CompactRuns(void);
+
+    /**
+     * @return
+     * A path for a new run, not used by any other run
+     */
+    std::string NextRunPath(void);
+
+    /**
+     * @return
+     * The positions of the held events in `m_events`, sorted by time
+     */
+    std::vector<std::size_t> SortedOrder(void) const;
+
+    /**
+     * Remove every run file
+     */
+    void RemoveRuns(void);
+
+    /**
+     * Path prefix for run files
+     */
+    std::string m_runPrefix;
+
+    /**
+     * Approximate number of bytes to hold before writing a run
+     */
+    std::size_t m_memoryLimit;
+
+    /**
+     * Approximate number of bytes used by `m_events`
+     */
+    std::size_t m_memoryUsed{0u};
+
+    /**
+     * Events not yet written to a run, in the order they were added
+     */
+    std::deque<EventRecord> m_events;
+
+    /**
+     * Paths of each run written, in the order they were written
+     */
+    std::vector<std::string> m_runs;
+
+    /**
+     * Number used in the path of the next run
+     */
+    std::size_t m_nextRun{0u};
+
+    /**
+     * Reused buffer for serializing events
+     */
+    std::string m_scratch;
+};
+
+} // namespace ns3::netsimulyzer
+
+#endif // EVENT_SPILL_BUFFER_H
@@ -0,0 +1,128 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "fenwick-tree.h"
+
+namespace ns3::netsimulyzer
+{
+
+void
+FenwickTree::Add(std::size_t index, uint64_t count)
+{
+    for (; index < m_tree.size(); index |= index + 1u)
+    {
+        m_tree[index] += count;
+    }
+}
+
+uint64_t
+FenwickTree::Get(std::size_t index) const
+{
+    // The sum of `index`'s range, less the ranges of its children
+    auto count = m_tree[index];
+    const auto first = index & (index + 1u);
+    for (auto child = index; child > first; child &= child - 1u)
+    {
+        count -= m_tree[child - 1u];
+    }
+    return count;
+}
+
+uint64_t
+FenwickTree::GetPrefixSum(std::size_t index) const
+{
+    uint64_t sum = 0u;
+    for (auto i = index + 1u; i > 0u; i &= i - 1u)
+    {
+        sum += m_tree[i - 1u];
+    }
+    return sum;
+}
+
+std::size_t
+FenwickTree::GetSize(void) const
+{
+    return m_tree.size();
+}
+
+void
+FenwickTree::Prepend(std::size_t count)
+{
+    ToCounts();
+    m_tree.insert(m_tree.begin(), count, 0u);
+    FromCounts();
+}
+
+void
+FenwickTree::Extend(std::size_t count)
+{
+    ToCounts();
+    m_tree.resize(m_tree.size() + count, 0u);
+    FromCounts();
+}
+
+void
+FenwickTree::Clear(void)
+{
+    m_tree.clear();
+}
+
+void
+FenwickTree::ToCounts(void)
+{
+    // Undo `FromCounts()`, last index first
+    for (auto i = m_tree.size(); i > 0u; i--)
+    {
+        const auto index = i - 1u;
+        const auto parent = index | (index + 1u);
+        if (parent < m_tree.size())
+        {
+            m_tree[parent] -= m_tree[index];
+        }
+    }
+}
+
+void
+FenwickTree::FromCounts(void)
+{
+    for (std::size_t index = 0u; index < m_tree.size(); index++)
+    {
+        const auto parent = index | (index + 1u);
+        if (parent < m_tree.size())
+        {
+            m_tree[parent] += m_tree[index];
+        }
+    }
+}
+
+} // namespace ns3::netsimulyzer
@@ -0,0 +1,130 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#ifndef FENWICK_TREE_H
+#define FENWICK_TREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ns3::netsimulyzer
+{
+
+/**
+ * A Fenwick (binary indexed) tree of counts, by index.
+ *
+ * Adding to the count of an index & summing the counts
+ * of every index up to some index are both O(log n)
+ */
+class FenwickTree
+{
+  public:
+    /**
+     * Add to the count at `index`
+     *
+     * @param index
+     * The index to add to. Must be less than `GetSize()`
+     *
+     * @param count
+     * The amount to add
+     */
+    void Add(std::size_t index, uint64_t count);
+
+    /**
+     * @param index
+     * The index of the count to get. Must be less than `GetSize()`
+     *
+     * @return
+     * The count at `index`
+     */
+    uint64_t Get(std::size_t index) const;
+
+    /**
+     * @param index
+     * The last index to sum. Must be less than `GetSize()`
+     *
+     * @return
+     * The sum of the counts from index 0 to `index`, inclusive
+     */
+    uint64_t GetPrefixSum(std::size_t index) const;
+
+    /**
+     * @return
+     * The number of indices in the tree
+     */
+    std::size_t GetSize(void) const;
+
+    /**
+     * Insert `count` indices with no count before index 0,
+     * shifting every existing count up by `count`. O(n)
+     *
+     * @param count
+     * The number of indices to insert
+     */
+    void Prepend(std::size_t count);
+
+    /**
+     * Add `count` indices with no count after the last index. O(n)
+     *
+     * @param count
+     * The number of indices to add
+     */
+    void Extend(std::size_t count);
+
+    /**
+     * Remove every index
+     */
+    void Clear(void);
+
+  private:
+    /**
+     * Replace each partial sum with the count of its index, in place. O(n)
+     */
+    void ToCounts(void);
+
+    /**
+     * Replace each count with the partial sum of its index, in place. O(n)
+     */
+    void FromCounts(void);
+
+    /**
+     * The partial sums. Index `i` holds the sum of the counts
+     * from `(i & (i + 1))` to `i`, inclusive
+     */
+    std::vector<uint64_t> m_tree;
+};
+
+} // namespace ns3::netsimulyzer
+
+#endif
@@ -0,0 +1,735 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "json-event-emitter.h"
+
+#include "ns3/abort.h"
+#include <ns3/json.hpp>
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <variant>
+
+namespace
+{
+
+/**
+ * Large enough for any number written by the emitter,
+ * including the sign, decimal point, & exponent
+ */
+constexpr std::size_t NumberBufferSize = 64u;
+
+#ifdef __cpp_lib_to_chars
+/**
+ * Appends the exponent of a number in scientific notation
+ * to `buffer`, with its sign, & at least two digits.
+ * Matches `nlohmann::json`
+ *
+ * @param buffer
+ * Where to write the exponent
+ *
+ * @param exponent
+ * The exponent to write
+ *
+ * @return
+ * One past the last character written
+ */
+char*
+AppendExponent(char* buffer, int exponent)
+{
+    if (exponent < 0)
+    {
+        exponent = -exponent;
+        *buffer++ = '-';
+    }
+    else
+    {
+        *buffer++ = '+';
+    }
+
+    if (exponent < 10)
+    {
+        *buffer++ = '0';
+    }
+    return std::to_chars(buffer, buffer + 3, exponent).ptr;
+}
+
+/**
+ * Formats the `length` significant digits at the start of `buffer`,
+ * representing `digits * 10^decimalExponent`, the same way `nlohmann::json` does.
+ *
+ * Fixed notation is used when the decimal point falls within (-4, 15],
+ * and integral values always end with ".0"
+ *
+ * @param buffer
+ * Contains the significant digits. Must have room for the formatted number
+ *
+ * @param length
+ * The number of digits in `buffer`
+ *
+ * @param decimalExponent
+ * The power of ten to multiply the digits by
+ *
+ * @return
+ * One past the last character written
+ */
+char*
+FormatDigits(char* buffer, int length, int decimalExponent)
+{
+    constexpr int minExponent = -4;
+    constexpr int maxExponent = std::numeric_limits<double>::digits10;
+
+    // Position of the decimal point relative to the start of the digits
+    const int point = length + decimalExponent;
+
+    if (length <= point && point <= maxExponent)
+    {
+        // digits[000].0
+        std::memset(buffer + length, '0', static_cast<std::size_t>(point - length));
+        buffer[point] = '.';
+        buffer[point + 1] = '0';
+        return buffer + point + 2;
+    }
+
+    if (0 < point && point <= maxExponent)
+    {
+        // dig.its
+        std::memmove(buffer + point + 1, buffer + point, static_cast<std::size_t>(length - point));
+        buffer[point] = '.';
+        return buffer + length + 1;
+    }
+
+    if (minExponent < point && point <= 0)
+    {
+        // 0.[000]digits
+        std::memmove(buffer + 2 - point, buffer, static_cast<std::size_t>(length));
+        buffer[0] = '0';
+        buffer[1] = '.';
+        std::memset(buffer + 2, '0', static_cast<std::size_t>(-point));
+        return buffer + 2 - point + length;
+    }
+
+    if (length == 1)
+    {
+        // de+XX
+        buffer += 1;
+    }
+    else
+    {
+        // d.igitse+XX
+        std::memmove(buffer + 2, buffer + 1, static_cast<std::size_t>(length - 1));
+        buffer[1] = '.';
+        buffer += 1 + length;
+    }
+
+    *buffer++ = 'e';
+    return AppendExponent(buffer, point - 1);
+}
+#endif
+
+} // namespace
+
+namespace ns3::netsimulyzer
+{
+
+JsonEventEmitter::JsonEventEmitter(std::string& buffer)
+    : m_buffer(buffer)
+{
+}
+
+void
+JsonEventEmitter::Write(const EventRecord& event)
+{
+    std::visit([this](const auto& e) { Write(e); }, event);
+}
+
+void
+JsonEventEmitter::Write(const CourseChangeEvent& event)
+{
+    Raw(R"({"id":)");
+    Unsigned(event.nodeId);
+    Raw(R"(,"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"type":"node-position","x":)");
+    Double(event.position.x);
+    Raw(R"(,"y":)");
+    Double(event.position.y);
+    Raw(R"(,"z":)");
+    Double(event.position.z);
+    Raw("}");
+}
+
+void
+JsonEventEmitter::Write(const TransmitEvent& event)
+{
+    Raw(R"({"color":)");
+    Color(event.color);
+    Raw(R"(,"duration":)");
+    Integer(event.duration.GetNanoSeconds());
+    Raw(R"(,"id":)");
+    Unsigned(event.nodeId);
+    Raw(R"(,"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"target-size":)");
+    Double(event.targetSize);
+    Raw(R"(,"type":"node-transmit"})");
+}
+
+void
+JsonEventEmitter::Write(const NodeOrientationChangeEvent& event)
+{
+    Raw(R"({"id":)");
+    Unsigned(event.nodeId);
+    Raw(R"(,"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"type":"node-orientation","x":)");
+    Double(event.orientation.x);
+    Raw(R"(,"y":)");
+    Double(event.orientation.y);
+    Raw(R"(,"z":)");
+    Double(event.orientation.z);
+    Raw("}");
+}
+
+void
+JsonEventEmitter::Write(const NodeColorChangeEvent& event)
+{
+    Raw("{");
+    if (event.color.has_value())
+    {
+        Raw(R"("color":)");
+        Color(event.color.value());
+        Raw(",");
+    }
+
+    switch (event.type)
+    {
+    case NodeColorChangeEvent::ColorType::Base:
+        Raw(R"("color-type":"base")");
+        break;
+    case NodeColorChangeEvent::ColorType::Highlight:
+        Raw(R"("color-type":"highlight")");
+        break;
+    default:
+        NS_ABORT_MSG("Unhandled ColorType passed to JsonEventEmitter::Write ()");
+        break;
+    }
+
+    Raw(R"(,"id":)");
+    Unsigned(event.id);
+    Raw(R"(,"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"type":"node-color"})");
+}
+
+void
+JsonEventEmitter::Write(const NodeVisibilityChangeEvent& event)
+{
+    Raw(R"({"id":)");
+    Unsigned(event.id);
+    Raw(R"(,"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"type":"node-change","visibility":)");
+    Boolean(event.visible);
+    Raw("}");
+}
+
+void
+JsonEventEmitter::Write(const NodeModelChangeEvent& event)
+{
+    Raw(R"({"id":)");
+    Unsigned(event.id);
+    Raw(R"(,"model":)");
+    String(event.model);
+    Raw(R"(,"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"type":"node-model-change"})");
+}
+
+void
+JsonEventEmitter::Write(const DecorationMoveEvent& event)
+{
+    Raw(R"({"id":)");
+    Unsigned(event.id);
+    Raw(R"(,"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"type":"decoration-position","x":)");
+    Double(event.position.x);
+    Raw(R"(,"y":)");
+    Double(event.position.y);
+    Raw(R"(,"z":)");
+    Double(event.position.z);
+    Raw("}");
+}
+
+void
+JsonEventEmitter::Write(const DecorationOrientationChangeEvent& event)
+{
+    Raw(R"({"id":)");
+    Unsigned(event.id);
+    Raw(R"(,"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"type":"decoration-orientation","x":)");
+    Double(event.orientation.x);
+    Raw(R"(,"y":)");
+    Double(event.orientation.y);
+    Raw(R"(,"z":)");
+    Double(event.orientation.z);
+    Raw("}");
+}
+
+void
+JsonEventEmitter::Write(const LogMessageEvent& event)
+{
+    Raw(R"({"data":)");
+    String(event.message);
+    Raw(R"(,"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"stream-id":)");
+    Unsigned(event.id);
+    Raw(R"(,"type":"stream-append"})");
+}
+
+void
+JsonEventEmitter::Write(const XYSeriesAppendEvent& event)
+{
+    Raw(R"({"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"series-id":)");
+    Unsigned(event.id);
+    Raw(R"(,"type":"xy-series-append","x":)");
+    Double(event.x);
+    Raw(R"(,"y":)");
+    Double(event.y);
+    Raw("}");
+}
+
+void
+JsonEventEmitter::Write(const XYSeriesAppendArrayEvent& event)
+{
+    Raw(R"({"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"points":[)");
+
+    auto first = true;
+    for (const auto& point : event.points)
+    {
+        Raw(first ? R"({"x":)" : R"(,{"x":)");
+        first = false;
+
+        Double(point.x);
+        Raw(R"(,"y":)");
+        Double(point.y);
+        Raw("}");
+    }
+
+    Raw(R"(],"series-id":)");
+    Unsigned(event.id);
+    Raw(R"(,"type":"xy-series-append-array"})");
+}
+
+void
+JsonEventEmitter::Write(const XYSeriesClearEvent& event)
+{
+    Raw(R"({"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"series-id":)");
+    Unsigned(event.id);
+    Raw(R"(,"type":"xy-series-clear"})");
+}
+
+void
+JsonEventEmitter::Write(const CategorySeriesAppendEvent& event)
+{
+    Raw(R"({"category":)");
+    Integer(event.category);
+    Raw(R"(,"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"series-id":)");
+    Unsigned(event.id);
+    Raw(R"(,"type":"category-series-append","value":)");
+    Double(event.value);
+    Raw("}");
+}
+
+void
+JsonEventEmitter::Write(const LogicalLinkEvent& event)
+{
+    Raw(R"({"active":)");
+    Boolean(event.active);
+    Raw(R"(,"color":)");
+    Color(event.color);
+    Raw(R"(,"diameter":)");
+    Double(event.diameter);
+    Raw(R"(,"link-id":)");
+    Unsigned(event.id);
+    Raw(R"(,"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"nodes":[)");
+    Unsigned(event.nodes.first);
+    Raw(",");
+    Unsigned(event.nodes.second);
+
+    switch (event.type)
+    {
+    case LogicalLinkEvent::EventType::Create:
+        Raw(R"(],"type":"logical-link-create"})");
+        break;
+    case LogicalLinkEvent::EventType::Update:
+        Raw(R"(],"type":"logical-link-update"})");
+        break;
+    }
+}
+
+void
+JsonEventEmitter::Write(const KeyframeEvent& event)
+{
+    Raw(R"({"decorations":[)");
+    auto first = true;
+    for (const auto& decoration : event.decorations)
+    {
+        Raw(first ? R"({"id":)" : R"(,{"id":)");
+        first = false;
+
+        Unsigned(decoration.id);
+        Raw(R"(,"orientation":)");
+        Coordinates(decoration.orientation);
+        Raw(R"(,"position":)");
+        Coordinates(decoration.position);
+        Raw("}");
+    }
+
+    Raw(R"(],"links":[)");
+    first = true;
+    for (const auto& link : event.links)
+    {
+        Raw(first ? R"({"active":)" : R"(,{"active":)");
+        first = false;
+
+        Boolean(link.active);
+        Raw(R"(,"color":)");
+        Color(link.color);
+        Raw(R"(,"diameter":)");
+        Double(link.diameter);
+        Raw(R"(,"id":)");
+        Unsigned(link.id);
+        Raw(R"(,"nodes":[)");
+        Unsigned(link.nodes.first);
+        Raw(",");
+        Unsigned(link.nodes.second);
+        Raw("]}");
+    }
+
+    Raw(R"(],"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+
+    Raw(R"(,"nodes":[)");
+    first = true;
+    for (const auto& node : event.nodes)
+    {
+        Raw(first ? "{" : ",{");
+        first = false;
+
+        if (node.baseColor.has_value())
+        {
+            Raw(R"("base-color":)");
+            Color(node.baseColor.value());
+            Raw(",");
+        }
+        if (node.highlightColor.has_value())
+        {
+            Raw(R"("highlight-color":)");
+            Color(node.highlightColor.value());
+            Raw(",");
+        }
+
+        Raw(R"("id":)");
+        Unsigned(node.id);
+        Raw(R"(,"model":)");
+        String(node.model);
+        Raw(R"(,"orientation":)");
+        Coordinates(node.orientation);
+        Raw(R"(,"position":)");
+        Coordinates(node.position);
+        Raw(R"(,"visible":)");
+        Boolean(node.visible);
+        Raw("}");
+    }
+
+    Raw(R"(],"type":"keyframe"})");
+}
+
+void
+JsonEventEmitter::Write(const NodeSegmentEvent& event)
+{
+    Raw(R"({"end-nanoseconds":)");
+    Integer(event.end.GetNanoSeconds());
+    Raw(R"(,"id":)");
+    Unsigned(event.nodeId);
+    Raw(R"(,"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"position":)");
+    Coordinates(event.position);
+    Raw(R"(,"start-nanoseconds":)");
+    Integer(event.start.GetNanoSeconds());
+    Raw(R"(,"type":"node-segment","velocity":)");
+    Coordinates(event.velocity);
+    Raw("}");
+}
+
+void
+JsonEventEmitter::Write(const NodePoseEvent& event)
+{
+    Raw(R"({"id":)");
+    Unsigned(event.nodeId);
+    Raw(R"(,"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"orientation":)");
+    Coordinates(event.orientation);
+    Raw(R"(,"position":)");
+    Coordinates(event.position);
+    Raw(R"(,"type":"node-pose"})");
+}
+
+void
+JsonEventEmitter::Write(const AreaCrossingEvent& event)
+{
+    Raw(R"({"area-id":)");
+    Unsigned(event.areaId);
+    Raw(R"(,"id":)");
+    Unsigned(event.nodeId);
+    Raw(R"(,"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(event.entered ? R"(,"type":"area-enter"})" : R"(,"type":"area-exit"})");
+}
+
+void
+JsonEventEmitter::Write(const NodeFrameEvent& event)
+{
+    Raw(R"({"nanoseconds":)");
+    Integer(event.time.GetNanoSeconds());
+    Raw(R"(,"nodes":[)");
+
+    auto first = true;
+    for (const auto& node : event.nodes)
+    {
+        Raw(first ? R"({"id":)" : R"(,{"id":)");
+        first = false;
+
+        Unsigned(node.id);
+        if (node.orientation.has_value())
+        {
+            Raw(R"(,"orientation":)");
+            Coordinates(node.orientation.value());
+        }
+        if (node.position.has_value())
+        {
+            Raw(R"(,"position":)");
+            Coordinates(node.position.value());
+        }
+        Raw("}");
+    }
+
+    Raw(R"(],"type":"node-frame"})");
+}
+
+void
+JsonEventEmitter::Raw(std::string_view text)
+{
+    m_buffer.append(text.data(), text.size());
+}
+
+void
+JsonEventEmitter::Integer(int64_t value)
+{
+    char buffer[NumberBufferSize];
+    const auto end = std::to_chars(buffer, buffer + NumberBufferSize, value).ptr;
+    m_buffer.append(buffer, end);
+}
+
+void
+JsonEventEmitter::Unsigned(uint64_t value)
+{
+    char buffer[NumberBufferSize];
+    const auto end = std::to_chars(buffer, buffer + NumberBufferSize, value).ptr;
+    m_buffer.append(buffer, end);
+}
+
+void
+JsonEventEmitter::Double(double value)
+{
+    if (!std::isfinite(value))
+    {
+        Raw("null");
+        return;
+    }
+
+    char buffer[NumberBufferSize];
+#ifdef __cpp_lib_to_chars
+    auto out = buffer;
+    if (std::signbit(value))
+    {
+        value = -value;
+        *out++ = '-';
+    }
+
+    if (value == 0.0)
+    {
+        // Keep the sign for -0.0
+        m_buffer.append(buffer, out);
+        Raw("0.0");
+        return;
+    }
+
+    // Shortest round-trip digits, as `d.ddde+XX`
+    char scientific[NumberBufferSize];
+    const auto scientificEnd =
+        std::to_chars(scientific, scientific + NumberBufferSize, value, std::chars_format::scientific)
+            .ptr;
+
+    // Split the significant digits from the exponent
+    auto length = 0;
+    auto current = scientific;
+    for (; current != scientificEnd && *current != 'e'; current++)
+    {
+        if (*current != '.')
+        {
+            out[length++] = *current;
+        }
+    }
+
+    auto exponent = 0;
+    // Skip the 'e', and the '+' which `from_chars` does not accept
+    current++;
+    if (*current == '+')
+    {
+        current++;
+    }
+    std::from_chars(current, scientificEnd, exponent);
+
+    const auto end = FormatDigits(out, length, exponent - (length - 1));
+#else
+    // No floating point `std::to_chars`, use the same routine `nlohmann::json` does
+    const auto end = nlohmann::detail::to_chars(buffer, buffer + NumberBufferSize, value);
+#endif
+    m_buffer.append(buffer, end);
+}
+
+void
+JsonEventEmitter::Boolean(bool value)
+{
+    Raw(value ? "true" : "false");
+}
+
+void
+JsonEventEmitter::String(std::string_view value)
+{
+    constexpr std::string_view hexDigits{"0123456789abcdef"};
+
+    m_buffer.push_back('"');
+
+    // Copy runs of characters which don't need escaping all at once
+    auto runStart = value.begin();
+    for (auto it = value.begin(); it != value.end(); it++)
+    {
+        const auto c = static_cast<unsigned char>(*it);
+        if (c >= 0x20u && c != '"' && c != '\\')
+        {
+            continue;
+        }
+
+        m_buffer.append(runStart, it);
+        runStart = it + 1;
+
+        switch (c)
+        {
+        case '"':
+            Raw(R"(\")");
+            break;
+        case '\\':
+            Raw(R"(\\)");
+            break;
+        case '\b':
+            Raw(R"(\b)");
+            break;
+        case '\t':
+            Raw(R"(\t)");
+            break;
+        case '\n':
+            Raw(R"(\n)");
+            break;
+        case '\f':
+            Raw(R"(\f)");
+            break;
+        case '\r':
+            Raw(R"(\r)");
+            break;
+        default:
+            Raw(R"(\u00)");
+            m_buffer.push_back(hexDigits[c >> 4u]);
+            m_buffer.push_back(hexDigits[c & 0xFu]);
+            break;
+        }
+    }
+    m_buffer.append(runStart, value.end());
+
+    m_buffer.push_back('"');
+}
+
+void
+JsonEventEmitter::Color(const Color3& color)
+{
+    Raw(R"({"blue":)");
+    Unsigned(color.blue);
+    Raw(R"(,"green":)");
+    Unsigned(color.green);
+    Raw(R"(,"red":)");
+    Unsigned(color.red);
+    Raw("}");
+}
+
+void
+JsonEventEmitter::Coordinates(const Vector3D& vector)
+{
+    Raw(R"({"x":)");
+    Double(vector.x);
+    Raw(R"(,"y":)");
+    Double(vector.y);
+    Raw(R"(,"z":)");
+    Double(vector.z);
+    Raw("}");
+}
+
+} // namespace ns3::netsimulyzer
@@ -0,0 +1,178 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#ifndef JSON_EVENT_EMITTER_H
+#define JSON_EVENT_EMITTER_H
+
+#include "color.h"
+#include "event-message.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ns3::netsimulyzer
+{
+
+/**
+ * Writes events as JSON directly into a character buffer,
+ * without building an intermediate `nlohmann::json` document.
+ *
+ * Every event type has a fixed schema, so each is written
+ * from precomputed key literals. Keys are written in the same (sorted) order,
+ * and numbers & strings in the same format, as `nlohmann::json::dump()`,
+ * so the output matches what the application already reads.
+ *
+ * Nothing is allocated per event, so long as `buffer`
+ * has enough capacity reserved.
+ */
+class JsonEventEmitter
+{
+  public:
+    /**
+     * Create an emitter which appends to `buffer`
+     *
+     * @param buffer
+     * The buffer to write events to. Must outlive the emitter
+     */
+    explicit JsonEventEmitter(std::string& buffer);
+
+    /**
+     * Append `event` to the buffer as a JSON object
+     *
+     * @param event
+     * The event to write
+     */
+    void Write(const EventRecord& event);
+
+    /**
+     * Append a specific type of event to the buffer.
+     *
+     * @see Write(const EventRecord&)
+     */
+    void Write(const CourseChangeEvent& event);
+    void Write(const TransmitEvent& event);
+    void Write(const NodeOrientationChangeEvent& event);
+    void Write(const NodeColorChangeEvent& event);
+    void Write(const NodeVisibilityChangeEvent& event);
+    void Write(const NodeModelChangeEvent& event);
+    void Write(const DecorationMoveEvent& event);
+    void Write(const DecorationOrientationChangeEvent& event);
+    void Write(const LogMessageEvent& event);
+    void Write(const XYSeriesAppendEvent& event);
+    void Write(const XYSeriesAppendArrayEvent& event);
+    void Write(const XYSeriesClearEvent& event);
+    void Write(const CategorySeriesAppendEvent& event);
+    void Write(const LogicalLinkEvent& event);
+    void Write(const KeyframeEvent& event);
+    void Write(const NodeSegmentEvent& event);
+    void Write(const NodePoseEvent& event);
+    void Write(const AreaCrossingEvent& event);
+    void Write(const NodeFrameEvent& event);
+
+  private:
+    /**
+     * Append `text` to the buffer as-is
+     *
+     * @param text
+     * Already formatted JSON, usually a key literal
+     */
+    void Raw(std::string_view text);
+
+    /**
+     * Append a signed integer to the buffer
+     *
+     * @param value
+     * The value to write
+     */
+    void Integer(int64_t value);
+
+    /**
+     * Append an unsigned integer to the buffer
+     *
+     * @param value
+     * The value to write
+     */
+    void Unsigned(uint64_t value);
+
+    /**
+     * Append a floating point number to the buffer, using the
+     * shortest representation which round-trips.
+     * Non-finite values are written as `null`
+     *
+     * @param value
+     * The value to write
+     */
+    void Double(double value);
+
+    /**
+     * Append `true` or `false` to the buffer
+     *
+     * @param value
+     * The value to write
+     */
+    void Boolean(bool value);
+
+    /**
+     * Append a quoted & escaped string to the buffer
+     *
+     * @param value
+     * The unescaped string to write
+     */
+    void String(std::string_view value);
+
+    /**
+     * Append a color object (`blue`, `green`, & `red` members) to the buffer
+     *
+     * @param color
+     * The color to write
+     */
+    void Color(const Color3& color);
+
+    /**
+     * Append a vector object (`x`, `y`, & `z` members) to the buffer
+     *
+     * @param vector
+     * The vector to write
+     */
+    void Coordinates(const Vector3D& vector);
+
+    /**
+     * The buffer to append to
+     */
+    std::string& m_buffer;
+};
+
+} // namespace ns3::netsimulyzer
+
+#endif // JSON_EVENT_EMITTER_H
@@ -0,0 +1,473 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "mobility-index.h"
+
+#include "node-configuration.h"
+
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+/**
+ * The fewest Nodes to sample on each thread.
+ * Smaller polls are not worth waking the other threads for
+ */
+constexpr std::size_t parallelChunk = 2048u;
+
+} // namespace
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("MobilityIndex");
+
+namespace netsimulyzer
+{
+
+void
+MobilityIndex::Build(const std::vector<Ptr<NodeConfiguration>>& nodes, bool adaptive)
+{
+    NS_LOG_FUNCTION(this << adaptive);
+    Clear();
+    m_adaptive = adaptive;
+
+    for (const auto& config : nodes)
+    {
+        const auto node = config->GetObject<Node>();
+        NS_ABORT_MSG_IF(!node,
+                        "Mobility poll activated on NodeConfiguration with no associated Node");
+
+        const auto mobility = node->GetObject<MobilityModel>();
+        if (!mobility)
+        {
+            NS_LOG_DEBUG("Node [ID: " << node->GetId()
+                                      << "] has no Mobility Model, not polling");
+            continue;
+        }
+
+        BooleanValue usePositionTolerance;
+        config->GetAttribute("UsePositionTolerance", usePositionTolerance);
+
+        DoubleValue positionTolerance;
+        config->GetAttribute("PositionTolerance", positionTolerance);
+
+        const auto& last = config->GetLastPosition();
+
+        m_slots[node->GetId()] = m_ids.size();
+        m_mobility.emplace_back(PeekPointer(mobility));
+        m_configurations.emplace_back(PeekPointer(config));
+        m_ids.emplace_back(node->GetId());
+        m_tolerance.emplace_back(usePositionTolerance.Get() ? positionTolerance.Get() : -1.0);
+
+        // Only exact types, since a subclass may override `DoGetPosition()`
+        const auto& model = mobility->GetInstanceTypeId().GetName();
+        m_parallelSafe.emplace_back(
+            m_pool && std::find(m_parallelModels.begin(), m_parallelModels.end(), model) !=
+                          m_parallelModels.end());
+        m_lastX.emplace_back(last.x);
+        m_lastY.emplace_back(last.y);
+        m_lastZ.emplace_back(last.z);
+    }
+
+    m_currentX.resize(m_ids.size());
+    m_currentY.resize(m_ids.size());
+    m_currentZ.resize(m_ids.size());
+    m_excess.resize(m_ids.size());
+
+    if (m_adaptive)
+    {
+        m_generation.resize(m_ids.size(), 0u);
+        for (std::size_t i = 0u; i < m_ids.size(); i++)
+        {
+            Queue(i, std::numeric_limits<int64_t>::min());
+        }
+    }
+}
+
+void
+MobilityIndex::SetParallelSampling(std::shared_ptr<WorkerPool> pool,
+                                   const std::vector<std::string>& models)
+{
+    NS_LOG_FUNCTION(this);
+    m_pool = std::move(pool);
+    m_parallelModels = models;
+}
+
+void
+MobilityIndex::Clear(void)
+{
+    NS_LOG_FUNCTION(this);
+    m_mobility.clear();
+    m_configurations.clear();
+    m_ids.clear();
+    m_slots.clear();
+    m_tolerance.clear();
+    m_parallelSafe.clear();
+    m_lastX.clear();
+    m_lastY.clear();
+    m_lastZ.clear();
+    m_currentX.clear();
+    m_currentY.clear();
+    m_currentZ.clear();
+    m_excess.clear();
+    m_queue.clear();
+    m_generation.clear();
+    m_batch.clear();
+    m_batchLastX.clear();
+    m_batchLastY.clear();
+    m_batchLastZ.clear();
+    m_batchTolerance.clear();
+}
+
+std::size_t
+MobilityIndex::GetSize(void) const
+{
+    return m_ids.size();
+}
+
+void
+MobilityIndex::SetLastPosition(uint32_t nodeId, const Vector3D& position)
+{
+    const auto slot = m_slots.find(nodeId);
+    if (slot == m_slots.end())
+    {
+        return;
+    }
+
+    m_lastX[slot->second] = position.x;
+    m_lastY[slot->second] = position.y;
+    m_lastZ[slot->second] = position.z;
+}
+
+void
+MobilityIndex::Wake(uint32_t nodeId, int64_t time)
+{
+    const auto slot = m_slots.find(nodeId);
+    if (!m_adaptive || slot == m_slots.end())
+    {
+        return;
+    }
+
+    Queue(slot->second, time);
+}
+
+std::size_t
+MobilityIndex::Poll(int64_t now, int64_t interval, const ChangedCallback& changed)
+{
+    NS_LOG_FUNCTION(this << now << interval);
+    if (m_adaptive)
+    {
+        return PollDue(now, interval, changed);
+    }
+
+    return PollAll(changed);
+}
+
+int64_t
+MobilityIndex::GetNextDue(void)
+{
+    // Drop entries replaced by `Wake()`
+    while (!m_queue.empty() &&
+           m_queue.front().generation != m_generation[m_queue.front().slot])
+    {
+        std::pop_heap(m_queue.begin(), m_queue.end(), &MobilityIndex::Later);
+        m_queue.pop_back();
+    }
+
+    if (m_queue.empty())
+    {
+        return std::numeric_limits<int64_t>::max();
+    }
+
+    return m_queue.front().time;
+}
+
+double
+MobilityIndex::TimeBeyondTolerance(const Vector3D& position,
+                                   const Vector3D& last,
+                                   const Vector3D& velocity,
+                                   double tolerance)
+{
+    if (tolerance < 0.0)
+    {
+        return 0.0;
+    }
+
+    const double distance[]{position.x - last.x, position.y - last.y, position.z - last.z};
+    const double speed[]{velocity.x, velocity.y, velocity.z};
+
+    auto soonest = std::numeric_limits<double>::infinity();
+    for (auto axis = 0; axis < 3; axis++)
+    {
+        if (speed[axis] == 0.0)
+        {
+            continue;
+        }
+
+        // Moving back towards `last` takes longer to leave the tolerance,
+        // so using the distance regardless of direction is never late
+        const auto remaining = std::max(0.0, tolerance - std::abs(distance[axis]));
+        soonest = std::min(soonest, remaining / std::abs(speed[axis]));
+    }
+
+    return soonest;
+}
+
+bool
+MobilityIndex::Later(const DueEntry& left, const DueEntry& right)
+{
+    if (left.time != right.time)
+    {
+        return left.time > right.time;
+    }
+
+    return left.slot > right.slot;
+}
+
+void
+MobilityIndex::Queue(std::size_t slot, int64_t time)
+{
+    m_queue.push_back({time, slot, ++m_generation[slot]});
+    std::push_heap(m_queue.begin(), m_queue.end(), &MobilityIndex::Later);
+}
+
+std::size_t
+MobilityIndex::PollDue(int64_t now, int64_t interval, const ChangedCallback& changed)
+{
+    m_batch.clear();
+    while (GetNextDue() <= now)
+    {
+        m_batch.emplace_back(m_queue.front().slot);
+        std::pop_heap(m_queue.begin(), m_queue.end(), &MobilityIndex::Later);
+        m_queue.pop_back();
+    }
+
+    const auto count = m_batch.size();
+    m_batchLastX.resize(count);
+    m_batchLastY.resize(count);
+    m_batchLastZ.resize(count);
+    m_batchTolerance.resize(count);
+
+    for (std::size_t i = 0u; i < count; i++)
+    {
+        const auto slot = m_batch[i];
+        m_batchLastX[i] = m_lastX[slot];
+        m_batchLastY[i] = m_lastY[slot];
+        m_batchLastZ[i] = m_lastZ[slot];
+        m_batchTolerance[i] = m_tolerance[slot];
+    }
+
+    Sample(m_batch.data(),
+           count,
+           m_batchLastX.data(),
+           m_batchLastY.data(),
+           m_batchLastZ.data(),
+           m_batchTolerance.data());
+
+    std::size_t changedCount = 0u;
+    for (std::size_t i = 0u; i < count; i++)
+    {
+        const auto slot = m_batch[i];
+        const Vector3D position{m_currentX[i], m_currentY[i], m_currentZ[i]};
+
+        // Written so NaN positions are treated as moved
+        if (!(m_excess[i] <= 0.0))
+        {
+            const auto orientation = m_configurations[slot]->ApplyPolledPosition(position);
+            m_lastX[slot] = position.x;
+            m_lastY[slot] = position.y;
+            m_lastZ[slot] = position.z;
+
+            changed(m_ids[slot], position, orientation);
+            changedCount++;
+        }
+
+        const auto seconds = TimeBeyondTolerance(position,
+                                                 {m_lastX[slot], m_lastY[slot], m_lastZ[slot]},
+                                                 m_mobility[slot]->GetVelocity(),
+                                                 m_tolerance[slot]);
+
+        // Stay on the poll interval, so positions are written
+        // at the same times as they would be without prediction.
+        // Rounded down, so rounding error can only add a poll, never skip one
+        const auto intervals = std::max(1.0, std::floor(seconds * 1e9 / interval));
+        if (intervals >= static_cast<double>(std::numeric_limits<int64_t>::max() - now) / interval)
+        {
+            // Not moving. Stays out of the queue until woken
+            continue;
+        }
+
+        Queue(slot, now + static_cast<int64_t>(intervals) * interval);
+    }
+
+    return changedCount;
+}
+
+std::size_t
+MobilityIndex::PollAll(const ChangedCallback& changed)
+{
+    const auto count = m_ids.size();
+    Sample(nullptr, count, m_lastX.data(), m_lastY.data(), m_lastZ.data(), m_tolerance.data());
+
+    std::size_t changedCount = 0u;
+    for (std::size_t i = 0u; i < count; i++)
+    {
+        // Written so NaN positions are treated as moved
+        if (m_excess[i] <= 0.0)
+        {
+            continue;
+        }
+
+        const Vector3D position{m_currentX[i], m_currentY[i], m_currentZ[i]};
+        const auto orientation = m_configurations[i]->ApplyPolledPosition(position);
+        m_lastX[i] = position.x;
+        m_lastY[i] = position.y;
+        m_lastZ[i] = position.z;
+
+        changed(m_ids[i], position, orientation);
+        changedCount++;
+    }
+
+    return changedCount;
+}
+
+void
+MobilityIndex::Sample(const std::size_t* slots,
+                      std::size_t count,
+                      const double* lastX,
+                      const double* lastY,
+                      const double* lastZ,
+                      const double* tolerance)
+{
+    // The models are polymorphic, so sampling can't be vectorized
+    const auto sample = [this, slots](std::size_t i) {
+        const auto position = m_mobility[slots ? slots[i] : i]->GetPosition();
+        m_currentX[i] = position.x;
+        m_currentY[i] = position.y;
+        m_currentZ[i] = position.z;
+    };
+
+    if (!m_pool || m_pool->GetThreadCount() < 2u || count < 2u * parallelChunk)
+    {
+        for (std::size_t i = 0u; i < count; i++)
+        {
+            sample(i);
+        }
+
+        ExcessOverTolerance(lastX,
+                            lastY,
+                            lastZ,
+                            m_currentX.data(),
+                            m_currentY.data(),
+                            m_currentZ.data(),
+                            tolerance,
+                            count,
+                            m_excess.data());
+        return;
+    }
+
+    // Models not known to be safe may fire traces which reach
+    // the Orchestrator, so they must be sampled on this thread
+    for (std::size_t i = 0u; i < count; i++)
+    {
+        if (!m_parallelSafe[slots ? slots[i] : i])
+        {
+            sample(i);
+        }
+    }
+
+    // A few chunks per thread, so a slow chunk doesn't hold up the rest
+    const auto chunks = std::min(count / parallelChunk, m_pool->GetThreadCount() * 4u);
+    const auto chunkSize = (count + chunks - 1u) / chunks;
+
+    m_pool->Run(chunks, [&](std::size_t chunk) {
+        const auto begin = chunk * chunkSize;
+        if (begin >= count)
+        {
+            return;
+        }
+
+        const auto end = std::min(count, begin + chunkSize);
+        for (auto i = begin; i < end; i++)
+        {
+            if (m_parallelSafe[slots ? slots[i] : i])
+            {
+                sample(i);
+            }
+        }
+
+        ExcessOverTolerance(lastX + begin,
+                            lastY + begin,
+                            lastZ + begin,
+                            m_currentX.data() + begin,
+                            m_currentY.data() + begin,
+                            m_currentZ.data() + begin,
+                            tolerance + begin,
+                            end - begin,
+                            m_excess.data() + begin);
+    });
+}
+
+void
+MobilityIndex::ExcessOverTolerance(const double* lastX,
+                                   const double* lastY,
+                                   const double* lastZ,
+                                   const double* currentX,
+                                   const double* currentY,
+                                   const double* currentZ,
+                                   const double* tolerance,
+                                   std::size_t count,
+                                   double* excess)
+{
+    // Kept to arithmetic only on doubles, so the compiler may vectorize it
+    for (std::size_t i = 0u; i < count; i++)
+    {
+        const auto distanceX = std::abs(currentX[i] - lastX[i]);
+        const auto distanceY = std::abs(currentY[i] - lastY[i]);
+        const auto distanceZ = std::abs(currentZ[i] - lastZ[i]);
+
+        excess[i] = std::max(std::max(distanceX, distanceY), distanceZ) - tolerance[i];
+    }
+}
+
+} // namespace netsimulyzer
+} // namespace ns3
@@ -0,0 +1,433 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#ifndef MOBILITY_INDEX_H
+#define MOBILITY_INDEX_H
+
+#include "worker-pool.h"
+
+#include "ns3/mobility-model.h"
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3::netsimulyzer
+{
+
+class NodeConfiguration;
+
+/**
+ * Cache of every polled Node's mobility model & last written position,
+ * so a mobility poll does not need to look up objects
+ * through the aggregation for each Node.
+ *
+ * Positions are stored as separate, contiguous, arrays for each axis,
+ * so the tolerance check over every Node compiles to a vectorized loop
+ *
+ * When adaptive, each Node is only sampled once it could have
+ * moved beyond its tolerance, predicted from its velocity.
+ * Nodes wait in a queue ordered by when they are next due,
+ * so Nodes which are not moving are not sampled at all
+ *
+ * Only Nodes with a mobility model when the index is built are included
+ */
+class MobilityIndex
+{
+  public:
+    /**
+     * Callback for each Node which has moved beyond its tolerance
+     * during a `Poll()`. Called with the Node ID, its new position,
+     * & its new orientation, if the Node turned to face the position
+     */
+    using ChangedCallback =
+        std::function<void(uint32_t, const Vector3D&, const std::optional<Vector3D>&)>;
+
+    /**
+     * Replace the contents of the index with
+     * every Node in `nodes` with a mobility model
+     *
+     * @param nodes
+     * The configured Nodes to index
+     *
+     * @param adaptive
+     * True to only sample Nodes once they are predicted to
+     * have moved beyond their tolerance. Every Node is due at the first poll
+     */
+    void Build(const std::vector<Ptr<NodeConfiguration>>& nodes, bool adaptive = false);
+
+    /**
+     * Sample the positions of Nodes, & check them against their tolerance,
+     * across the threads of `pool`. Only Nodes with a mobility model
+     * whose TypeId is in `models` are sampled on other threads.
+     * The rest are sampled on the calling thread first.
+     * Nodes are still reported to `Poll()`'s callback in index order.
+     *
+     * Must be called before `Build()`
+     *
+     * @param pool
+     * The threads to sample on. Null to sample on the calling thread
+     *
+     * @param models
+     * The names of the TypeIds of mobility models which may be sampled from another thread.
+     * `GetPosition()` must not modify anything shared with another model,
+     * or fire any trace (e.g. 'CourseChange')
+     */
+    void SetParallelSampling(std::shared_ptr<WorkerPool> pool,
+                             const std::vector<std::string>& models);
+
+    /**
+     * Remove every Node from the index
+     */
+    void Clear(void);
+
+    /**
+     * @return
+     * The number of Nodes in the index
+     */
+    std::size_t GetSize(void) const;
+
+    /**
+     * Record a position for a Node written outside of `Poll()`
+     * (e.g. from a course change), so later polls compare against it.
+     * Nodes not in the index are ignored
+     *
+     * @param nodeId
+     * The ID of the Node which was moved
+     *
+     * @param position
+     * The position written for that Node
+     */
+    void SetLastPosition(uint32_t nodeId, const Vector3D& position);
+
+    /**
+     * Mark a Node as due to be sampled at `time`, regardless of its prediction.
+     * Used when a Node's velocity has changed (e.g. from a course change).
+     * Ignored if the index is not adaptive, or the Node is not in the index
+     *
+     * @param nodeId
+     * The ID of the Node to sample
+     *
+     * @param time
+     * When to sample the Node next, in nanoseconds
+     */
+    void Wake(uint32_t nodeId, int64_t time);
+
+    /**
+     * Sample the position of every Node due at `now`, & call `changed`
+     * for each Node which has moved beyond its tolerance.
+     * Changed Nodes have their last position updated.
+     *
+     * If the index is not adaptive, every Node is due at every poll
+     *
+     * @param now
+     * The current time, in nanoseconds
+     *
+     * @param interval
+     * The time between polls, in nanoseconds.
+     * Nodes are next due on a multiple of this from `now`
+     *
+     * @param changed
+     * Called for each Node to write a position for, in index order
+     *
+     * @return
+     * The number of changed Nodes
+     */
+    std::size_t Poll(int64_t now, int64_t interval, const ChangedCallback& changed);
+
+    /**
+     * @return
+     * The time the next Node is due, in nanoseconds, or the maximum value
+     * of `int64_t` if no Node is due. Only meaningful if the index is adaptive
+     */
+    int64_t GetNextDue(void);
+
+    /**
+     * Find the soonest time a Node moving at `velocity` could move beyond `tolerance`
+     * on any axis, relative to `last`.
+     * Assumes the velocity stays constant until then
+     *
+     * @param position
+     * The current position of the Node
+     *
+     * @param last
+     * The last written position of the Node
+     *
+     * @param velocity
+     * The current velocity of the Node
+     *
+     * @param tolerance
+     * The tolerance of the Node. Negative if every position is written
+     *
+     * @return
+     * The time, in seconds, until the Node may be beyond its tolerance.
+     * 0 if it may already be. Infinity if the Node is not moving
+     */
+    static double TimeBeyondTolerance(const Vector3D& position,
+                                      const Vector3D& last,
+                                      const Vector3D& velocity,
+                                      double tolerance);
+
+    /**
+     * Find how far each of `count` Nodes has moved past its tolerance,
+     * on whichever axis it has moved the furthest.
+     * A Node has moved beyond its tolerance when the result is greater than 0.
+     * A negative tolerance marks every Node as moved
+     *
+     * @param lastX
+     * The last position on the x axis of each Node
+     *
+     * @param lastY
+     * The last position on the y axis of each Node
+     *
+     * @param lastZ
+     * The last position on the z axis of each Node
+     *
+     * @param currentX
+     * The current position on the x axis of each Node
+     *
+     * @param currentY
+     * The current position on the y axis of each Node
+     *
+     * @param currentZ
+     * The current position on the z axis of each Node
+     *
+     * @param tolerance
+     * The tolerance of each Node
+     *
+     * @param count
+     * The number of Nodes in each array
+     *
+     * @param excess
+     * Where to store the distance past the tolerance for each Node
+     */
+    static void ExcessOverTolerance(const double* lastX,
+                                    const double* lastY,
+                                    const double* lastZ,
+                                    const double* currentX,
+                                    const double* currentY,
+                                    const double* currentZ,
+                                    const double* tolerance,
+                                    std::size_t count,
+                                    double* excess);
+
+  private:
+    /**
+     * Sample the position of `count` Nodes into `m_currentX`, `m_currentY`, & `m_currentZ`,
+     * then check each against its tolerance into `m_excess`
+     *
+     * @param slots
+     * The index of each Node to sample. Null to sample the first `count` Nodes in the index
+     *
+     * @param count
+     * The number of Nodes to sample
+     *
+     * @param lastX
+     * The last written position of each Node on the X axis
+     *
+     * @param lastY
+     * The last written position of each Node on the Y axis
+     *
+     * @param lastZ
+     * The last written position of each Node on the Z axis
+     *
+     * @param tolerance
+     * The tolerance of each Node
+     */
+    void Sample(const std::size_t* slots,
+                std::size_t count,
+                const double* lastX,
+                const double* lastY,
+                const double* lastZ,
+                const double* tolerance);
+
+    /**
+     * A Node waiting in the queue to be sampled
+     */
+    struct DueEntry
+    {
+        int64_t time;
+        std::size_t slot;
+        uint32_t generation;
+    };
+
+    /**
+     * Ordering for `std::push_heap()` & `std::pop_heap()`,
+     * so the Node due first is at the front of the queue.
+     * Nodes due at the same time are ordered by their place in the index
+     */
+    static bool Later(const DueEntry& left, const DueEntry& right);
+
+    /**
+     * Poll every Node
+     *
+     * @param changed
+     * Called for each Node to write a position for
+     *
+     * @return
+     * The number of changed Nodes
+     */
+    std::size_t PollAll(const ChangedCallback& changed);
+
+    /**
+     * Poll Nodes due at `now`, then queue them for when they are next due
+     *
+     * @param now
+     * The current time, in nanoseconds
+     *
+     * @param interval
+     * The time between polls, in nanoseconds
+     *
+     * @param changed
+     * Called for each Node to write a position for
+     *
+     * @return
+     * The number of changed Nodes
+     */
+    std::size_t PollDue(int64_t now, int64_t interval, const ChangedCallback& changed);
+
+    /**
+     * Queue `slot` to be sampled at `time`,
+     * replacing any earlier entry for it
+     *
+     * @param slot
+     * The index of the Node to queue
+     *
+     * @param time
+     * When the Node is next due, in nanoseconds
+     */
+    void Queue(std::size_t slot, int64_t time);
+
+    /**
+     * Flag indicating Nodes are only sampled when they are due
+     */
+    bool m_adaptive{false};
+
+    /**
+     * Nodes waiting to be sampled, as a heap ordered by `Later()`.
+     * Entries with an old generation for their slot are skipped
+     */
+    std::vector<DueEntry> m_queue;
+
+    /**
+     * Current generation of the queue entry of each Node
+     */
+    std::vector<uint32_t> m_generation;
+
+    /**
+     * Slots of the Nodes sampled by the current poll
+     */
+    std::vector<std::size_t> m_batch;
+
+    /**
+     * Last written position on each axis, & tolerance,
+     * of the Nodes in `m_batch`
+     */
+    std::vector<double> m_batchLastX;
+    std::vector<double> m_batchLastY;
+    std::vector<double> m_batchLastZ;
+    std::vector<double> m_batchTolerance;
+
+    /**
+     * Threads to sample on, null to sample on the calling thread
+     */
+    std::shared_ptr<WorkerPool> m_pool;
+
+    /**
+     * The TypeId names of mobility models which may be sampled on `m_pool`
+     */
+    std::vector<std::string> m_parallelModels;
+
+    /**
+     * Flag for each Node, set if its mobility model may be sampled on `m_pool`
+     */
+    std::vector<uint8_t> m_parallelSafe;
+
+    /**
+     * Mobility model of each Node, owned by the Node
+     */
+    std::vector<MobilityModel*> m_mobility;
+
+    /**
+     * Configuration of each Node, owned by the Orchestrator
+     */
+    std::vector<NodeConfiguration*> m_configurations;
+
+    /**
+     * ID of each Node
+     */
+    std::vector<uint32_t> m_ids;
+
+    /**
+     * Index of each Node by its ID
+     */
+    std::unordered_map<uint32_t, std::size_t> m_slots;
+
+    /**
+     * The `PositionTolerance` of each Node,
+     * or -1.0 when `UsePositionTolerance` is disabled
+     */
+    std::vector<double> m_tolerance;
+
+    /**
+     * Last written position on each axis
+     */
+    std::vector<double> m_lastX;
+    std::vector<double> m_lastY;
+    std::vector<double> m_lastZ;
+
+    /**
+     * Position sampled by the current poll on each axis.
+     * When adaptive, in the order of `m_batch`
+     */
+    std::vector<double> m_currentX;
+    std::vector<double> m_currentY;
+    std::vector<double> m_currentZ;
+
+    /**
+     * Result of the tolerance check of the current poll
+     *
+     * @see ExcessOverTolerance()
+     */
+    std::vector<double> m_excess;
+};
+
+} // namespace ns3::netsimulyzer
+
+#endif // MOBILITY_INDEX_H
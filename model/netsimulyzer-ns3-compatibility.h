@@ -68,6 +68,13 @@ constexpr auto TEST_TYPE_SYSTEM =
     TestSuite::SYSTEM;
 #endif
 
+constexpr auto TEST_TYPE_UNIT =
+#if NETSIMULYZER_NS3_VERSION > 42
+    TestSuite::Type::UNIT;
+#else
+    TestSuite::UNIT;
+#endif
+
 template <typename T, typename SetT, typename GetT>
 Ptr<const AttributeAccessor>
 MakeEnumAccessorCompat(SetT set, GetT get)
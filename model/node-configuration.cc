@@ -40,6 +40,7 @@
 #include "ns3/log.h"
 #include "ns3/mobility-model.h"
 #include "ns3/node.h"
+#include "ns3/nstime.h"
 #include "ns3/object-base.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
@@ -175,6 +176,12 @@ NodeConfiguration::GetTypeId(void)
                           BooleanValue(false),
                           MakeBooleanAccessor(&NodeConfiguration::m_faceForward),
                           MakeBooleanChecker())
+            .AddAttribute("OrientationTolerance",
+                          "The amount, in degrees, the heading set by `FaceForward` "
+                          "must change to have the orientation written again",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&NodeConfiguration::m_orientationTolerance),
+                          MakeDoubleChecker<double>(0.0, 180.0))
             .AddAttribute("KeepRatio",
                           "When scaling with the `Height`, `Width`, and `Depth` attributes, "
                           "use only the value that produces the largest model. "
@@ -233,14 +240,38 @@ NodeConfiguration::GetTypeId(void)
             .AddAttribute("PositionTolerance",
                           "The amount a Node must move to have it's position written again",
                           DoubleValue(0.05),
-                          MakeDoubleAccessor(&NodeConfiguration::m_positionTolerance),
+                          MakeDoubleAccessor(&NodeConfiguration::GetPositionTolerance,
+                                             &NodeConfiguration::SetPositionTolerance),
                           MakeDoubleChecker<double>(0))
             .AddAttribute("UsePositionTolerance",
                           "Only write positions when the Node has "
                           "moved beyond the 'PositionTolerance'.",
                           BooleanValue(true),
-                          MakeBooleanAccessor(&NodeConfiguration::m_usePositionTolerance),
+                          MakeBooleanAccessor(&NodeConfiguration::GetUsePositionTolerance,
+                                              &NodeConfiguration::SetUsePositionTolerance),
                           MakeBooleanChecker())
+            .AddAttribute("MobilityPollInterval",
+                          "How often to poll this Node for its position. "
+                          "Zero uses the `MobilityPollInterval` of the Orchestrator. "
+                          "Nodes with the same interval are polled together",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&NodeConfiguration::GetMobilityPollInterval,
+                                           &NodeConfiguration::SetMobilityPollInterval),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("CourseChangeTolerance",
+                          "Apply the `PositionTolerance` to positions from 'CourseChange' "
+                          "traces as well as polls. Ignored if `UsePositionTolerance` is false",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NodeConfiguration::m_courseChangeTolerance),
+                          MakeBooleanChecker())
+            .AddAttribute("MinCourseChangeInterval",
+                          "The minimum time between positions written from 'CourseChange' "
+                          "traces. Course changes sooner than this are held, & the latest "
+                          "position is written once the interval has passed. "
+                          "Zero writes every course change",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&NodeConfiguration::m_minCourseChangeInterval),
+                          MakeTimeChecker(Seconds(0)))
             .AddAttribute(
                 "Visible",
                 "Defines if the Node is rendered in the visualizer",
@@ -260,6 +291,11 @@ void
 NodeConfiguration::DoDispose(void)
 {
     NS_LOG_FUNCTION(this);
+    if (m_deferredCourseChange.has_value())
+    {
+        Simulator::Cancel(m_deferredCourseChange.value());
+        m_deferredCourseChange.reset();
+    }
     m_orchestrator = nullptr;
     Object::DoDispose();
 }
@@ -268,20 +304,64 @@ void
 NodeConfiguration::CourseChange(ns3::Ptr<const MobilityModel> model)
 {
     NS_LOG_FUNCTION(this << model);
+    const auto nodeId = model->GetObject<Node>()->GetId();
+
+    // Positions not written below must still reach the Orchestrator,
+    // since the Node may have started moving, & is otherwise never polled
+    // again with `AdaptiveMobilityPolling`
+    if (m_deferredCourseChange.has_value())
+    {
+        NS_LOG_DEBUG("Course change held, a later one is already scheduled");
+        m_orchestrator->HandleUnwrittenCourseChange(nodeId, m_lastPosition);
+        return;
+    }
+
+    const auto now = Simulator::Now();
+    if (m_lastCourseChange.has_value() &&
+        now < m_lastCourseChange.value() + m_minCourseChangeInterval)
+    {
+        // The position is read again once the interval passes,
+        // so only the latest course change in the interval is written
+        m_deferredCourseChange =
+            Simulator::Schedule(m_lastCourseChange.value() + m_minCourseChangeInterval - now,
+                                &NodeConfiguration::DeferredCourseChange,
+                                this,
+                                model);
+        m_orchestrator->HandleUnwrittenCourseChange(nodeId, m_lastPosition);
+        return;
+    }
+
     CourseChangeEvent event;
-    event.time = Simulator::Now();
-    event.nodeId = model->GetObject<Node>()->GetId();
+    event.time = now;
+    event.nodeId = nodeId;
     event.position = model->GetPosition();
 
-    m_orchestrator->HandleCourseChange(event);
+    if (m_courseChangeTolerance && m_usePositionTolerance &&
+        compareWithTolerance(event.position, m_lastPosition, m_positionTolerance))
+    {
+        NS_LOG_DEBUG("Node [ID: " << event.nodeId << "] Course change within tolerance");
+        m_orchestrator->HandleUnwrittenCourseChange(nodeId, m_lastPosition);
+        return;
+    }
 
-    if (m_faceForward)
+    // Written by the Orchestrator, along with the position
+    const auto orientation = FaceForward(event.position);
+    if (orientation)
     {
-        SetOrientation(
-            {m_orientation.x, m_orientation.y, faceForwardAngle(m_lastPosition, event.position)});
+        m_orientation = orientation.value();
     }
 
+    m_orchestrator->HandleCourseChange(event, orientation);
     m_lastPosition = event.position;
+    m_lastCourseChange = now;
+}
+
+void
+NodeConfiguration::DeferredCourseChange(Ptr<const MobilityModel> model)
+{
+    NS_LOG_FUNCTION(this << model);
+    m_deferredCourseChange.reset();
+    CourseChange(model);
 }
 
 void
@@ -332,36 +412,43 @@ NodeConfiguration::Link(Ptr<Node> target)
 }
 
 std::optional<Vector3D>
-NodeConfiguration::MobilityPoll(void)
+NodeConfiguration::ApplyPolledPosition(const Vector3D& position)
 {
-    NS_LOG_FUNCTION(this);
-    auto node = GetObject<Node>();
-    NS_ABORT_MSG_IF(!node, "Mobility poll activated on NodeConfiguration with no associated Node");
-
-    auto mobility = node->GetObject<MobilityModel>();
-    if (!mobility)
+    NS_LOG_FUNCTION(this << position);
+    const auto orientation = FaceForward(position);
+    if (orientation)
     {
-        NS_LOG_DEBUG("Mobility poll activated on Node with no Mobility Model, ignoring");
-        return {};
+        m_orientation = orientation.value();
     }
 
-    const auto position = mobility->GetPosition();
+    m_lastPosition = position;
+    return orientation;
+}
 
-    if (m_usePositionTolerance &&
-        compareWithTolerance(position, m_lastPosition, m_positionTolerance))
+std::optional<Vector3D>
+NodeConfiguration::FaceForward(const Vector3D& position) const
+{
+    if (!m_faceForward)
     {
-        NS_LOG_DEBUG("Node [ID: " << node->GetId() << "] Within tolerance");
         return {};
     }
 
-    if (m_faceForward)
+    const auto heading = faceForwardAngle(m_lastPosition, position);
+
+    // Smallest difference between the two headings, in [0, 180]
+    const auto turn = std::abs(std::remainder(heading - m_orientation.z, 360.0));
+    if (turn <= m_orientationTolerance)
     {
-        SetOrientation(
-            {m_orientation.x, m_orientation.y, faceForwardAngle(m_lastPosition, position)});
+        return {};
     }
-    m_lastPosition = position;
 
-    return {position};
+    return Vector3D{m_orientation.x, m_orientation.y, heading};
+}
+
+const Vector3D&
+NodeConfiguration::GetLastPosition(void) const
+{
+    return m_lastPosition;
 }
 
 const Vector3D&
@@ -568,6 +655,59 @@ NodeConfiguration::Visible() const
     return m_visible;
 }
 
+void
+NodeConfiguration::SetPositionTolerance(double value)
+{
+    m_positionTolerance = value;
+
+    // Polls copy the tolerance when they are built
+    if (m_orchestrator)
+    {
+        m_orchestrator->HandleMobilityPollChange();
+    }
+}
+
+double
+NodeConfiguration::GetPositionTolerance(void) const
+{
+    return m_positionTolerance;
+}
+
+void
+NodeConfiguration::SetUsePositionTolerance(bool value)
+{
+    m_usePositionTolerance = value;
+
+    if (m_orchestrator)
+    {
+        m_orchestrator->HandleMobilityPollChange();
+    }
+}
+
+bool
+NodeConfiguration::GetUsePositionTolerance(void) const
+{
+    return m_usePositionTolerance;
+}
+
+void
+NodeConfiguration::SetMobilityPollInterval(Time interval)
+{
+    m_mobilityPollInterval = interval;
+
+    // The Node moves to the bucket for the new interval
+    if (m_orchestrator)
+    {
+        m_orchestrator->HandleMobilityPollChange();
+    }
+}
+
+Time
+NodeConfiguration::GetMobilityPollInterval(void) const
+{
+    return m_mobilityPollInterval;
+}
+
 void
 NodeConfiguration::NotifyNewAggregate(void)
 {
@@ -598,6 +738,12 @@ NodeConfiguration::NotifyNewAggregate(void)
         "CourseChange",
         MakeCallback(&netsimulyzer::NodeConfiguration::CourseChange, this));
     m_attachedMobilityTrace = true;
+
+    // Nodes without a Mobility Model are left out of the polls
+    if (m_orchestrator)
+    {
+        m_orchestrator->HandleMobilityPollChange();
+    }
     Object::NotifyNewAggregate();
 }
 
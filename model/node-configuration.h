@@ -40,8 +40,10 @@
 #include "optional.h"
 #include "orchestrator.h"
 
+#include "ns3/event-id.h"
 #include "ns3/mobility-model.h"
 #include "ns3/node.h"
+#include "ns3/nstime.h"
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/type-id.h"
@@ -98,6 +100,15 @@ class NodeConfiguration : public Object
      */
     void CourseChange(Ptr<const MobilityModel> model);
 
+    /**
+     * Handle the latest course change held back by `MinCourseChangeInterval`,
+     * now that the interval has passed
+     *
+     * @param model
+     * The mobility model that triggered the trace
+     */
+    void DeferredCourseChange(Ptr<const MobilityModel> model);
+
     /**
      * Triggers in the application,
      * a bubble to grow out of the center
@@ -138,20 +149,27 @@ class NodeConfiguration : public Object
     Ptr<LogicalLink> Link(Ptr<Node> target);
 
     /**
-     * Called by the Orchestrator during a mobility poll.
+     * Record `position` as the last written position of this Node,
+     * turning the Node to face it first if `FaceForward` is enabled.
      *
-     * If `UsePositionTolerance`, is enabled this
-     * method checks against the `PositionTolerance`.
-     * If the Node has not moved beyond the tolerance,
-     * then an empty optional is returned.
+     * Called for each position written by a mobility poll.
+     * The new orientation is not written, so it may be
+     * written along with the position
      *
+     * @param position
+     * The position written for this Node
      *
      * @return
-     * An optional with the location of the associated Node
-     * if the position should be used, an unset optional
-     * otherwise
+     * The new orientation of the Node, if it turned
+     * beyond the `OrientationTolerance`. An unset optional otherwise
      */
-    std::optional<Vector3D> MobilityPoll(void);
+    std::optional<Vector3D> ApplyPolledPosition(const Vector3D& position);
+
+    /**
+     * @return
+     * The last position written for this Node
+     */
+    const Vector3D& GetLastPosition(void) const;
 
     /**
      * Sets the Orchestrator managing this Node &
@@ -317,6 +335,52 @@ class NodeConfiguration : public Object
      */
     [[nodiscard]] bool Visible() const;
 
+    /**
+     * Sets the amount the Node must move to have its position written again.
+     * Takes effect on the next mobility poll
+     *
+     * @param value
+     * The new tolerance
+     */
+    void SetPositionTolerance(double value);
+
+    /**
+     * @return
+     * The amount the Node must move to have its position written again
+     */
+    double GetPositionTolerance(void) const;
+
+    /**
+     * Sets if positions are only written once the Node moves beyond the `PositionTolerance`.
+     * Takes effect on the next mobility poll
+     *
+     * @param value
+     * False to write positions on every poll
+     */
+    void SetUsePositionTolerance(bool value);
+
+    /**
+     * @return
+     * If positions are only written once the Node moves beyond the `PositionTolerance`
+     */
+    bool GetUsePositionTolerance(void) const;
+
+    /**
+     * Sets how often to poll this Node for its position.
+     * Takes effect after the next poll of its current interval
+     *
+     * @param interval
+     * The time between polls. Zero uses the `MobilityPollInterval` of the Orchestrator
+     */
+    void SetMobilityPollInterval(Time interval);
+
+    /**
+     * @return
+     * How often this Node is polled for its position,
+     * zero if it uses the interval of the Orchestrator
+     */
+    Time GetMobilityPollInterval(void) const;
+
   protected:
     /**
      * @brief Disconnects the referenced Orchestrator
@@ -326,6 +390,19 @@ class NodeConfiguration : public Object
     void NotifyNewAggregate(void) override;
 
   private:
+    /**
+     * Find the orientation to face the direction of travel to `position`,
+     * if `FaceForward` is enabled
+     *
+     * @param position
+     * The position the Node is moving to
+     *
+     * @return
+     * The orientation facing `position`, if it differs from the current
+     * orientation by more than the `OrientationTolerance`. An unset optional otherwise
+     */
+    std::optional<Vector3D> FaceForward(const Vector3D& position) const;
+
     /**
      * Pointer to the Orchestrator managing this node
      */
@@ -372,6 +449,12 @@ class NodeConfiguration : public Object
      */
     bool m_faceForward;
 
+    /**
+     * The amount, in degrees, the heading from `m_faceForward`
+     * must change to write a new orientation
+     */
+    double m_orientationTolerance;
+
     /**
      * Flag for use with `Height`, `Width`, and `Depth`
      * attributes. When set, if more than one of the
@@ -460,6 +543,36 @@ class NodeConfiguration : public Object
      */
     bool m_usePositionTolerance;
 
+    /**
+     * How often to poll this Node for its position.
+     * Zero to use the Orchestrator's interval
+     */
+    Time m_mobilityPollInterval;
+
+    /**
+     * Apply `m_positionTolerance` to positions from course changes
+     * as well as polls. Only used if `m_usePositionTolerance` is set
+     */
+    bool m_courseChangeTolerance;
+
+    /**
+     * The minimum time between positions written from course changes.
+     * Zero to write every course change
+     */
+    Time m_minCourseChangeInterval;
+
+    /**
+     * The time of the last position written from a course change,
+     * unset if none have been
+     */
+    std::optional<Time> m_lastCourseChange;
+
+    /**
+     * Handles the latest course change held back by `m_minCourseChangeInterval`.
+     * Unset if none are held
+     */
+    std::optional<EventId> m_deferredCourseChange;
+
     /**
      * Flag to show the model in the visualizer or not
      */
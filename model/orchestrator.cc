@@ -35,6 +35,7 @@
 
 #include "building-configuration.h"
 #include "color.h"
+#include "json-event-emitter.h"
 #include "log-stream.h"
 #include "logical-link.h"
 #include "netsimulyzer-ns3-compatibility.h"
@@ -60,10 +61,16 @@
 #include "ns3/uinteger.h"
 #include "ns3/vector.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <csignal>
+#include <limits>
 #include <map>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace
@@ -271,10 +278,11 @@ Orchestrator::Orchestrator(const std::string& output_path)
     : m_outputPath(output_path)
 {
     NS_LOG_FUNCTION(this << output_path);
+    // Always binary, so `OutputFormat::Binary` is written as-is.
+    // The JSON output has no newlines, so it is unaffected
     m_file.open(output_path);
     NS_ABORT_MSG_IF(!m_file, "Failed to open output file");
 
-    Simulator::ScheduleNow(&Orchestrator::SetupSimulation, this);
 #ifdef NETSIMULYZER_CRASH_HANDLER
     orchestrators.emplace_back(this);
 #endif
@@ -287,6 +295,11 @@ Orchestrator::Orchestrator(Orchestrator::MemoryOutputMode mode)
     Init();
 }
 
+Orchestrator::~Orchestrator(void)
+{
+    StopWriterThread();
+}
+
 ns3::TypeId
 Orchestrator::GetTypeId(void)
 {
@@ -305,17 +318,186 @@ Orchestrator::GetTypeId(void)
                           "Please use `SetTimeStep()` instead")
           .AddAttribute ("MobilityPollInterval", "How often to poll Nodes for their position",
                          TimeValue (MilliSeconds (100)),
-                         MakeTimeAccessor (&Orchestrator::m_mobilityPollInterval),
+                         MakeTimeAccessor (&Orchestrator::SetMobilityPollInterval,
+                                           &Orchestrator::GetMobilityPollInterval),
                          MakeTimeChecker ())
+          .AddAttribute ("AdaptiveMobilityPolling",
+                         "Only poll a Node once it could have moved beyond its "
+                         "`PositionTolerance`, predicted from its velocity. "
+                         "Polls still happen on the `MobilityPollInterval`",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&Orchestrator::m_adaptiveMobilityPolling),
+                         MakeBooleanChecker ())
+          .AddAttribute ("MobilityPollThreads",
+                         "The number of threads to sample Node positions on during a poll. "
+                         "Only Nodes with a mobility model listed in `ParallelMobilityModels` "
+                         "are sampled on other threads. 0 or 1 samples every Node on the "
+                         "simulation thread",
+                         UintegerValue (0u),
+                         MakeUintegerAccessor (&Orchestrator::m_mobilityPollThreads),
+                         MakeUintegerChecker<uint32_t> ())
+          .AddAttribute ("ParallelMobilityModels",
+                         "Space separated TypeId names of mobility models whose `GetPosition()` "
+                         "may be called from another thread. It must not modify anything "
+                         "shared between models, or fire any trace",
+                         StringValue ("ns3::ConstantPositionMobilityModel "
+                                      "ns3::ConstantVelocityMobilityModel "
+                                      "ns3::ConstantAccelerationMobilityModel"),
+                         MakeStringAccessor (&Orchestrator::m_parallelMobilityModels),
+                         MakeStringChecker ())
+          .AddAttribute ("ReorderWindow",
+                         "How far behind the latest event an event may arrive, "
+                         "and still be written in time order. "
+                         "Zero writes events in the order they occur",
+                         TimeValue (Seconds (0)),
+                         MakeTimeAccessor (&Orchestrator::m_reorderWindow),
+                         MakeTimeChecker (Seconds (0)))
+          .AddAttribute ("LateEvents",
+                         "What to do with events which arrive too late to be written in time order. "
+                         "Only used when `ReorderWindow` is set",
+                         EnumValue (Orchestrator::LateEventPolicy::DropLate),
+                         MakeEnumAccessorCompat<Orchestrator::LateEventPolicy> (&Orchestrator::m_lateEventPolicy),
+                         MakeEnumChecker (Orchestrator::LateEventPolicy::DropLate, "Drop",
+                                          Orchestrator::LateEventPolicy::WriteLate, "Write"))
+          .AddAttribute ("EventBufferLimit",
+                         "Maximum memory, in MiB, to hold events in before they are sorted "
+                         "and spilled to temporary files next to the output file. "
+                         "Events are then written in time order. "
+                         "0 holds every event in memory, and writes them in the order they occurred. "
+                         "Not used when the output is streamed",
+                         UintegerValue (0u),
+                         MakeUintegerAccessor (&Orchestrator::m_eventBufferLimit),
+                         MakeUintegerChecker<uint32_t> ())
+          .AddAttribute ("KeyframeInterval",
+                         "How often to write a snapshot of every Node, Decoration, & Logical Link, "
+                         "so the application may seek without replaying every event. "
+                         "Zero disables keyframes",
+                         TimeValue (Seconds (0)),
+                         MakeTimeAccessor (&Orchestrator::m_keyframeInterval),
+                         MakeTimeChecker (Seconds (0)))
+          .AddAttribute ("TrajectoryMaxError",
+                         "Write Node motion as straight line segments, rather than individual "
+                         "positions. The furthest, on any axis, a segment may be from a position "
+                         "it replaces. Zero writes every position",
+                         DoubleValue (0.0),
+                         MakeDoubleAccessor (&Orchestrator::m_trajectoryMaxError),
+                         MakeDoubleChecker<double> (0.0))
+          .AddAttribute ("FrameMode",
+                         "Write Node positions & orientations once per time step, "
+                         "set by `SetTimeStep()`, as a single 'node-frame' event with "
+                         "the last state of each Node which changed during the step. "
+                         "The time step may not be changed once the simulation starts",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&Orchestrator::m_frameMode),
+                         MakeBooleanChecker ())
+          .AddAttribute ("RegionGridCellSize",
+                         "The width & height of each cell of the grid used to find "
+                         "the regions of interest & geofences a Node is inside of. "
+                         "Zero picks a size from the average size of the areas. "
+                         "Made larger if the grid would have too many cells",
+                         DoubleValue (0.0),
+                         MakeDoubleAccessor (&Orchestrator::m_regionGridCellSize),
+                         MakeDoubleChecker<double> (0.0))
+          .AddAttribute ("PoseEvents",
+                         "Write a Node's position & orientation as a single 'node-pose' event "
+                         "when both change at once, such as with `FaceForward`, rather than "
+                         "separate events. Requires a viewer which supports 'node-pose' events",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&Orchestrator::m_poseEvents),
+                         MakeBooleanChecker ())
           .AddAttribute ("PollMobility", "Flag to toggle polling for Node positions",
                          BooleanValue (true), MakeBooleanAccessor (&Orchestrator::GetPollMobility,
                                                                    &Orchestrator::SetPollMobility),
                          MakeBooleanChecker ())
           .AddAttribute ("StartTime", "Beginning of the window to write trace information",
-                         TimeValue (), MakeTimeAccessor (&Orchestrator::m_startTime),
+                         TimeValue (), MakeTimeAccessor (&Orchestrator::SetStartTime,
+                                                         &Orchestrator::GetStartTime),
                          MakeTimeChecker ())
           .AddAttribute ("StopTime", "End of the window to write trace information", TimeValue (Time::Max()),
-                         MakeTimeAccessor (&Orchestrator::m_stopTime), MakeTimeChecker ());
+                         MakeTimeAccessor (&Orchestrator::SetStopTime, &Orchestrator::GetStopTime),
+                         MakeTimeChecker ())
+          .AddAttribute ("StreamOutput",
+                         "Write events to the output file as they occur, "
+                         "rather than holding them in memory until the end of the simulation",
+                         BooleanValue (false), MakeBooleanAccessor (&Orchestrator::m_streamOutput),
+                         MakeBooleanChecker ())
+          .AddAttribute ("StreamBufferSize",
+                         "Number of bytes of events to collect before writing them to the output file. "
+                         "Only used when `StreamOutput` is enabled",
+                         UintegerValue (1024u * 1024u),
+                         MakeUintegerAccessor (&Orchestrator::m_streamBufferSize),
+                         MakeUintegerChecker<uint32_t> (1u))
+          .AddAttribute ("AsyncOutput",
+                         "Serialize & write events on a separate thread, "
+                         "rather than on the simulation thread. Implies `StreamOutput`",
+                         BooleanValue (false), MakeBooleanAccessor (&Orchestrator::m_asyncOutput),
+                         MakeBooleanChecker ())
+          .AddAttribute ("AsyncQueueSize",
+                         "Number of events which may wait for the writer thread. "
+                         "Rounded up to the next power of two. "
+                         "Only used when `AsyncOutput` is enabled",
+                         UintegerValue (65536u),
+                         MakeUintegerAccessor (&Orchestrator::m_asyncQueueSize),
+                         MakeUintegerChecker<uint32_t> (2u))
+          .AddAttribute ("AsyncBackpressure",
+                         "What to do with new events when the queue to the writer thread is full. "
+                         "Only used when `AsyncOutput` is enabled",
+                         EnumValue (Orchestrator::BackpressurePolicy::Block),
+                         MakeEnumAccessorCompat<Orchestrator::BackpressurePolicy> (&Orchestrator::m_backpressurePolicy),
+                         MakeEnumChecker (Orchestrator::BackpressurePolicy::Block, "Block",
+                                          Orchestrator::BackpressurePolicy::Drop, "Drop"))
+          .AddAttribute ("OutputFormat",
+                         "Format of the output file. `Binary` output must be converted "
+                         "with `netsimulyzer-binary-to-json` before it may be loaded",
+                         EnumValue (Orchestrator::OutputFormat::Json),
+                         MakeEnumAccessorCompat<Orchestrator::OutputFormat> (&Orchestrator::m_outputFormat),
+                         MakeEnumChecker (Orchestrator::OutputFormat::Json, "Json",
+                                          Orchestrator::OutputFormat::Binary, "Binary"))
+          .AddAttribute ("BinaryBlockSize",
+                         "Number of events of the same type to collect before writing them. "
+                         "Only used when `OutputFormat` is `Binary`",
+                         UintegerValue (4096u),
+                         MakeUintegerAccessor (&Orchestrator::m_binaryBlockSize),
+                         MakeUintegerChecker<uint32_t> (1u))
+          .AddAttribute ("BinaryEncoding",
+                         "How the columns of binary output are encoded. "
+                         "Only used when `OutputFormat` is `Binary`",
+                         EnumValue (Orchestrator::BinaryEncoding::Delta),
+                         MakeEnumAccessorCompat<Orchestrator::BinaryEncoding> (&Orchestrator::m_binaryEncoding),
+                         MakeEnumChecker (Orchestrator::BinaryEncoding::Raw, "Raw",
+                                          Orchestrator::BinaryEncoding::Delta, "Delta"))
+          .AddAttribute ("PositionResolution",
+                         "Step (in ns-3 units) Node positions are rounded to, 0 to keep them exact. "
+                         "Only used when `OutputFormat` is `Binary` and `BinaryEncoding` is `Delta`",
+                         DoubleValue (0.0),
+                         MakeDoubleAccessor (&Orchestrator::m_positionResolution),
+                         MakeDoubleChecker<double> (0.0))
+          .AddAttribute ("Compression",
+                         "Compression of the output file. "
+                         "`Auto` selects from the file extension (`.gz` or `.zst`)",
+                         EnumValue (Orchestrator::OutputCompression::Auto),
+                         MakeEnumAccessorCompat<Orchestrator::OutputCompression> (&Orchestrator::m_compression),
+                         MakeEnumChecker (Orchestrator::OutputCompression::Auto, "Auto",
+                                          Orchestrator::OutputCompression::None, "None",
+                                          Orchestrator::OutputCompression::Gzip, "Gzip",
+                                          Orchestrator::OutputCompression::Zstd, "Zstd"))
+          .AddAttribute ("CompressionLevel",
+                         "Compression level for the output file, 0 for the default of the format. "
+                         "At most 9 for gzip, and 22 for zstd",
+                         UintegerValue (0u),
+                         MakeUintegerAccessor (&Orchestrator::m_compressionLevel),
+                         MakeUintegerChecker<uint32_t> (0u, 22u))
+          .AddAttribute ("CompressionFrameSize",
+                         "Number of uncompressed bytes in each independently compressed frame. "
+                         "After a crash, every complete frame may still be decompressed",
+                         UintegerValue (1048576u),
+                         MakeUintegerAccessor (&Orchestrator::m_compressionFrameSize),
+                         MakeUintegerChecker<uint32_t> (1u))
+          .AddAttribute ("CompressionThread",
+                         "Compress the output file on a separate thread",
+                         BooleanValue (false),
+                         MakeBooleanAccessor (&Orchestrator::m_compressionThread),
+                         MakeBooleanChecker ());
 
   return tid;
     // clang-format on
@@ -329,6 +511,9 @@ Orchestrator::SetTimeStep(Time step, Time::Unit granularity)
                         granularity != Time::Unit::NS,
                     "'granularity' Passed to `Orchestrator::SetTimeStep` Must be either "
                     "`Time::Unit::MS`,'Time::Unit::US`, or `Time::Unit::NS`");
+    // Frames are scheduled from the step
+    NS_ABORT_MSG_IF(m_simulationStarted && m_frameMode,
+                    "The time step may not be changed after the simulation starts in `FrameMode`");
 
     m_timeStep = step;
     m_timeStepGranularity = granularity;
@@ -338,6 +523,8 @@ void
 Orchestrator::ClearTimeStep(void)
 {
     NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_simulationStarted && m_frameMode,
+                    "The time step may not be cleared after the simulation starts in `FrameMode`");
     m_timeStep.reset();
     m_timeStepGranularity.reset();
 }
@@ -357,6 +544,25 @@ Orchestrator::GetTimeStep() const
 const nlohmann::json&
 Orchestrator::GetJson() const
 {
+    // Only convert the events we haven't seen yet,
+    // since this may be called more than once
+    auto& events = m_document["events"];
+    std::string buffer;
+    JsonEventEmitter emitter{buffer};
+    for (; m_jsonEventCount < m_events.size(); m_jsonEventCount++)
+    {
+        const auto& event = m_events[m_jsonEventCount];
+        if (const auto keyframe = std::get_if<KeyframeEvent>(&event))
+        {
+            m_document["keyframes"].push_back(
+                {{"event", m_jsonEventCount}, {"nanoseconds", keyframe->time.GetNanoSeconds()}});
+        }
+
+        buffer.clear();
+        emitter.Write(event);
+        events.emplace_back(nlohmann::json::parse(buffer));
+    }
+
     return m_document;
 }
 
@@ -859,7 +1065,45 @@ Orchestrator::SetupSimulation(void)
     // Everything else is an event
     m_currentSection = Orchestrator::Section::Events;
 
+    if (m_keyframeInterval.IsStrictlyPositive())
+    {
+        // Filled in as keyframes are written, so it's always after `events`
+        m_document["keyframes"] = nlohmann::json::array();
+    }
+
+    if ((m_streamOutput || m_asyncOutput || m_outputFormat == OutputFormat::Binary) &&
+        m_file.is_open())
+    {
+        WriteStreamHeader();
+
+        if (m_asyncOutput)
+        {
+            StartWriterThread();
+        }
+    }
+    else if (m_eventBufferLimit > 0u && m_file.is_open())
+    {
+        const auto limit = static_cast<std::size_t>(m_eventBufferLimit) * 1024u * 1024u;
+        m_spillBuffer = std::make_unique<EventSpillBuffer>(m_outputPath + ".events-", limit);
+
+        // Keep any events which happened before now
+        while (!m_events.empty())
+        {
+            m_spillBuffer->Add(std::move(m_events.front()));
+            m_events.pop_front();
+        }
+    }
+
     NS_ABORT_MSG_IF(m_startTime > m_stopTime, "StopTime must be after StartTime");
+    NS_ABORT_MSG_IF(m_frameMode && (!m_timeStep || !m_timeStep->IsStrictlyPositive()),
+                    "`FrameMode` requires a time step, set with `SetTimeStep()`");
+    NS_ABORT_MSG_IF(m_frameMode && m_trajectoryMaxError > 0.0,
+                    "`FrameMode` may not be used with `TrajectoryMaxError`");
+
+    if (m_pollMobility)
+    {
+        BuildMobilityPollBuckets();
+    }
 
     // This method should be called immediately after the simulation starts,
     // so using the Start Time as the delay should be fine
@@ -868,6 +1112,25 @@ Orchestrator::SetupSimulation(void)
         m_mobilityPollEvent = Simulator::Schedule(m_startTime, &Orchestrator::PollMobility, this);
     }
 
+    if (!m_regionsOfInterest.empty())
+    {
+        Simulator::Schedule(m_startTime, &Orchestrator::BuildRegionsOfInterest, this);
+    }
+
+    if (!m_geofences.empty())
+    {
+        Simulator::Schedule(m_startTime, &Orchestrator::BuildGeofences, this);
+    }
+
+    // The header is the state at the Start Time,
+    // so the first keyframe is one interval after that
+    if (m_keyframeInterval.IsStrictlyPositive() && !m_keyframeEvent.has_value())
+    {
+        m_keyframeEvent = Simulator::Schedule(m_startTime + m_keyframeInterval,
+                                              &Orchestrator::WriteKeyframe,
+                                              this);
+    }
+
     Simulator::ScheduleDestroy(&Orchestrator::Flush, this);
 
     // Mark that simulation has begun,
@@ -900,10 +1163,9 @@ Orchestrator::SetPollMobility(bool enable)
         }
     }
 
-    else if (!m_pollMobility && m_mobilityPollEvent.has_value())
+    else if (!m_pollMobility)
     {
-        Simulator::Cancel(m_mobilityPollEvent.value());
-        m_mobilityPollEvent.reset();
+        CancelMobilityPolls();
     }
 }
 
@@ -915,288 +1177,932 @@ Orchestrator::GetPollMobility() const
 }
 
 void
-Orchestrator::PollMobility(void)
+Orchestrator::SetStartTime(Time start)
 {
-    NS_LOG_FUNCTION(this);
-    // Stop the polling if we've passed StopTime
-    // StartTime addressed in scheduling
-    if (Simulator::Now() > m_stopTime)
+    NS_LOG_FUNCTION(this << start);
+    m_startTime = start;
+    for (const auto& [interval, clock] : m_sinkClocks)
     {
-        NS_LOG_DEBUG("PollMobility() Activated past StopTime, Ignoring");
-        m_mobilityPollEvent.reset();
-        return;
+        clock->SetWindow(m_startTime, m_stopTime);
     }
+}
 
-    for (const auto& config : m_nodes)
-    {
-        const auto node = config->GetObject<Node>();
+Time
+Orchestrator::GetStartTime(void) const
+{
+    return m_startTime;
+}
 
-        auto position = config->MobilityPoll();
-        if (position)
-        {
-            WritePosition(node->GetId(), Simulator::Now(), position.value());
-        }
+void
+Orchestrator::SetStopTime(Time stop)
+{
+    NS_LOG_FUNCTION(this << stop);
+    m_stopTime = stop;
+    for (const auto& [interval, clock] : m_sinkClocks)
+    {
+        clock->SetWindow(m_startTime, m_stopTime);
     }
+}
 
-    m_mobilityPollEvent =
-        Simulator::Schedule(m_mobilityPollInterval, &Orchestrator::PollMobility, this);
+Time
+Orchestrator::GetStopTime(void) const
+{
+    return m_stopTime;
 }
 
 void
-Orchestrator::WritePosition(uint32_t nodeId, Time time, Vector3D position)
+Orchestrator::SetMobilityPollInterval(Time interval)
 {
-    NS_LOG_FUNCTION(this << nodeId << time << position);
-    nlohmann::json element;
-    element["type"] = "node-position";
-    element["nanoseconds"] = time.GetNanoSeconds();
-    element["id"] = nodeId;
-    element["x"] = position.x;
-    element["y"] = position.y;
-    element["z"] = position.z;
-    m_document["events"].emplace_back(element);
+    NS_LOG_FUNCTION(this << interval);
+    m_mobilityPollInterval = interval;
+
+    // Nodes without their own interval move to a different bucket
+    m_mobilityIndexDirty = true;
 }
 
-void
-Orchestrator::DoDispose(void)
+Time
+Orchestrator::GetMobilityPollInterval(void) const
 {
-    NS_LOG_FUNCTION(this);
-    Flush();
-    m_xYSeries.clear();
-    m_categorySeries.clear();
-    m_seriesCollections.clear();
-    m_decorations.clear();
-    m_nodes.clear();
-    m_buildings.clear();
-    m_streams.clear();
-    m_areas.clear();
-    Object::DoDispose();
+    return m_mobilityPollInterval;
 }
 
 void
-Orchestrator::HandleCourseChange(const CourseChangeEvent& event)
+Orchestrator::PollMobility(void)
 {
     NS_LOG_FUNCTION(this);
-    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+    m_mobilityPollEvent.reset();
+
+    // Stop the polling if we've passed StopTime
+    // StartTime addressed in scheduling
+    if (Simulator::Now() > m_stopTime)
     {
-        NS_LOG_DEBUG("HandleCourseChange() Activated outside (StartTime, StopTime), Ignoring");
+        NS_LOG_DEBUG("PollMobility() Activated past StopTime, Ignoring");
         return;
     }
-    else if (!m_simulationStarted)
+
+    if (m_mobilityIndexDirty)
     {
-        NS_LOG_DEBUG("HandleCourseChange() Activated before simulation started, Ignoring");
-        return;
+        BuildMobilityPollBuckets();
     }
 
-    WritePosition(event.nodeId, event.time, event.position);
+    // Each bucket schedules its own polls from here
+    for (auto& [interval, bucket] : m_mobilityPollBuckets)
+    {
+        if (!bucket.event.has_value())
+        {
+            PollMobilityBucket(interval);
+        }
+    }
 }
 
 void
-Orchestrator::HandlePositionChange(const DecorationMoveEvent& event)
+Orchestrator::BuildMobilityPollBuckets(void)
 {
     NS_LOG_FUNCTION(this);
-    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+    std::map<int64_t, std::vector<Ptr<NodeConfiguration>>> groups;
+    m_mobilityPollBucketOf.clear();
+
+    for (const auto& config : m_nodes)
     {
-        NS_LOG_DEBUG("HandlePositionChange() Activated outside (StartTime, StopTime), Ignoring");
-        return;
+        const auto node = config->GetObject<Node>();
+        NS_ABORT_MSG_IF(!node,
+                        "Mobility poll activated on NodeConfiguration with no associated Node");
+
+        TimeValue interval;
+        config->GetAttribute("MobilityPollInterval", interval);
+
+        const auto key = interval.Get().IsStrictlyPositive()
+                             ? interval.Get().GetNanoSeconds()
+                             : m_mobilityPollInterval.GetNanoSeconds();
+        groups[key].emplace_back(config);
+        m_mobilityPollBucketOf[node->GetId()] = key;
     }
-    else if (!m_simulationStarted)
+
+    // Buckets without any Nodes left stop polling
+    for (auto bucket = m_mobilityPollBuckets.begin(); bucket != m_mobilityPollBuckets.end();)
     {
-        NS_LOG_DEBUG("HandleCourseChange() Activated before simulation started, Ignoring");
-        return;
+        if (groups.find(bucket->first) != groups.end())
+        {
+            bucket++;
+            continue;
+        }
+
+        if (bucket->second.event.has_value())
+        {
+            Simulator::Cancel(bucket->second.event.value());
+        }
+        bucket = m_mobilityPollBuckets.erase(bucket);
     }
 
-    if (m_currentSection != Section::Events)
+    std::vector<std::string> parallelModels;
+    if (m_mobilityPollThreads > 1u)
     {
-        // We'll get the final orientation when we write the head info
-        NS_LOG_DEBUG("DecorationMoveEvent ignored. Not in Events section");
-        return;
+        if (!m_mobilityPollPool || m_mobilityPollPool->GetThreadCount() != m_mobilityPollThreads)
+        {
+            m_mobilityPollPool = std::make_shared<WorkerPool>(m_mobilityPollThreads);
+        }
+
+        std::istringstream names{m_parallelMobilityModels};
+        for (std::string name; names >> name;)
+        {
+            parallelModels.emplace_back(name);
+        }
+    }
+    else
+    {
+        m_mobilityPollPool.reset();
     }
 
-    nlohmann::json element;
-    element["type"] = "decoration-position";
-    element["nanoseconds"] = event.time.GetNanoSeconds();
-    element["id"] = event.id;
-    element["x"] = event.position.x;
-    element["y"] = event.position.y;
-    element["z"] = event.position.z;
+    for (const auto& [interval, nodes] : groups)
+    {
+        auto& index = m_mobilityPollBuckets[interval].index;
+        index.SetParallelSampling(m_mobilityPollPool, parallelModels);
+        index.Build(nodes, m_adaptiveMobilityPolling);
+    }
 
-    m_document["events"].emplace_back(element);
+    m_mobilityIndexDirty = false;
 }
 
 void
-Orchestrator::HandleModelChange(const NodeModelChangeEvent& event)
+Orchestrator::PollMobilityBucket(int64_t interval)
 {
-    NS_LOG_FUNCTION(this);
-    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+    NS_LOG_FUNCTION(this << interval);
+    m_mobilityPollBuckets[interval].event.reset();
+
+    if (Simulator::Now() > m_stopTime)
     {
-        NS_LOG_DEBUG("HandleModelChange() Activated outside (StartTime, StopTime), Ignoring");
+        NS_LOG_DEBUG("PollMobilityBucket() Activated past StopTime, Ignoring");
         return;
     }
-    else if (!m_simulationStarted)
+
+    if (m_mobilityIndexDirty)
     {
-        NS_LOG_DEBUG("HandleModelChange() Activated before simulation started, Ignoring");
-        return;
+        BuildMobilityPollBuckets();
+
+        // Start polling any new intervals,
+        // which may have taken every Node from this bucket
+        for (auto& [otherInterval, other] : m_mobilityPollBuckets)
+        {
+            if (otherInterval != interval && !other.event.has_value() &&
+                !other.lastPoll.has_value())
+            {
+                other.event = Simulator::ScheduleNow(&Orchestrator::PollMobilityBucket,
+                                                     this,
+                                                     otherInterval);
+            }
+        }
+
+        // This bucket lost all of its Nodes
+        if (m_mobilityPollBuckets.find(interval) == m_mobilityPollBuckets.end())
+        {
+            return;
+        }
     }
 
-    if (m_currentSection != Section::Events)
+    auto& bucket = m_mobilityPollBuckets[interval];
+    const auto now = Simulator::Now();
+    bucket.index.Poll(now.GetNanoSeconds(),
+                      interval,
+                      [this](uint32_t nodeId,
+                             const Vector3D& position,
+                             const std::optional<Vector3D>& orientation) {
+                          QueuePosition(nodeId, position, orientation);
+                      });
+    bucket.lastPoll = now;
+
+    if (!m_adaptiveMobilityPolling)
     {
-        // We'll get the final model when we write the head info
-        NS_LOG_DEBUG("NodeModelChangeEvent ignored. Not in Events section");
+        bucket.event = Simulator::Schedule(NanoSeconds(interval),
+                                           &Orchestrator::PollMobilityBucket,
+                                           this,
+                                           interval);
         return;
     }
 
-    nlohmann::json element;
-    element["type"] = "node-model-change";
-    element["nanoseconds"] = event.time.GetNanoSeconds();
-    element["id"] = event.id;
-    element["model"] = event.model;
+    const auto nextDue = bucket.index.GetNextDue();
+    if (nextDue == std::numeric_limits<int64_t>::max())
+    {
+        NS_LOG_DEBUG("No Nodes due to be polled, waiting for a course change");
+        return;
+    }
 
-    m_document["events"].emplace_back(element);
+    bucket.event = Simulator::Schedule(NanoSeconds(nextDue) - now,
+                                       &Orchestrator::PollMobilityBucket,
+                                       this,
+                                       interval);
 }
 
 void
-Orchestrator::HandleOrientationChange(const NodeOrientationChangeEvent& event)
+Orchestrator::CancelMobilityPolls(void)
 {
     NS_LOG_FUNCTION(this);
-    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+    if (m_mobilityPollEvent.has_value())
     {
-        NS_LOG_DEBUG("HandleOrientationChange() Activated outside (StartTime, StopTime), Ignoring");
-        return;
+        Simulator::Cancel(m_mobilityPollEvent.value());
+        m_mobilityPollEvent.reset();
     }
 
-    if (m_currentSection != Section::Events)
+    for (auto& [interval, bucket] : m_mobilityPollBuckets)
     {
-        // We'll get the final orientation when we write the head info
-        NS_LOG_DEBUG("NodeOrientationChangeEvent ignored. Not in Events section");
-        return;
+        if (bucket.event.has_value())
+        {
+            Simulator::Cancel(bucket.event.value());
+            bucket.event.reset();
+        }
     }
-
-    nlohmann::json element;
-    element["type"] = "node-orientation";
-    element["nanoseconds"] = event.time.GetNanoSeconds();
-    element["id"] = event.nodeId;
-    element["x"] = event.orientation.x;
-    element["y"] = event.orientation.y;
-    element["z"] = event.orientation.z;
-
-    m_document["events"].emplace_back(element);
 }
 
-void
-Orchestrator::HandleOrientationChange(const DecorationOrientationChangeEvent& event)
+Orchestrator::MobilityPollBucket*
+Orchestrator::FindMobilityPollBucket(uint32_t nodeId)
 {
-    NS_LOG_FUNCTION(this);
-    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+    const auto interval = m_mobilityPollBucketOf.find(nodeId);
+    if (interval == m_mobilityPollBucketOf.end())
     {
-        NS_LOG_DEBUG("HandleOrientationChange() Activated outside (StartTime, StopTime), Ignoring");
-        return;
+        return nullptr;
     }
 
-    if (m_currentSection != Section::Events)
+    const auto bucket = m_mobilityPollBuckets.find(interval->second);
+    if (bucket == m_mobilityPollBuckets.end())
     {
-        // We'll get the final orientation when we write the head info
-        NS_LOG_DEBUG("DecorationOrientationChangeEvent ignored. Not in Events section");
-        return;
+        return nullptr;
     }
 
-    nlohmann::json element;
-    element["type"] = "decoration-orientation";
-    element["nanoseconds"] = event.time.GetNanoSeconds();
-    element["id"] = event.id;
-    element["x"] = event.orientation.x;
-    element["y"] = event.orientation.y;
-    element["z"] = event.orientation.z;
-    m_document["events"].emplace_back(element);
+    return &bucket->second;
 }
 
 void
-Orchestrator::HandleColorChange(const NodeColorChangeEvent& event)
+Orchestrator::WakeMobilityPoll(uint32_t nodeId)
 {
-    NS_LOG_FUNCTION(this);
-    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+    NS_LOG_FUNCTION(this << nodeId);
+    const auto bucket = FindMobilityPollBucket(nodeId);
+    if (!bucket)
     {
-        NS_LOG_DEBUG("HandleColorChange() Activated outside (StartTime, StopTime), Ignoring");
         return;
     }
 
-    if (m_currentSection != Section::Events)
+    const auto now = Simulator::Now();
+    const auto interval = m_mobilityPollBucketOf[nodeId];
+
+    // The next poll on the interval after the last one
+    auto due = now;
+    if (bucket->lastPoll.has_value())
     {
-        // We'll get the final color when we write the head info
-        NS_LOG_DEBUG("NodeColorChangeEvent ignored. Not in Events section");
-        return;
+        const auto elapsed = (now - bucket->lastPoll.value()).GetNanoSeconds();
+        const auto intervals = std::max<int64_t>(1, (elapsed + interval - 1) / interval);
+        due = bucket->lastPoll.value() + NanoSeconds(intervals * interval);
     }
 
-    nlohmann::json element;
-    element["type"] = "node-color";
-    element["nanoseconds"] = event.time.GetNanoSeconds();
-    element["id"] = event.id;
-    switch (event.type)
+    bucket->index.Wake(nodeId, due.GetNanoSeconds());
+
+    if (bucket->event.has_value() && now + Simulator::GetDelayLeft(bucket->event.value()) <= due)
     {
-    case NodeColorChangeEvent::ColorType::Base:
-        element["color-type"] = "base";
-        break;
-    case NodeColorChangeEvent::ColorType::Highlight:
-        element["color-type"] = "highlight";
-        break;
-    default:
-        NS_ABORT_MSG("Unhandled ColorType passed to HandleColorChange ()");
-        break;
+        return;
     }
 
-    if (event.color.has_value())
+    if (bucket->event.has_value())
     {
-        element["color"] = colorToObject(event.color.value());
+        Simulator::Cancel(bucket->event.value());
     }
-
-    m_document["events"].emplace_back(element);
+    bucket->event =
+        Simulator::Schedule(due - now, &Orchestrator::PollMobilityBucket, this, interval);
 }
 
 void
-Orchestrator::HandleVisibilityChange(const NodeVisibilityChangeEvent& e)
+Orchestrator::WriteKeyframe(void)
 {
     NS_LOG_FUNCTION(this);
-
-    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+    if (Simulator::Now() > m_stopTime)
     {
-        NS_LOG_DEBUG("HandleVisibilityChange() Activated outside [StartTime, StopTime], Ignoring");
+        NS_LOG_DEBUG("WriteKeyframe() Activated past StopTime, Ignoring");
+        m_keyframeEvent.reset();
         return;
     }
 
-    nlohmann::json element;
-    element["type"] = "node-change";
-    element["nanoseconds"] = e.time.GetNanoSeconds();
-    element["id"] = e.id;
-    element["visibility"] = e.visible;
+    KeyframeEvent keyframe{Simulator::Now(), {}, {}, {}};
 
-    m_document["events"].emplace_back(element);
-}
+    keyframe.nodes.reserve(m_nodes.size());
+    for (const auto& config : m_nodes)
+    {
+        const auto node = config->GetObject<Node>();
 
-void
-Orchestrator::HandleTransmit(const TransmitEvent& event)
-{
-    NS_LOG_FUNCTION(this);
+        KeyframeEvent::NodeState state{node->GetId(), {}, {}, {}, {}, true, {}};
 
-    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+        // Same as the header, without a position just use the origin
+        const auto mobility = node->GetObject<MobilityModel>();
+        if (mobility)
+        {
+            state.position = mobility->GetPosition();
+        }
+
+        Vector3DValue orientation;
+        config->GetAttribute("Orientation", orientation);
+        state.orientation = orientation.Get();
+
+        OptionalValue<Color3> baseColor;
+        config->GetAttribute("BaseColor", baseColor);
+        if (baseColor)
+        {
+            state.baseColor = baseColor.GetValue();
+        }
+
+        OptionalValue<Color3> highlightColor;
+        config->GetAttribute("HighlightColor", highlightColor);
+        if (highlightColor)
+        {
+            state.highlightColor = highlightColor.GetValue();
+        }
+
+        BooleanValue visible;
+        config->GetAttribute("Visible", visible);
+        state.visible = visible.Get();
+
+        StringValue model;
+        config->GetAttribute("Model", model);
+        state.model = model.Get();
+
+        keyframe.nodes.emplace_back(std::move(state));
+    }
+
+    keyframe.decorations.reserve(m_decorations.size());
+    for (const auto& decoration : m_decorations)
     {
-        NS_LOG_DEBUG("HandleTransmit() Activated outside (StartTime, StopTime), Ignoring");
-        return;
+        UintegerValue id;
+        decoration->GetAttribute("Id", id);
+        keyframe.decorations.push_back({static_cast<uint32_t>(id.Get()),
+                                        decoration->GetPosition(),
+                                        decoration->GetOrientation()});
     }
 
-    nlohmann::json element;
-    element["type"] = "node-transmit";
-    element["nanoseconds"] = event.time.GetNanoSeconds();
-    element["id"] = event.nodeId;
-    element["duration"] = event.duration.GetNanoSeconds();
-    element["target-size"] = event.targetSize;
-    element["color"] = colorToObject(event.color);
+    keyframe.links.reserve(m_logicalLinks.size());
+    for (const auto& link : m_logicalLinks)
+    {
+        keyframe.links.push_back({link->GetId(),
+                                  link->GetNodes(),
+                                  link->IsActive(),
+                                  link->GetColor(),
+                                  link->GetDiameter()});
+    }
+
+    WriteEvent(std::move(keyframe));
 
-    m_document["events"].emplace_back(element);
+    m_keyframeEvent =
+        Simulator::Schedule(m_keyframeInterval, &Orchestrator::WriteKeyframe, this);
 }
 
-uint32_t
-Orchestrator::Register(Ptr<Decoration> decoration)
+void
+Orchestrator::WritePosition(uint32_t nodeId,
+                            Time time,
+                            Vector3D position,
+                            const std::optional<Vector3D>& orientation)
 {
-    NS_LOG_FUNCTION(this << decoration);
+    NS_LOG_FUNCTION(this << nodeId << time << position);
+    if (!m_geofences.empty())
+    {
+        UpdateGeofences(nodeId, time, position);
+    }
+
+    if (!m_regionsOfInterest.empty() && !UpdateRegionsOfInterest(nodeId, time, position))
+    {
+        NS_LOG_DEBUG("Node [ID: " << nodeId << "] Outside every region of interest");
+        return;
+    }
+
+    if (m_trajectoryMaxError <= 0.0)
+    {
+        if (m_poseEvents && orientation.has_value())
+        {
+            WriteEvent(NodePoseEvent{time, nodeId, position, orientation.value()});
+            return;
+        }
+
+        WriteEvent(CourseChangeEvent{time, nodeId, position});
+    }
+    else
+    {
+        WriteTrajectory(nodeId, time, position);
+    }
+
+    if (orientation.has_value())
+    {
+        WriteEvent(NodeOrientationChangeEvent{time, nodeId, orientation.value()});
+    }
+}
+
+void
+Orchestrator::QueuePosition(uint32_t nodeId,
+                            const Vector3D& position,
+                            const std::optional<Vector3D>& orientation)
+{
+    NS_LOG_FUNCTION(this << nodeId << position);
+    auto& pending = m_pendingPositions[nodeId];
+
+    // Several course changes, or a course change & a poll, at the same time
+    // (or frame). Only the last position is kept, along with the last turn made
+    if (pending.position.has_value())
+    {
+        NS_LOG_DEBUG("Node [ID: " << nodeId << "] Replacing position held for the current time");
+    }
+
+    pending.position = position;
+    if (orientation.has_value())
+    {
+        pending.orientation = orientation;
+    }
+
+    SchedulePendingPositions();
+}
+
+void
+Orchestrator::QueueOrientation(uint32_t nodeId, const Vector3D& orientation)
+{
+    NS_LOG_FUNCTION(this << nodeId << orientation);
+    m_pendingPositions[nodeId].orientation = orientation;
+    SchedulePendingPositions();
+}
+
+void
+Orchestrator::SchedulePendingPositions(void)
+{
+    if (m_pendingPositionsEvent.has_value())
+    {
+        return;
+    }
+
+    const auto now = Simulator::Now();
+    if (!m_frameMode)
+    {
+        m_pendingPositionsTime = now;
+        m_pendingPositionsEvent =
+            Simulator::ScheduleNow(&Orchestrator::WritePendingPositions, this);
+        return;
+    }
+
+    // Changes are written at the end of the frame they happen in,
+    // or the next one, if the frame ending now was already written
+    const auto step = m_timeStep->GetNanoSeconds();
+    auto frame = (now.GetNanoSeconds() + step - 1) / step * step;
+    if (m_lastFrame.has_value() && frame <= m_lastFrame->GetNanoSeconds())
+    {
+        frame = m_lastFrame->GetNanoSeconds() + step;
+    }
+
+    m_pendingPositionsTime = std::min(NanoSeconds(frame), std::max(m_stopTime, now));
+    m_pendingPositionsEvent = Simulator::Schedule(m_pendingPositionsTime - now,
+                                                  &Orchestrator::WritePendingPositions,
+                                                  this);
+}
+
+void
+Orchestrator::WritePendingPositions(void)
+{
+    NS_LOG_FUNCTION(this);
+    m_pendingPositionsEvent.reset();
+
+    if (!m_frameMode)
+    {
+        for (const auto& [nodeId, pending] : m_pendingPositions)
+        {
+            WritePosition(nodeId,
+                          m_pendingPositionsTime,
+                          pending.position.value(),
+                          pending.orientation);
+        }
+        m_pendingPositions.clear();
+        return;
+    }
+
+    NodeFrameEvent frame;
+    frame.time = m_pendingPositionsTime;
+    frame.nodes.reserve(m_pendingPositions.size());
+    for (const auto& [nodeId, pending] : m_pendingPositions)
+    {
+        if (pending.position.has_value() && !m_geofences.empty())
+        {
+            UpdateGeofences(nodeId, frame.time, pending.position.value());
+        }
+
+        if (pending.position.has_value() && !m_regionsOfInterest.empty() &&
+            !UpdateRegionsOfInterest(nodeId, frame.time, pending.position.value()))
+        {
+            NS_LOG_DEBUG("Node [ID: " << nodeId << "] Outside every region of interest");
+            continue;
+        }
+
+        frame.nodes.push_back({nodeId, pending.position, pending.orientation});
+    }
+    m_pendingPositions.clear();
+    m_lastFrame = frame.time;
+
+    if (!frame.nodes.empty())
+    {
+        WriteEvent(std::move(frame));
+    }
+}
+
+void
+Orchestrator::BuildRegionsOfInterest(void)
+{
+    NS_LOG_FUNCTION(this);
+    m_regionTracker.Clear();
+    for (const auto& area : m_regionsOfInterest)
+    {
+        UintegerValue id;
+        area->GetAttribute("Id", id);
+
+        RectangleValue bounds;
+        area->GetAttribute("Bounds", bounds);
+        m_regionTracker.Add(static_cast<uint32_t>(id.Get()), bounds.Get());
+    }
+    m_regionTracker.Build(m_regionGridCellSize);
+
+    // Nodes which never move still need to be placed
+    ForEachNodePosition([this](uint32_t nodeId, const Vector3D& position) {
+        UpdateRegionsOfInterest(nodeId, Simulator::Now(), position);
+    });
+}
+
+bool
+Orchestrator::UpdateRegionsOfInterest(uint32_t nodeId, Time time, const Vector3D& position)
+{
+    return m_regionTracker.Update(nodeId, position, [this, nodeId, time](uint32_t areaId,
+                                                                        bool entered) {
+        WriteEvent(AreaCrossingEvent{time, nodeId, areaId, entered});
+    });
+}
+
+bool
+Orchestrator::InRegionOfInterest(uint32_t nodeId) const
+{
+    return m_regionsOfInterest.empty() || m_regionTracker.IsInside(nodeId);
+}
+
+void
+Orchestrator::BuildGeofences(void)
+{
+    NS_LOG_FUNCTION(this);
+    m_geofenceTracker.Clear();
+    for (auto& [areaId, geofence] : m_geofences)
+    {
+        RectangleValue bounds;
+        geofence.area->GetAttribute("Bounds", bounds);
+        m_geofenceTracker.Add(areaId, bounds.Get());
+
+        geofence.count = 0u;
+        geofence.writeCrossings = std::find(m_regionsOfInterest.begin(),
+                                            m_regionsOfInterest.end(),
+                                            geofence.area) == m_regionsOfInterest.end();
+    }
+    m_geofenceTracker.Build(m_regionGridCellSize);
+
+    // Place every Node before writing the occupancy,
+    // so each series starts with a single point
+    const auto now = Simulator::Now();
+    ForEachNodePosition([this, now](uint32_t nodeId, const Vector3D& position) {
+        m_geofenceTracker.Update(nodeId, position, [this, nodeId, now](uint32_t areaId, bool) {
+            auto& geofence = m_geofences.at(areaId);
+            geofence.count++;
+            if (geofence.writeCrossings)
+            {
+                WriteEvent(AreaCrossingEvent{now, nodeId, areaId, true});
+            }
+        });
+    });
+
+    for (const auto& [areaId, geofence] : m_geofences)
+    {
+        geofence.occupancy->Append(now.GetSeconds(), geofence.count);
+    }
+}
+
+void
+Orchestrator::UpdateGeofences(uint32_t nodeId, Time time, const Vector3D& position)
+{
+    m_geofenceTracker.Update(nodeId, position, [this, nodeId, time](uint32_t areaId,
+                                                                   bool entered) {
+        auto& geofence = m_geofences.at(areaId);
+        if (entered)
+        {
+            geofence.count++;
+        }
+        else
+        {
+            geofence.count--;
+        }
+
+        if (geofence.writeCrossings)
+        {
+            WriteEvent(AreaCrossingEvent{time, nodeId, areaId, entered});
+        }
+        geofence.occupancy->Append(time.GetSeconds(), geofence.count);
+    });
+}
+
+void
+Orchestrator::ForEachNodePosition(
+    const std::function<void(uint32_t, const Vector3D&)>& place) const
+{
+    for (const auto& config : m_nodes)
+    {
+        const auto node = config->GetObject<Node>();
+        if (!node)
+        {
+            continue;
+        }
+
+        const auto mobility = node->GetObject<MobilityModel>();
+        place(node->GetId(), mobility ? mobility->GetPosition() : config->GetLastPosition());
+    }
+}
+
+void
+Orchestrator::WriteTrajectory(uint32_t nodeId, Time time, Vector3D position)
+{
+    NS_LOG_FUNCTION(this << nodeId << time << position);
+    auto& trajectory = m_trajectories.try_emplace(nodeId, m_trajectoryMaxError).first->second;
+
+    // Polls skip positions within the Node's tolerance,
+    // so as of the last poll, the Node was still at its last position
+    const auto lastTime = trajectory.GetLastTime();
+    const auto bucket = FindMobilityPollBucket(nodeId);
+    if (m_pollMobility && lastTime.has_value() && bucket && bucket->lastPoll.has_value())
+    {
+        const auto lastPoll = bucket->lastPoll->GetNanoSeconds();
+        if (lastTime.value() < lastPoll && lastPoll < time.GetNanoSeconds())
+        {
+            WriteSegment(nodeId, time, trajectory.Add(lastPoll, trajectory.GetLastPosition()));
+        }
+    }
+
+    WriteSegment(nodeId, time, trajectory.Add(time.GetNanoSeconds(), position));
+}
+
+void
+Orchestrator::WriteSegment(uint32_t nodeId,
+                           Time time,
+                           const std::optional<TrajectorySimplifier::Segment>& segment)
+{
+    if (!segment.has_value())
+    {
+        return;
+    }
+
+    WriteEvent(NodeSegmentEvent{time,
+                                nodeId,
+                                NanoSeconds(segment->start),
+                                NanoSeconds(segment->end),
+                                segment->position,
+                                segment->velocity});
+}
+
+void
+Orchestrator::FinishTrajectories(void)
+{
+    NS_LOG_FUNCTION(this);
+    const auto time = std::min(m_stopTime, Simulator::Now());
+    for (auto& [nodeId, trajectory] : m_trajectories)
+    {
+        WriteSegment(nodeId, time, trajectory.Finish());
+    }
+}
+
+void
+Orchestrator::DoDispose(void)
+{
+    NS_LOG_FUNCTION(this);
+    Flush();
+    m_xYSeries.clear();
+    m_categorySeries.clear();
+    m_seriesCollections.clear();
+    m_decorations.clear();
+    m_nodes.clear();
+    m_mobilityPollBuckets.clear();
+    m_mobilityPollBucketOf.clear();
+    m_mobilityPollPool.reset();
+    m_buildings.clear();
+    m_streams.clear();
+    m_areas.clear();
+    m_regionsOfInterest.clear();
+    m_regionTracker.Clear();
+    m_geofences.clear();
+    m_geofenceTracker.Clear();
+    for (const auto& [interval, clock] : m_sinkClocks)
+    {
+        clock->Stop();
+    }
+    m_sinkClocks.clear();
+    Object::DoDispose();
+}
+
+void
+Orchestrator::HandleCourseChange(const CourseChangeEvent& event,
+                                 const std::optional<Vector3D>& orientation)
+{
+    NS_LOG_FUNCTION(this);
+    if (!NoteCourseChange(event.nodeId, event.position))
+    {
+        return;
+    }
+
+    QueuePosition(event.nodeId, event.position, orientation);
+}
+
+void
+Orchestrator::HandleUnwrittenCourseChange(uint32_t nodeId, const Vector3D& lastPosition)
+{
+    NS_LOG_FUNCTION(this << nodeId << lastPosition);
+    NoteCourseChange(nodeId, lastPosition);
+}
+
+bool
+Orchestrator::NoteCourseChange(uint32_t nodeId, const Vector3D& lastPosition)
+{
+    // The Node records this position regardless of if it's written,
+    // so polls must compare against it as well
+    if (const auto bucket = FindMobilityPollBucket(nodeId))
+    {
+        bucket->index.SetLastPosition(nodeId, lastPosition);
+    }
+
+    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+    {
+        NS_LOG_DEBUG("HandleCourseChange() Activated outside (StartTime, StopTime), Ignoring");
+        return false;
+    }
+    else if (!m_simulationStarted)
+    {
+        NS_LOG_DEBUG("HandleCourseChange() Activated before simulation started, Ignoring");
+        return false;
+    }
+
+    if (m_pollMobility && m_adaptiveMobilityPolling)
+    {
+        // The Node's velocity may have changed, so its prediction is stale
+        WakeMobilityPoll(nodeId);
+    }
+
+    return true;
+}
+
+void
+Orchestrator::HandlePositionChange(const DecorationMoveEvent& event)
+{
+    NS_LOG_FUNCTION(this);
+    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+    {
+        NS_LOG_DEBUG("HandlePositionChange() Activated outside (StartTime, StopTime), Ignoring");
+        return;
+    }
+    else if (!m_simulationStarted)
+    {
+        NS_LOG_DEBUG("HandleCourseChange() Activated before simulation started, Ignoring");
+        return;
+    }
+
+    if (m_currentSection != Section::Events)
+    {
+        // We'll get the final orientation when we write the head info
+        NS_LOG_DEBUG("DecorationMoveEvent ignored. Not in Events section");
+        return;
+    }
+
+    WriteEvent(event);
+}
+
+void
+Orchestrator::HandleModelChange(const NodeModelChangeEvent& event)
+{
+    NS_LOG_FUNCTION(this);
+    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+    {
+        NS_LOG_DEBUG("HandleModelChange() Activated outside (StartTime, StopTime), Ignoring");
+        return;
+    }
+    else if (!m_simulationStarted)
+    {
+        NS_LOG_DEBUG("HandleModelChange() Activated before simulation started, Ignoring");
+        return;
+    }
+
+    if (m_currentSection != Section::Events)
+    {
+        // We'll get the final model when we write the head info
+        NS_LOG_DEBUG("NodeModelChangeEvent ignored. Not in Events section");
+        return;
+    }
+
+    WriteEvent(event);
+}
+
+void
+Orchestrator::HandleOrientationChange(const NodeOrientationChangeEvent& event)
+{
+    NS_LOG_FUNCTION(this);
+    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+    {
+        NS_LOG_DEBUG("HandleOrientationChange() Activated outside (StartTime, StopTime), Ignoring");
+        return;
+    }
+
+    if (m_currentSection != Section::Events)
+    {
+        // We'll get the final orientation when we write the head info
+        NS_LOG_DEBUG("NodeOrientationChangeEvent ignored. Not in Events section");
+        return;
+    }
+
+    if (!InRegionOfInterest(event.nodeId))
+    {
+        NS_LOG_DEBUG("NodeOrientationChangeEvent ignored. Node outside every region of interest");
+        return;
+    }
+
+    if (m_frameMode)
+    {
+        QueueOrientation(event.nodeId, event.orientation);
+        return;
+    }
+
+    WriteEvent(event);
+}
+
+void
+Orchestrator::HandleOrientationChange(const DecorationOrientationChangeEvent& event)
+{
+    NS_LOG_FUNCTION(this);
+    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+    {
+        NS_LOG_DEBUG("HandleOrientationChange() Activated outside (StartTime, StopTime), Ignoring");
+        return;
+    }
+
+    if (m_currentSection != Section::Events)
+    {
+        // We'll get the final orientation when we write the head info
+        NS_LOG_DEBUG("DecorationOrientationChangeEvent ignored. Not in Events section");
+        return;
+    }
+
+    WriteEvent(event);
+}
+
+void
+Orchestrator::HandleColorChange(const NodeColorChangeEvent& event)
+{
+    NS_LOG_FUNCTION(this);
+    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+    {
+        NS_LOG_DEBUG("HandleColorChange() Activated outside (StartTime, StopTime), Ignoring");
+        return;
+    }
+
+    if (m_currentSection != Section::Events)
+    {
+        // We'll get the final color when we write the head info
+        NS_LOG_DEBUG("NodeColorChangeEvent ignored. Not in Events section");
+        return;
+    }
+
+    WriteEvent(event);
+}
+
+void
+Orchestrator::HandleVisibilityChange(const NodeVisibilityChangeEvent& e)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+    {
+        NS_LOG_DEBUG("HandleVisibilityChange() Activated outside [StartTime, StopTime], Ignoring");
+        return;
+    }
+
+    WriteEvent(e);
+}
+
+void
+Orchestrator::HandleTransmit(const TransmitEvent& event)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (Simulator::Now() < m_startTime || Simulator::Now() > m_stopTime)
+    {
+        NS_LOG_DEBUG("HandleTransmit() Activated outside (StartTime, StopTime), Ignoring");
+        return;
+    }
+
+    if (!InRegionOfInterest(event.nodeId))
+    {
+        NS_LOG_DEBUG("TransmitEvent ignored. Node outside every region of interest");
+        return;
+    }
+
+    WriteEvent(event);
+}
+
+uint32_t
+Orchestrator::Register(Ptr<Decoration> decoration)
+{
+    NS_LOG_FUNCTION(this << decoration);
     m_decorations.emplace_back(decoration);
 
     // Just in case
@@ -1235,6 +2141,14 @@ Orchestrator::Register(Ptr<NodeConfiguration> nodeConfiguration)
 {
     NS_LOG_FUNCTION(this << nodeConfiguration);
     m_nodes.emplace_back(nodeConfiguration);
+    m_mobilityIndexDirty = true;
+}
+
+void
+Orchestrator::HandleMobilityPollChange(void)
+{
+    NS_LOG_FUNCTION(this);
+    m_mobilityIndexDirty = true;
 }
 
 void
@@ -1267,7 +2181,62 @@ Orchestrator::Register(Ptr<RectangularArea> area)
     NS_LOG_FUNCTION(this << area);
     m_areas.emplace_back(area);
 
-    return static_cast<uint32_t>(m_areas.size());
+    return static_cast<uint32_t>(m_areas.size());
+}
+
+std::shared_ptr<SinkClock>
+Orchestrator::GetSinkClock(Time interval)
+{
+    NS_LOG_FUNCTION(this << interval);
+    auto& clock = m_sinkClocks[interval];
+    if (!clock)
+    {
+        clock = std::make_shared<SinkClock>(interval);
+        clock->SetWindow(m_startTime, m_stopTime);
+    }
+
+    return clock;
+}
+
+void
+Orchestrator::AddRegionOfInterest(Ptr<RectangularArea> area)
+{
+    NS_LOG_FUNCTION(this << area);
+    NS_ABORT_MSG_IF(m_simulationStarted,
+                    "Regions of interest must be added before the simulation starts");
+    m_regionsOfInterest.emplace_back(area);
+}
+
+Ptr<XYSeries>
+Orchestrator::AddGeofence(Ptr<RectangularArea> area)
+{
+    NS_LOG_FUNCTION(this << area);
+    NS_ABORT_MSG_IF(m_simulationStarted, "Geofences must be added before the simulation starts");
+
+    UintegerValue id;
+    area->GetAttribute("Id", id);
+    const auto areaId = static_cast<uint32_t>(id.Get());
+
+    auto& geofence = m_geofences[areaId];
+    if (geofence.occupancy)
+    {
+        NS_LOG_WARN("Area [ID: " << areaId << "] is already a geofence");
+        return geofence.occupancy;
+    }
+    geofence.area = area;
+
+    StringValue name;
+    area->GetAttribute("Name", name);
+
+    geofence.occupancy = CreateObject<XYSeries>(this);
+    geofence.occupancy->SetAttribute(
+        "Name",
+        StringValue("Occupancy: " +
+                    (name.Get().empty() ? "Area " + std::to_string(areaId) : name.Get())));
+    geofence.occupancy->GetXAxis()->SetAttribute("Name", StringValue("Time (s)"));
+    geofence.occupancy->GetYAxis()->SetAttribute("Name", StringValue("Nodes"));
+
+    return geofence.occupancy;
 }
 
 void
@@ -1614,13 +2583,7 @@ Orchestrator::AppendXyValue(uint32_t id, double x, double y)
         return;
     }
 
-    nlohmann::json element;
-    element["type"] = "xy-series-append";
-    element["nanoseconds"] = Simulator::Now().GetNanoSeconds();
-    element["series-id"] = id;
-    element["x"] = x;
-    element["y"] = y;
-    m_document["events"].emplace_back(element);
+    WriteEvent(XYSeriesAppendEvent{Simulator::Now(), id, x, y});
 }
 
 void
@@ -1634,22 +2597,7 @@ Orchestrator::AppendXyValues(uint32_t id, const std::vector<XYPoint>& points)
         return;
     }
 
-    nlohmann::json element;
-    element["type"] = "xy-series-append-array";
-    element["nanoseconds"] = Simulator::Now().GetNanoSeconds();
-    element["series-id"] = id;
-
-    auto elementArray = nlohmann::json::array();
-    for (const auto& point : points)
-    {
-        elementArray.emplace_back(nlohmann::json{
-            {"x", point.x},
-            {"y", point.y},
-        });
-    }
-
-    element["points"] = elementArray;
-    m_document["events"].emplace_back(element);
+    WriteEvent(XYSeriesAppendArrayEvent{Simulator::Now(), id, points});
 }
 
 void
@@ -1663,11 +2611,7 @@ Orchestrator::ClearXySeries(uint32_t id)
         return;
     }
 
-    nlohmann::json element;
-    element["type"] = "xy-series-clear";
-    element["nanoseconds"] = Simulator::Now().GetNanoSeconds();
-    element["series-id"] = id;
-    m_document["events"].emplace_back(element);
+    WriteEvent(XYSeriesClearEvent{Simulator::Now(), id});
 }
 
 void
@@ -1680,13 +2624,7 @@ Orchestrator::AppendCategoryValue(uint32_t id, int category, double value)
         return;
     }
 
-    nlohmann::json element;
-    element["type"] = "category-series-append";
-    element["nanoseconds"] = Simulator::Now().GetNanoSeconds();
-    element["series-id"] = id;
-    element["category"] = category;
-    element["value"] = value;
-    m_document["events"].emplace_back(element);
+    WriteEvent(CategorySeriesAppendEvent{Simulator::Now(), id, category, value});
 }
 
 void
@@ -1699,13 +2637,7 @@ Orchestrator::WriteLogMessage(const LogMessageEvent& event)
         return;
     }
 
-    nlohmann::json element;
-    element["nanoseconds"] = Simulator::Now().GetNanoSeconds();
-    element["type"] = "stream-append";
-    element["stream-id"] = event.id;
-    element["data"] = event.message;
-
-    m_document["events"].emplace_back(element);
+    WriteEvent(LogMessageEvent{Simulator::Now(), event.id, event.message});
 }
 
 void
@@ -1723,16 +2655,13 @@ Orchestrator::CreateLink(const LogicalLink& link)
         return;
     }
 
-    nlohmann::json element;
-    element["nanoseconds"] = Simulator::Now().GetNanoSeconds();
-    element["type"] = "logical-link-create";
-    element["link-id"] = link.GetId();
-    element["nodes"] = link.GetNodes();
-    element["active"] = link.IsActive();
-    element["color"] = colorToObject(link.GetColor());
-    element["diameter"] = link.GetDiameter();
-
-    m_document["events"].emplace_back(element);
+    WriteEvent(LogicalLinkEvent{Simulator::Now(),
+                                LogicalLinkEvent::EventType::Create,
+                                link.GetId(),
+                                link.GetNodes(),
+                                link.IsActive(),
+                                link.GetColor(),
+                                link.GetDiameter()});
 }
 
 void
@@ -1750,28 +2679,51 @@ Orchestrator::UpdateLink(const LogicalLink& link)
         return;
     }
 
-    nlohmann::json element;
-    element["nanoseconds"] = Simulator::Now().GetNanoSeconds();
-    element["type"] = "logical-link-update";
-    element["link-id"] = link.GetId();
-    element["nodes"] = link.GetNodes();
-    element["active"] = link.IsActive();
-    element["color"] = colorToObject(link.GetColor());
-    element["diameter"] = link.GetDiameter();
-
-    m_document["events"].emplace_back(element);
+    WriteEvent(LogicalLinkEvent{Simulator::Now(),
+                                LogicalLinkEvent::EventType::Update,
+                                link.GetId(),
+                                link.GetNodes(),
+                                link.IsActive(),
+                                link.GetColor(),
+                                link.GetDiameter()});
 }
 
 void
 Orchestrator::Flush(void)
 {
     NS_LOG_FUNCTION(this);
+    // The writer thread owns the file until it finishes. Stop it first,
+    // so the events written below go straight into the stream, rather than
+    // through the queue, which may be full, or be consumed by this thread
+    // (if this was reached from the crash handler on the writer thread)
+    StopWriterThread();
+
+    // Positions from the final time step (or frame) may not have been written yet
+    if (m_pendingPositionsEvent.has_value())
+    {
+        Simulator::Cancel(m_pendingPositionsEvent.value());
+        m_pendingPositionsTime = std::min(m_pendingPositionsTime, Simulator::Now());
+        WritePendingPositions();
+    }
+
+    // Motion since the last segment ended is still held
+    FinishTrajectories();
+
+    // No more events are coming, so everything held is in order
+    DrainReorderBuffer();
+
     if (!m_file.is_open() || !m_file.good())
     {
         NS_LOG_DEBUG("Flush() called on closed file");
         return;
     }
 
+    if (m_lateEvents > 0u)
+    {
+        NS_LOG_WARN(m_lateEvents << " event(s) arrived too late to be written in time order, "
+                                    "consider increasing `ReorderWindow`");
+    }
+
     // Make all models are in the document
     CommitAll();
 
@@ -1780,8 +2732,445 @@ Orchestrator::Flush(void)
     m_document["configuration"]["max-time"] =
         std::min(m_stopTime.GetNanoSeconds(), Simulator::Now().GetNanoSeconds());
 
-    m_file << m_document;
+    if (!m_streaming)
+    {
+        ApplyCompression();
+
+        // Write the document in the same order `nlohmann::json` would,
+        // but serialize the events one at a time, rather than
+        // converting them all at once
+        m_file << '{';
+        auto first = true;
+        for (const auto& [key, value] : m_document.items())
+        {
+            if (!first)
+            {
+                m_file << ',';
+            }
+            first = false;
+
+            m_file << '"' << key << "\":";
+            if (key == "events")
+            {
+                m_file << '[';
+                WriteStoredEvents();
+                m_file << ']';
+            }
+            else if (key == "keyframes")
+            {
+                // Only complete once the events are written
+                m_file << GetKeyframeIndex();
+            }
+            else
+            {
+                m_file << value;
+            }
+        }
+        m_file << '}';
+        m_file.close();
+        return;
+    }
+
+    if (m_document.contains("keyframes"))
+    {
+        m_document["keyframes"] = GetKeyframeIndex();
+    }
+    if (m_droppedEvents > 0u)
+    {
+        NS_LOG_WARN("Dropped " << m_droppedEvents
+                               << " event(s) due to a full writer queue, "
+                                  "consider increasing `AsyncQueueSize`");
+    }
+
+    if (m_binaryOutput)
+    {
+        auto trailer = nlohmann::json::object();
+        for (const auto& [key, value] : m_document.items())
+        {
+            if (key != "events")
+            {
+                trailer[key] = value;
+            }
+        }
+
+        m_binaryOutput->Finish(trailer);
+        m_binaryOutput.reset();
+        m_file.close();
+        m_streaming = false;
+        return;
+    }
+
+    FlushStreamBuffer();
+    m_file << ']';
+
+    // Everything that could have changed while the events were written
+    for (const auto& [key, value] : m_document.items())
+    {
+        if (key == "events")
+        {
+            continue;
+        }
+        m_file << ",\"" << key << "\":" << value;
+    }
+
+    m_file << '}';
     m_file.close();
+    m_streaming = false;
+}
+
+void
+Orchestrator::WriteEvent(EventRecord&& event)
+{
+    if (m_reorderWindow.IsZero())
+    {
+        DispatchEvent(std::move(event));
+        return;
+    }
+
+    if (!m_reorderBuffer)
+    {
+        m_reorderBuffer = std::make_unique<EventReorderBuffer>(m_reorderWindow.GetNanoSeconds());
+    }
+
+    if (!m_reorderBuffer->Push(std::move(event)))
+    {
+        m_lateEvents++;
+        if (m_lateEventPolicy == LateEventPolicy::WriteLate)
+        {
+            DispatchEvent(std::move(event));
+        }
+        return;
+    }
+
+    EventRecord ready;
+    while (m_reorderBuffer->PopReady(ready))
+    {
+        DispatchEvent(std::move(ready));
+    }
+}
+
+void
+Orchestrator::DispatchEvent(EventRecord&& event)
+{
+    if (m_writerThread.joinable())
+    {
+        PushToWriter(std::move(event));
+        return;
+    }
+
+    if (m_spillBuffer)
+    {
+        m_spillBuffer->Add(std::move(event));
+        return;
+    }
+
+    if (!m_streaming)
+    {
+        m_events.emplace_back(std::move(event));
+        return;
+    }
+
+    AppendToStream(event);
+}
+
+void
+Orchestrator::DrainReorderBuffer(void)
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_reorderBuffer)
+    {
+        return;
+    }
+
+    EventRecord event;
+    while (m_reorderBuffer->Pop(event))
+    {
+        DispatchEvent(std::move(event));
+    }
+}
+
+void
+Orchestrator::AppendToStream(const EventRecord& event)
+{
+    if (const auto keyframe = std::get_if<KeyframeEvent>(&event))
+    {
+        m_keyframeIndex.push_back({keyframe->time.GetNanoSeconds(), m_writtenEventCount});
+    }
+    m_writtenEventCount++;
+
+    if (m_binaryOutput)
+    {
+        m_binaryOutput->Write(event);
+        return;
+    }
+
+    if (m_firstStreamEvent)
+    {
+        m_firstStreamEvent = false;
+    }
+    else
+    {
+        m_streamBuffer.push_back(',');
+    }
+    JsonEventEmitter{m_streamBuffer}.Write(event);
+
+    if (m_streamBuffer.size() >= m_streamBufferSize)
+    {
+        FlushStreamBuffer();
+    }
+}
+
+void
+Orchestrator::WriteStoredEvents(void)
+{
+    NS_LOG_FUNCTION(this);
+    if (m_spillBuffer)
+    {
+        m_spillBuffer->Merge([this](const EventSpillBuffer::SortedEvent& event) {
+            if (event.keyframe)
+            {
+                m_keyframeIndex.push_back({event.nanoseconds, m_writtenEventCount});
+            }
+            m_writtenEventCount++;
+
+            if (m_firstStreamEvent)
+            {
+                m_firstStreamEvent = false;
+            }
+            else
+            {
+                m_streamBuffer.push_back(',');
+            }
+            m_streamBuffer.append(event.json);
+
+            if (m_streamBuffer.size() >= m_streamBufferSize)
+            {
+                FlushStreamBuffer();
+            }
+        });
+        m_spillBuffer.reset();
+    }
+
+    while (!m_events.empty())
+    {
+        AppendToStream(m_events.front());
+        m_events.pop_front();
+    }
+
+    FlushStreamBuffer();
+}
+
+void
+Orchestrator::WriteStreamHeader(void)
+{
+    NS_LOG_FUNCTION(this);
+    // These may still be appended to after the simulation starts,
+    // so they're written when we close the document in `Flush()`
+    const std::vector<std::string> deferredSections{"configuration",
+                                                    "events",
+                                                    "keyframes",
+                                                    "series",
+                                                    "streams"};
+
+    // The header sections could be large (e.g. thousands of Nodes),
+    // so move them out of the document, rather than keeping a second copy around
+    auto header = nlohmann::json::object();
+    for (auto it = m_document.begin(); it != m_document.end(); ++it)
+    {
+        if (std::find(deferredSections.begin(), deferredSections.end(), it.key()) ==
+            deferredSections.end())
+        {
+            header[it.key()] = std::move(it.value());
+        }
+    }
+    for (const auto& [key, value] : header.items())
+    {
+        m_document.erase(key);
+    }
+
+    ApplyCompression();
+    if (m_outputFormat == OutputFormat::Binary)
+    {
+        const auto encoding = m_binaryEncoding == BinaryEncoding::Delta
+                                  ? BinaryFormat::Encoding::Delta
+                                  : BinaryFormat::Encoding::Raw;
+        m_binaryOutput = std::make_unique<BinaryOutputWriter>(m_file,
+                                                              m_binaryBlockSize,
+                                                              encoding,
+                                                              m_positionResolution);
+        m_binaryOutput->WriteHeader(header);
+    }
+    else
+    {
+        m_file << '{';
+        for (const auto& [key, value] : header.items())
+        {
+            m_file << '"' << key << "\":" << value << ',';
+        }
+        m_file << "\"events\":[";
+        m_streamBuffer.reserve(m_streamBufferSize);
+    }
+
+    m_streaming = true;
+
+    // Move any events which occurred before the header was written
+    // into the stream, so they're kept in order
+    WriteStoredEvents();
+}
+
+void
+Orchestrator::FlushStreamBuffer(void)
+{
+    m_file.write(m_streamBuffer.data(), static_cast<std::streamsize>(m_streamBuffer.size()));
+    m_streamBuffer.clear();
+}
+
+void
+Orchestrator::ApplyCompression(void)
+{
+    NS_LOG_FUNCTION(this);
+    auto compression = OutputFile::CompressionFromPath(m_outputPath);
+    switch (m_compression)
+    {
+    case OutputCompression::Auto:
+        break;
+    case OutputCompression::None:
+        compression = OutputFile::Compression::None;
+        break;
+    case OutputCompression::Gzip:
+        compression = OutputFile::Compression::Gzip;
+        break;
+    case OutputCompression::Zstd:
+        compression = OutputFile::Compression::Zstd;
+        break;
+    }
+
+    m_file.SetCompression(compression,
+                          static_cast<int>(m_compressionLevel),
+                          m_compressionFrameSize,
+                          m_compressionThread);
+}
+
+nlohmann::json
+Orchestrator::GetKeyframeIndex(void) const
+{
+    auto index = nlohmann::json::array();
+    for (const auto& entry : m_keyframeIndex)
+    {
+        index.push_back({{"event", entry.event}, {"nanoseconds", entry.nanoseconds}});
+    }
+
+    return index;
+}
+
+void
+Orchestrator::StartWriterThread(void)
+{
+    NS_LOG_FUNCTION(this);
+    m_writerQueue = std::make_unique<SpscRingBuffer<EventRecord>>(m_asyncQueueSize);
+    m_stopWriter.store(false, std::memory_order_relaxed);
+    m_writerThread = std::thread(&Orchestrator::RunWriter, this);
+}
+
+void
+Orchestrator::StopWriterThread(void)
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_writerThread.joinable())
+    {
+        return;
+    }
+
+    m_stopWriter.store(true, std::memory_order_release);
+
+    // Reached from the crash handler on the writer thread itself,
+    // which cannot join itself. This thread is already the consumer
+    // of `m_writerQueue`, so write what is left from here
+    if (m_writerThread.get_id() == std::this_thread::get_id())
+    {
+        m_writerThread.detach();
+
+        EventRecord event;
+        while (m_writerQueue->TryPop(event))
+        {
+            AppendToStream(event);
+        }
+        FlushStreamBuffer();
+
+        // The interrupted loop in `RunWriter()` still reads the queue
+        // if the crash handler returns, so it is kept
+        return;
+    }
+
+    m_writerThread.join();
+    m_writerQueue.reset();
+}
+
+void
+Orchestrator::RunWriter(void)
+{
+    EventRecord event;
+    while (true)
+    {
+        // Check before draining, so no event pushed
+        // before the stop signal is missed
+        const auto stopping = m_stopWriter.load(std::memory_order_acquire);
+
+        auto wroteEvent = false;
+        while (m_writerQueue->TryPop(event))
+        {
+            AppendToStream(event);
+            wroteEvent = true;
+        }
+
+        if (stopping)
+        {
+            break;
+        }
+
+        // Don't spin on an idle queue
+        if (!wroteEvent)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    FlushStreamBuffer();
+}
+
+void
+Orchestrator::PushToWriter(EventRecord&& event)
+{
+    if (m_writerQueue->TryPush(event))
+    {
+        return;
+    }
+
+    if (m_backpressurePolicy == BackpressurePolicy::Drop)
+    {
+        m_droppedEvents++;
+        return;
+    }
+
+    // Block until the writer catches up
+    while (!m_writerQueue->TryPush(event))
+    {
+        std::this_thread::yield();
+    }
+}
+
+uint64_t
+Orchestrator::GetDroppedEventCount(void) const
+{
+    NS_LOG_FUNCTION(this);
+    return m_droppedEvents;
+}
+
+uint64_t
+Orchestrator::GetLateEventCount(void) const
+{
+    NS_LOG_FUNCTION(this);
+    return m_lateEvents;
 }
 
 void
@@ -1818,8 +3207,8 @@ Orchestrator::Init()
     m_document["series"] = nlohmann::json::array();
     m_document["streams"] = nlohmann::json::array();
 
-    // Create the Empty events array, so we can just append to that
-    // when the event happens
+    // Create the Empty events array, so it keeps its place
+    // in the document. Events are stored separately until they're written
     m_document["events"] = nlohmann::json::array();
 
     Simulator::ScheduleNow(&Orchestrator::SetupSimulation, this);
@@ -1845,8 +3234,7 @@ Orchestrator::SetTimeStepCompat(const std::optional<int>& milliseconds)
     }
     else
     {
-        m_timeStep.reset();
-        m_timeStepGranularity.reset();
+        ClearTimeStep();
     }
 }
 
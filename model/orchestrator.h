@@ -34,15 +34,24 @@
 #ifndef ORCHESTRATOR_H
 #define ORCHESTRATOR_H
 
+#include "area-tracker.h"
+#include "binary-output.h"
 #include "building-configuration.h"
 #include "category-value-series.h"
 #include "decoration.h"
 #include "event-message.h"
+#include "event-reorder-buffer.h"
+#include "event-spill-buffer.h"
 #include "logical-link.h"
+#include "mobility-index.h"
 #include "node-configuration.h"
 #include "optional.h"
+#include "output-file.h"
 #include "rectangular-area.h"
 #include "series-collection.h"
+#include "sink-clock.h"
+#include "spsc-ring-buffer.h"
+#include "trajectory-simplifier.h"
 #include "value-axis.h"
 #include "xy-series.h"
 
@@ -54,10 +63,16 @@
 #include "ns3/simulator.h"
 #include <ns3/json.hpp>
 
+#include <atomic>
+#include <cstdint>
+#include <deque>
 #include <fstream>
 #include <functional>
+#include <map>
+#include <memory>
 #include <optional>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -71,7 +86,6 @@ class BuildingConfiguration;
 class LogStream;
 class LogicalLink;
 class SeriesCollection;
-struct XYPoint;
 class XYSeries;
 class CategoryValueSeries;
 class ValueAxis;
@@ -101,6 +115,93 @@ class Orchestrator : public ns3::Object
         On
     };
 
+    /**
+     * What to do with an event when `AsyncOutput` is enabled
+     * and the queue to the writer thread is full.
+     *
+     * `Block`: Wait on the simulation thread until the writer thread
+     * makes room in the queue. No events are lost
+     *
+     * `Drop`: Discard the event, and count it.
+     * See `GetDroppedEventCount()`
+     */
+    enum BackpressurePolicy : int
+    {
+        Block,
+        Drop
+    };
+
+    /**
+     * What to do with an event which arrives more than
+     * `ReorderWindow` behind the latest event, once
+     * later events have already been written.
+     *
+     * `Drop`: Discard the event, and count it.
+     * The output is always in time order
+     *
+     * `Write`: Write the event immediately, out of order, and count it.
+     *
+     * See `GetLateEventCount()`
+     */
+    enum LateEventPolicy : int
+    {
+        DropLate,
+        WriteLate
+    };
+
+    /**
+     * Format of the output file.
+     *
+     * `Json`: The JSON document read by the application
+     *
+     * `Binary`: A compact binary container, with events stored in columns.
+     * Must be converted to `Json` with `netsimulyzer-binary-to-json`
+     * before it is loaded by the application
+     *
+     * @see BinaryFormat
+     */
+    enum OutputFormat : int
+    {
+        Json,
+        Binary
+    };
+
+    /**
+     * Encoding of the columns in `OutputFormat::Binary` output.
+     *
+     * `Raw`: Fixed width, little endian values
+     *
+     * `Delta`: Variable length integers, coded as the difference
+     * from the previous value for the same Node or series
+     *
+     * @see BinaryFormat::Encoding
+     */
+    enum BinaryEncoding : int
+    {
+        Raw,
+        Delta
+    };
+
+    /**
+     * Compression of the output file.
+     *
+     * `Auto`: Select from the file extension,
+     * `Gzip` for `.gz`, `Zstd` for `.zst`, otherwise `None`
+     *
+     * `None`: Write the file uncompressed
+     *
+     * `Gzip`: Compress with gzip. Requires zlib
+     *
+     * `Zstd`: Compress with Zstandard. Requires libzstd
+     */
+    enum OutputCompression : int
+    {
+        Auto,
+        None,
+        Gzip,
+        Zstd
+    };
+
     /**
      * @brief Constructs an Orchestrator and opens an output handle at output_path
      *
@@ -122,6 +223,11 @@ class Orchestrator : public ns3::Object
      */
     explicit Orchestrator(MemoryOutputMode mode);
 
+    /**
+     * Stops the writer thread, if it is still running
+     */
+    ~Orchestrator(void) override;
+
     /**
      * @brief Get the class TypeId
      *
@@ -142,11 +248,14 @@ class Orchestrator : public ns3::Object
      * `Unit::MS` (Milliseconds)
      * `Unit::US` (Microseconds)
      * `Unit::NS` (Nanoseconds)
+     *
+     * Aborts if called after the simulation starts with `FrameMode` on
      */
     void SetTimeStep(Time step, Time::Unit granularity);
 
     /**
-     * Unsets the time step set by `SetTimeStep`
+     * Unsets the time step set by `SetTimeStep`.
+     * Aborts if called after the simulation starts with `FrameMode` on
      */
     void ClearTimeStep(void);
 
@@ -179,6 +288,31 @@ class Orchestrator : public ns3::Object
      */
     const nlohmann::json& GetJson() const;
 
+    /**
+     * Gets the number of events discarded because the queue
+     * to the writer thread was full.
+     *
+     * Only incremented when `AsyncOutput` is enabled
+     * and the `AsyncBackpressure` attribute is `Drop`
+     *
+     * @return
+     * The number of events which were not written
+     */
+    uint64_t GetDroppedEventCount(void) const;
+
+    /**
+     * Gets the number of events which arrived too late
+     * to be written in time order.
+     *
+     * Only incremented when the `ReorderWindow` attribute is set
+     *
+     * @return
+     * The number of late events
+     *
+     * @see LateEventPolicy
+     */
+    uint64_t GetLateEventCount(void) const;
+
     /**
      * @brief Collect Global & Node/Building configs, Schedule Polls
      *
@@ -210,6 +344,51 @@ class Orchestrator : public ns3::Object
      */
     bool GetPollMobility(void) const;
 
+    /**
+     * Set how often Nodes without their own `MobilityPollInterval` are polled.
+     * Takes effect after the next poll
+     *
+     * @param interval
+     * The time between polls
+     */
+    void SetMobilityPollInterval(Time interval);
+
+    /**
+     * @return
+     * How often Nodes without their own `MobilityPollInterval` are polled
+     */
+    Time GetMobilityPollInterval(void) const;
+
+    /**
+     * Set the beginning of the window to write trace information.
+     * Sink clocks are suspended until then
+     *
+     * @param start
+     * The first time output is written
+     */
+    void SetStartTime(Time start);
+
+    /**
+     * @return
+     * The beginning of the window to write trace information
+     */
+    Time GetStartTime(void) const;
+
+    /**
+     * Set the end of the window to write trace information.
+     * Sink clocks are suspended after then
+     *
+     * @param stop
+     * The last time output is written
+     */
+    void SetStopTime(Time stop);
+
+    /**
+     * @return
+     * The end of the window to write trace information
+     */
+    Time GetStopTime(void) const;
+
     /**
      * @brief Writes positions of configured Nodes
      *
@@ -218,6 +397,14 @@ class Orchestrator : public ns3::Object
      */
     void PollMobility(void);
 
+    /**
+     * @brief Writes a keyframe with the current state of every
+     * Node, Decoration, & Logical Link, then schedules the next one
+     *
+     * @see KeyframeEvent
+     */
+    void WriteKeyframe(void);
+
     /**
      * @brief Trace sink for the 'CourseChange' trace. Writes the event info to the output.
      *
@@ -225,8 +412,22 @@ class Orchestrator : public ns3::Object
      * and writes the event information to the output
      *
      * @param event The event information from the triggered 'CourseChange' event
+     * @param orientation The Node's new orientation, if it turned along with the course change
      */
-    void HandleCourseChange(const CourseChangeEvent& event);
+    void HandleCourseChange(const CourseChangeEvent& event,
+                            const std::optional<Vector3D>& orientation = {});
+
+    /**
+     * Receives a 'CourseChange' trace the NodeConfiguration did not write,
+     * because it was within the `PositionTolerance` or held by `MinCourseChangeInterval`.
+     *
+     * The Node's velocity may still have changed, so adaptive mobility polling
+     * is woken for it
+     *
+     * @param nodeId The ID of the Node which changed course
+     * @param lastPosition The last position written for the Node
+     */
+    void HandleUnwrittenCourseChange(uint32_t nodeId, const Vector3D& lastPosition);
 
     /**
      * Trace sink for when a Decoration's position changes.
@@ -307,6 +508,15 @@ class Orchestrator : public ns3::Object
      */
     void Register(Ptr<NodeConfiguration> nodeConfiguration);
 
+    /**
+     * Called by a registered NodeConfiguration when something the mobility
+     * polls are built from changes, such as its `PositionTolerance`,
+     * or when it gains a Mobility Model.
+     *
+     * The polls are rebuilt before the next one happens
+     */
+    void HandleMobilityPollChange(void);
+
     /**
      * @brief Register a Building to be tracked.
      *
@@ -404,6 +614,47 @@ class Orchestrator : public ns3::Object
      */
     uint32_t Register(Ptr<RectangularArea> area);
 
+    /**
+     * Get the clock shared by every sink writing on `interval`,
+     * creating it if this is the first sink with that interval.
+     * The clock only runs between the `StartTime` & `StopTime`
+     *
+     * @param interval
+     * The time between writes. Must be positive
+     *
+     * @return
+     * The clock for `interval`
+     */
+    std::shared_ptr<SinkClock> GetSinkClock(Time interval);
+
+    /**
+     * Only write the positions, orientations, & transmissions
+     * of Nodes inside `area`, or any other region of interest.
+     * Writes an 'area-enter' or 'area-exit' event
+     * each time a Node crosses the bounds of a region.
+     *
+     * Must be called before the simulation starts
+     *
+     * @param area
+     * The region of interest. Should be registered to this Orchestrator
+     */
+    void AddRegionOfInterest(Ptr<RectangularArea> area);
+
+    /**
+     * Track the Nodes inside `area`, writing an 'area-enter' or 'area-exit'
+     * event each time a Node crosses its bounds. The number of Nodes inside
+     * is appended to the returned series each time it changes.
+     *
+     * Must be called before the simulation starts
+     *
+     * @param area
+     * The area to track. Should be registered to this Orchestrator
+     *
+     * @return
+     * The number of Nodes inside `area` over time
+     */
+    Ptr<XYSeries> AddGeofence(Ptr<RectangularArea> area);
+
     /**
      * Commit a series created while the simulation is running.
      *
@@ -579,6 +830,318 @@ class Orchestrator : public ns3::Object
      */
     void Init();
 
+    /**
+     * Adds an event to the output. If `ReorderWindow` is set,
+     * the event is held until it may be written in time order,
+     * then passed to `DispatchEvent()`
+     *
+     * @param event
+     * The event to write
+     */
+    void WriteEvent(EventRecord&& event);
+
+    /**
+     * Either stores `event` until the output is written, or,
+     * if `StreamOutput` is enabled, serializes it into the stream buffer
+     *
+     * @param event
+     * The event to write
+     */
+    void DispatchEvent(EventRecord&& event);
+
+    /**
+     * Dispatch every event held for reordering, in time order
+     */
+    void DrainReorderBuffer(void);
+
+    /**
+     * Nodes polled on the same interval, with a single scheduled poll for all of them
+     */
+    struct MobilityPollBucket
+    {
+        /**
+         * Cached mobility models & last positions of the Nodes in this bucket
+         */
+        MobilityIndex index;
+
+        /**
+         * The next poll of this bucket. Unset if no poll is scheduled
+         */
+        std::optional<EventId> event;
+
+        /**
+         * Time of the last poll of this bucket, unset if it has not been polled
+         */
+        std::optional<Time> lastPoll;
+    };
+
+    /**
+     * The latest position of a Node at the current time,
+     * or during the current frame in `FrameMode`, not yet written
+     */
+    struct PendingPosition
+    {
+        /**
+         * The last position given for the Node at this time.
+         * Only unset in `FrameMode`, if just the orientation changed
+         */
+        std::optional<Vector3D> position;
+
+        /**
+         * The last orientation given for the Node at this time, if any
+         */
+        std::optional<Vector3D> orientation;
+    };
+
+    /**
+     * Hold `position` as the Node's position at the current time,
+     * replacing any other position given for it at this time.
+     * Written once every position for the current time is known
+     *
+     * @param nodeId
+     * The ID of the Node which moved
+     *
+     * @param position
+     * The Node's new position
+     *
+     * @param orientation
+     * The Node's new orientation, if it turned along with the position
+     */
+    void QueuePosition(uint32_t nodeId,
+                       const Vector3D& position,
+                       const std::optional<Vector3D>& orientation);
+
+    /**
+     * Hold `orientation` as the Node's orientation in the current frame,
+     * replacing any other orientation given for it. Only used in `FrameMode`
+     *
+     * @param nodeId
+     * The ID of the Node which turned
+     *
+     * @param orientation
+     * The Node's new orientation
+     */
+    void QueueOrientation(uint32_t nodeId, const Vector3D& orientation);
+
+    /**
+     * Schedule `WritePendingPositions()`, if it is not already.
+     * After every other event at the current time, or at the end
+     * of the current frame in `FrameMode`
+     */
+    void SchedulePendingPositions(void);
+
+    /**
+     * Write the position held for each Node by `QueuePosition()`, in Node ID order.
+     * In `FrameMode`, they are written as a single `NodeFrameEvent`
+     */
+    void WritePendingPositions(void);
+
+    /**
+     * Index the bounds of every region of interest,
+     * & find which regions each Node starts in
+     */
+    void BuildRegionsOfInterest(void);
+
+    /**
+     * Move the Node with `nodeId` within the regions of interest,
+     * writing an event for each region it enters or exits
+     *
+     * @param nodeId
+     * The ID of the Node which moved
+     *
+     * @param time
+     * The time the Node moved
+     *
+     * @param position
+     * The Node's new position
+     *
+     * @return
+     * True if the Node's events should be written,
+     * because it was inside a region before or after the move
+     */
+    bool UpdateRegionsOfInterest(uint32_t nodeId, Time time, const Vector3D& position);
+
+    /**
+     * @param nodeId
+     * The ID of the Node to check
+     *
+     * @return
+     * True if the Node's events should be written. Always true without regions of interest
+     */
+    bool InRegionOfInterest(uint32_t nodeId) const;
+
+    /**
+     * Index the bounds of every geofence,
+     * & find which geofences each Node starts in
+     */
+    void BuildGeofences(void);
+
+    /**
+     * Move the Node with `nodeId` within the geofences,
+     * writing an event for each geofence it enters or exits,
+     * & the new occupancy of those geofences
+     *
+     * @param nodeId
+     * The ID of the Node which moved
+     *
+     * @param time
+     * The time the Node moved
+     *
+     * @param position
+     * The Node's new position
+     */
+    void UpdateGeofences(uint32_t nodeId, Time time, const Vector3D& position);
+
+    /**
+     * Call `place` with the current position of every Node
+     * with a NodeConfiguration
+     *
+     * @param place
+     * Called with the ID & position of each Node
+     */
+    void ForEachNodePosition(const std::function<void(uint32_t, const Vector3D&)>& place) const;
+
+    /**
+     * Have the Node with `nodeId` sampled by the next adaptive mobility poll,
+     * scheduling that poll if it would not otherwise happen
+     *
+     * @param nodeId
+     * The ID of the Node whose velocity may have changed
+     */
+    void WakeMobilityPoll(uint32_t nodeId);
+
+    /**
+     * Record a course change of the Node with `nodeId`, written or not.
+     * Updates the last position polls compare against,
+     * & wakes adaptive mobility polling for the Node
+     *
+     * @param nodeId
+     * The ID of the Node which changed course
+     *
+     * @param lastPosition
+     * The last position written for the Node
+     *
+     * @return
+     * True if the course change is inside the recording window,
+     * & its position may be written
+     */
+    bool NoteCourseChange(uint32_t nodeId, const Vector3D& lastPosition);
+
+    /**
+     * Group every Node by its poll interval into `m_mobilityPollBuckets`,
+     * & rebuild the index of each group
+     */
+    void BuildMobilityPollBuckets(void);
+
+    /**
+     * Poll the Nodes with the poll interval `interval`,
+     * then schedule the next poll of those Nodes
+     *
+     * @param interval
+     * The key of the bucket to poll, in nanoseconds
+     */
+    void PollMobilityBucket(int64_t interval);
+
+    /**
+     * Cancel every scheduled mobility poll
+     */
+    void CancelMobilityPolls(void);
+
+    /**
+     * @param nodeId
+     * The ID of the Node to find
+     *
+     * @return
+     * The bucket the Node is polled in, or nullptr if it is not polled
+     */
+    MobilityPollBucket* FindMobilityPollBucket(uint32_t nodeId);
+
+    /**
+     * Serializes `event` into the stream buffer,
+     * and writes the buffer if it is full
+     *
+     * @param event
+     * The event to serialize
+     */
+    void AppendToStream(const EventRecord& event);
+
+    /**
+     * Serializes every stored event into the stream,
+     * releasing them as they are written
+     */
+    void WriteStoredEvents(void);
+
+    /**
+     * Writes the sections of the document which may no longer change
+     * (everything besides `configuration`, `keyframes`, `series`, & `streams`),
+     * then opens the `events` array.
+     *
+     * Any events stored before the header was written are moved into the stream
+     *
+     * Used when `StreamOutput` or `AsyncOutput` is enabled,
+     * or the output format is `Binary`, in which case the header
+     * is written by `m_binaryOutput` instead
+     */
+    void WriteStreamHeader(void);
+
+    /**
+     * Writes the contents of the stream buffer to the output file
+     * and empties the buffer
+     */
+    void FlushStreamBuffer(void);
+
+    /**
+     * Enable compression of the output file, based on the
+     * `Compression` attributes. Must be called before
+     * anything is written to the file
+     */
+    void ApplyCompression(void);
+
+    /**
+     * @return
+     * The index of every keyframe written so far, as the
+     * `keyframes` section of the document
+     */
+    nlohmann::json GetKeyframeIndex(void) const;
+
+    /**
+     * Starts the thread which serializes & writes events.
+     * Events written after this call are passed to that thread.
+     *
+     * Only used when `AsyncOutput` is enabled
+     * and the stream header has been written
+     */
+    void StartWriterThread(void);
+
+    /**
+     * Signals the writer thread to write the remaining
+     * queued events and waits for it to finish.
+     *
+     * If called from the writer thread (e.g. by the crash handler),
+     * the thread is detached and the remaining events are written
+     * from the calling thread instead. Events written afterwards
+     * go directly into the stream.
+     *
+     * Safe to call if the thread was never started
+     */
+    void StopWriterThread(void);
+
+    /**
+     * Body of the writer thread. Serializes events from
+     * `m_writerQueue` into the stream until it is signaled to stop
+     * and the queue is empty
+     */
+    void RunWriter(void);
+
+    /**
+     * Passes `event` to the writer thread,
+     * applying the `AsyncBackpressure` policy if the queue is full
+     *
+     * @param event
+     * The event to pass. Moved from if it was queued
+     */
+    void PushToWriter(EventRecord&& event);
+
     /**
      * Gets the time step in a way that's compatible with the
      * deprecated `TimeStep` attribute
@@ -612,12 +1175,196 @@ class Orchestrator : public ns3::Object
     /**
      * Output file handle
      */
-    std::ofstream m_file;
+    OutputFile m_file;
+
+    /**
+     * The document to serialize.
+     *
+     * Mutable, since events are only converted to JSON
+     * when `GetJson()` is called
+     */
+    mutable nlohmann::json m_document = nlohmann::json::object();
 
     /**
-     * The document to serialize
+     * Events waiting to be written to the output.
+     *
+     * Unused once the stream header is written, if `StreamOutput` is enabled
      */
-    nlohmann::json m_document = nlohmann::json::object();
+    std::deque<EventRecord> m_events;
+
+    /**
+     * Number of events from `m_events` which have been
+     * converted to JSON and added to `m_document` by `GetJson()`
+     */
+    mutable std::size_t m_jsonEventCount{0u};
+
+    /**
+     * Maximum memory, in MiB, used to hold events before they are
+     * spilled to disk. 0 for no limit.
+     * Set by the `EventBufferLimit` attribute
+     */
+    uint32_t m_eventBufferLimit;
+
+    /**
+     * Holds events in place of `m_events` when `EventBufferLimit` is set,
+     * and the output is written all at once (not streamed).
+     * Created when the simulation starts
+     */
+    std::unique_ptr<EventSpillBuffer> m_spillBuffer;
+
+    /**
+     * Flag indicating events should be written to the output file
+     * as they occur, rather than when the simulation ends.
+     * Set by the `StreamOutput` attribute
+     */
+    bool m_streamOutput;
+
+    /**
+     * Flag indicating the header has been written, and events
+     * are being written to the stream buffer.
+     *
+     * Only set when `m_streamOutput` is enabled & we're writing to a file
+     */
+    bool m_streaming{false};
+
+    /**
+     * Serialized events waiting to be written to the output file
+     */
+    std::string m_streamBuffer;
+
+    /**
+     * Size, in bytes, `m_streamBuffer` may grow to before
+     * it is written to the output file
+     */
+    uint32_t m_streamBufferSize;
+
+    /**
+     * Flag indicating the next event written to the stream
+     * is the first in the `events` array, and should not be
+     * preceded by a comma
+     */
+    bool m_firstStreamEvent{true};
+
+    /**
+     * Flag indicating events should be serialized & written
+     * on a separate thread. Set by the `AsyncOutput` attribute
+     */
+    bool m_asyncOutput;
+
+    /**
+     * Minimum number of events which may be waiting for the writer thread.
+     * Set by the `AsyncQueueSize` attribute
+     */
+    uint32_t m_asyncQueueSize;
+
+    /**
+     * What to do when the queue to the writer thread is full.
+     * Set by the `AsyncBackpressure` attribute
+     */
+    BackpressurePolicy m_backpressurePolicy;
+
+    /**
+     * Events waiting to be serialized by the writer thread.
+     * Only allocated while that thread runs, or after
+     * it was stopped from itself
+     */
+    std::unique_ptr<SpscRingBuffer<EventRecord>> m_writerQueue;
+
+    /**
+     * Thread serializing & writing events from `m_writerQueue`.
+     *
+     * While this thread runs, it owns the stream buffer & the output file
+     */
+    std::thread m_writerThread;
+
+    /**
+     * Flag telling the writer thread to stop once `m_writerQueue` is empty
+     */
+    std::atomic<bool> m_stopWriter{false};
+
+    /**
+     * Number of events discarded by the `Drop` backpressure policy
+     */
+    uint64_t m_droppedEvents{0u};
+
+    /**
+     * How far behind the latest event an event may arrive,
+     * and still be written in time order. Zero disables reordering.
+     * Set by the `ReorderWindow` attribute
+     */
+    Time m_reorderWindow;
+
+    /**
+     * What to do with events which arrive too late to be reordered.
+     * Set by the `LateEvents` attribute
+     */
+    LateEventPolicy m_lateEventPolicy;
+
+    /**
+     * Events held until they may be written in time order.
+     * Created when the first event is written, if `ReorderWindow` is set
+     */
+    std::unique_ptr<EventReorderBuffer> m_reorderBuffer;
+
+    /**
+     * Number of events which arrived too late to be reordered
+     */
+    uint64_t m_lateEvents{0u};
+
+    /**
+     * Format to write the output file in.
+     * Set by the `OutputFormat` attribute
+     */
+    OutputFormat m_outputFormat;
+
+    /**
+     * Number of events collected in each column block of binary output.
+     * Set by the `BinaryBlockSize` attribute
+     */
+    uint32_t m_binaryBlockSize;
+
+    /**
+     * How the columns of binary output are encoded.
+     * Set by the `BinaryEncoding` attribute
+     */
+    BinaryEncoding m_binaryEncoding;
+
+    /**
+     * Step Node positions are rounded to in binary output,
+     * 0 to keep them exact.
+     * Set by the `PositionResolution` attribute
+     */
+    double m_positionResolution;
+
+    /**
+     * Compression of the output file.
+     * Set by the `Compression` attribute
+     */
+    OutputCompression m_compression;
+
+    /**
+     * Compression level, 0 for the default of the format.
+     * Set by the `CompressionLevel` attribute
+     */
+    uint32_t m_compressionLevel;
+
+    /**
+     * Uncompressed size of each compressed frame, in bytes.
+     * Set by the `CompressionFrameSize` attribute
+     */
+    uint32_t m_compressionFrameSize;
+
+    /**
+     * If the output should be compressed on a separate thread.
+     * Set by the `CompressionThread` attribute
+     */
+    bool m_compressionThread;
+
+    /**
+     * Writer for binary output. Only set once the header is written,
+     * when `m_outputFormat` is `Binary`
+     */
+    std::unique_ptr<BinaryOutputWriter> m_binaryOutput;
 
     /**
      * The section of the JSON document the writer is currently in
@@ -652,8 +1399,8 @@ class Orchestrator : public ns3::Object
     bool m_simulationStarted{false};
 
     /**
-     * Event handle for a scheduled mobility poll.
-     * Will be unset if no event is scheduled
+     * Event handle for a scheduled `PollMobility()`, which starts
+     * the polls of each interval. Will be unset if no event is scheduled
      */
     std::optional<EventId> m_mobilityPollEvent;
 
@@ -662,6 +1409,177 @@ class Orchestrator : public ns3::Object
      */
     Time m_mobilityPollInterval;
 
+    /**
+     * Flag indicating Nodes are only polled once they
+     * are predicted to have moved beyond their tolerance.
+     * Set by the `AdaptiveMobilityPolling` attribute
+     */
+    bool m_adaptiveMobilityPolling;
+
+    /**
+     * The number of threads to sample Node positions on.
+     * Set by the `MobilityPollThreads` attribute
+     */
+    uint32_t m_mobilityPollThreads;
+
+    /**
+     * Space separated TypeId names of mobility models which may be sampled
+     * on other threads. Set by the `ParallelMobilityModels` attribute
+     */
+    std::string m_parallelMobilityModels;
+
+    /**
+     * Threads shared by every bucket to sample positions on.
+     * Null unless `m_mobilityPollThreads` is more than one
+     */
+    std::shared_ptr<WorkerPool> m_mobilityPollPool;
+
+    /**
+     * The clock shared by the sinks of each interval
+     */
+    std::map<Time, std::shared_ptr<SinkClock>> m_sinkClocks;
+
+    /**
+     * Time between keyframes, zero to disable them.
+     * Set by the `KeyframeInterval` attribute
+     */
+    Time m_keyframeInterval;
+
+    /**
+     * The furthest a segment may be from a position it replaces.
+     * Zero writes every position instead of segments.
+     * Set by the `TrajectoryMaxError` attribute
+     */
+    double m_trajectoryMaxError;
+
+    /**
+     * Areas Nodes must be inside to have their events written.
+     * Empty to write events for every Node
+     */
+    std::vector<Ptr<RectangularArea>> m_regionsOfInterest;
+
+    /**
+     * Which regions of interest each Node is inside of
+     */
+    AreaTracker m_regionTracker;
+
+    /**
+     * The size of each cell in the grid indexing the regions of interest & geofences.
+     * Set by the `RegionGridCellSize` attribute
+     */
+    double m_regionGridCellSize;
+
+    /**
+     * An area tracked by `AddGeofence()`
+     */
+    struct Geofence
+    {
+        /**
+         * The tracked area
+         */
+        Ptr<RectangularArea> area;
+
+        /**
+         * The series of the number of Nodes inside the area
+         */
+        Ptr<XYSeries> occupancy;
+
+        /**
+         * The number of Nodes currently inside the area
+         */
+        uint32_t count{0u};
+
+        /**
+         * False if the area is also a region of interest,
+         * which already writes its crossings
+         */
+        bool writeCrossings{true};
+    };
+
+    /**
+     * Every area tracked by `AddGeofence()`, by area ID
+     */
+    std::map<uint32_t, Geofence> m_geofences;
+
+    /**
+     * Which geofences each Node is inside of
+     */
+    AreaTracker m_geofenceTracker;
+
+    /**
+     * The segment being built for each Node which has written a position,
+     * by Node ID. Only used if `m_trajectoryMaxError` is set
+     */
+    std::map<uint32_t, TrajectorySimplifier> m_trajectories;
+
+    /**
+     * Flag to write position & orientation changes occurring together
+     * as a single `NodePoseEvent`. Set by the `PoseEvents` attribute
+     */
+    bool m_poseEvents;
+
+    /**
+     * The position of each Node which moved at `m_pendingPositionsTime`,
+     * by Node ID. So at most one position is written per Node at a given time
+     */
+    std::map<uint32_t, PendingPosition> m_pendingPositions;
+
+    /**
+     * The time of every position in `m_pendingPositions`
+     */
+    Time m_pendingPositionsTime;
+
+    /**
+     * Flag to write positions & orientations once per time step,
+     * as a single `NodeFrameEvent`. Set by the `FrameMode` attribute
+     */
+    bool m_frameMode;
+
+    /**
+     * The time of the last frame written, unset if none have been
+     */
+    std::optional<Time> m_lastFrame;
+
+    /**
+     * Event which writes `m_pendingPositions`, after every other
+     * event scheduled for the current time. Unset if none are held
+     */
+    std::optional<EventId> m_pendingPositionsEvent;
+
+    /**
+     * Event handle for the next keyframe.
+     * Will be unset if no keyframe is scheduled
+     */
+    std::optional<EventId> m_keyframeEvent;
+
+    /**
+     * Where a keyframe was written in the `events` array
+     */
+    struct KeyframeIndexEntry
+    {
+        /**
+         * Simulation time of the keyframe
+         */
+        int64_t nanoseconds;
+
+        /**
+         * Position of the keyframe in the `events` array
+         */
+        uint64_t event;
+    };
+
+    /**
+     * Every keyframe written to the output file.
+     * Written to on the writer thread when `AsyncOutput` is enabled
+     */
+    std::vector<KeyframeIndexEntry> m_keyframeIndex;
+
+    /**
+     * Number of events written to the output file so far.
+     * Written to on the writer thread when `AsyncOutput` is enabled
+     */
+    uint64_t m_writtenEventCount{0u};
+
     /**
      * Amount of ns-3 time to pass per step in the application
      * in nanoseconds
@@ -689,6 +1607,22 @@ class Orchestrator : public ns3::Object
      */
     std::vector<Ptr<NodeConfiguration>> m_nodes;
 
+    /**
+     * Polled Nodes grouped by their poll interval, in nanoseconds
+     */
+    std::map<int64_t, MobilityPollBucket> m_mobilityPollBuckets;
+
+    /**
+     * The key in `m_mobilityPollBuckets` of each Node, by Node ID
+     */
+    std::unordered_map<uint32_t, int64_t> m_mobilityPollBucketOf;
+
+    /**
+     * Flag indicating `m_mobilityPollBuckets` must be rebuilt before the next poll,
+     * since Nodes have been registered since they were last built
+     */
+    bool m_mobilityIndexDirty{true};
+
     /**
      * Collection of tracked Buildings
      */
@@ -726,7 +1660,11 @@ class Orchestrator : public ns3::Object
 
     /**
      * Write a `position` event to the output file given it is different than the
-     * previous written position
+     * previous written position.
+     * If `TrajectoryMaxError` is set, the position is added to the
+     * Node's segment instead, & a `NodeSegmentEvent` is written once the segment closes.
+     * If `orientation` is set, it is written as well. Combined
+     * into a `NodePoseEvent` if `PoseEvents` is enabled
      *
      * @param nodeId
      * The `Node` that should receive the event
@@ -737,10 +1675,49 @@ class Orchestrator : public ns3::Object
      * @param position
      * The `Node` specified by nodeId's new position
      *
-     * @return
-     * True if the position was written to the output, false otherwise
+     * @param orientation
+     * The `Node`'s new orientation, if it changed along with the position
+     */
+    void WritePosition(uint32_t nodeId,
+                       Time time,
+                       Vector3D position,
+                       const std::optional<Vector3D>& orientation = {});
+
+    /**
+     * Add `position` to the Node's segment, writing
+     * a `NodeSegmentEvent` if the segment closes
+     *
+     * @param nodeId
+     * The `Node` that moved
+     *
+     * @param time
+     * The time the Node moved
+     *
+     * @param position
+     * The `Node`'s new position
+     */
+    void WriteTrajectory(uint32_t nodeId, Time time, Vector3D position);
+
+    /**
+     * Write `segment` as a `NodeSegmentEvent`, if it is set
+     *
+     * @param nodeId
+     * The `Node` the segment belongs to
+     *
+     * @param time
+     * The time the segment was closed
+     *
+     * @param segment
+     * The closed segment, if any
+     */
+    void WriteSegment(uint32_t nodeId,
+                      Time time,
+                      const std::optional<TrajectorySimplifier::Segment>& segment);
+
+    /**
+     * Close the segment of every Node, & write them
      */
-    void WritePosition(uint32_t nodeId, Time time, Vector3D position);
+    void FinishTrajectories(void);
 
     /**
      * Commit all items tracked by this Orchestrator.
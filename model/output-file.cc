@@ -0,0 +1,442 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "output-file.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <utility>
+
+#ifdef NETSIMULYZER_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef NETSIMULYZER_ZSTD
+#include <zstd.h>
+#endif
+
+namespace
+{
+
+/**
+ * Number of full frames which may wait for the worker thread
+ * before the producer waits for it to catch up
+ */
+constexpr std::size_t MaxPendingFrames = 4u;
+
+/**
+ * @param value
+ * The string to check
+ *
+ * @param suffix
+ * The ending to look for
+ *
+ * @return
+ * True if `value` ends with `suffix`
+ */
+bool
+EndsWith(const std::string& value, const std::string& suffix)
+{
+    return value.size() >= suffix.size() &&
+           value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+namespace ns3::netsimulyzer
+{
+
+NS_LOG_COMPONENT_DEFINE("OutputFile");
+
+CompressedFrameBuffer::CompressedFrameBuffer(std::filebuf& file,
+                                             CompressedFrameBuffer::Format format,
+                                             int level,
+                                             std::size_t frameSize,
+                                             bool threaded)
+    : m_file(file),
+      m_format(format),
+      m_level(level),
+      m_frameSize(frameSize)
+{
+    NS_LOG_FUNCTION(this << static_cast<int>(format) << level << frameSize << threaded);
+    NS_ABORT_MSG_IF(frameSize == 0u, "Compression frame size must be at least 1");
+    NS_ABORT_MSG_IF(frameSize > static_cast<std::size_t>(INT_MAX),
+                    "Compression frame size may not exceed " << INT_MAX << " bytes");
+
+    switch (format)
+    {
+    case Format::Gzip: {
+#ifdef NETSIMULYZER_ZLIB
+        auto stream = new z_stream{};
+        // 15 window bits, +16 for a gzip wrapper, rather than zlib
+        const auto result = deflateInit2(stream,
+                                         level == 0 ? Z_DEFAULT_COMPRESSION : level,
+                                         Z_DEFLATED,
+                                         15 + 16,
+                                         8,
+                                         Z_DEFAULT_STRATEGY);
+        NS_ABORT_MSG_IF(result != Z_OK, "Failed to initialize gzip compression: " << result);
+        m_context = stream;
+#else
+        NS_ABORT_MSG("gzip output requested, but the NetSimulyzer was built without zlib");
+#endif
+        break;
+    }
+    case Format::Zstd:
+#ifdef NETSIMULYZER_ZSTD
+        m_context = ZSTD_createCCtx();
+        NS_ABORT_MSG_IF(!m_context, "Failed to initialize zstd compression");
+#else
+        NS_ABORT_MSG("zstd output requested, but the NetSimulyzer was built without zstd");
+#endif
+        break;
+    }
+
+    m_frame.resize(m_frameSize);
+    setp(m_frame.data(), m_frame.data() + m_frame.size());
+
+    if (threaded)
+    {
+        m_worker = std::thread(&CompressedFrameBuffer::RunWorker, this);
+    }
+}
+
+CompressedFrameBuffer::~CompressedFrameBuffer()
+{
+    Finish();
+
+    if (!m_context)
+    {
+        return;
+    }
+
+    switch (m_format)
+    {
+    case Format::Gzip:
+#ifdef NETSIMULYZER_ZLIB
+        deflateEnd(static_cast<z_stream*>(m_context));
+        delete static_cast<z_stream*>(m_context);
+#endif
+        break;
+    case Format::Zstd:
+#ifdef NETSIMULYZER_ZSTD
+        ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(m_context));
+#endif
+        break;
+    }
+}
+
+void
+CompressedFrameBuffer::Finish(void)
+{
+    if (m_finished)
+    {
+        return;
+    }
+    m_finished = true;
+
+    EmitFrame();
+    if (m_worker.joinable())
+    {
+        {
+            std::lock_guard lock{m_mutex};
+            m_stop = true;
+        }
+        m_frameQueued.notify_one();
+        m_worker.join();
+    }
+
+    setp(nullptr, nullptr);
+    m_file.pubsync();
+}
+
+CompressedFrameBuffer::int_type
+CompressedFrameBuffer::overflow(CompressedFrameBuffer::int_type ch)
+{
+    if (m_finished || !EmitFrame())
+    {
+        return traits_type::eof();
+    }
+
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize
+CompressedFrameBuffer::xsputn(const CompressedFrameBuffer::char_type* data,
+                              std::streamsize count)
+{
+    std::streamsize written = 0;
+    while (written < count)
+    {
+        if (pptr() == epptr() && (m_finished || !EmitFrame()))
+        {
+            break;
+        }
+
+        const auto chunk = std::min<std::streamsize>(count - written, epptr() - pptr());
+        std::memcpy(pptr(), data + written, static_cast<std::size_t>(chunk));
+        pbump(static_cast<int>(chunk));
+        written += chunk;
+    }
+
+    return written;
+}
+
+bool
+CompressedFrameBuffer::EmitFrame(void)
+{
+    const auto size = static_cast<std::size_t>(pptr() - pbase());
+
+    if (!m_worker.joinable())
+    {
+        if (size > 0u && !m_failed)
+        {
+            m_failed = !WriteFrame(pbase(), size);
+        }
+        setp(m_frame.data(), m_frame.data() + m_frame.size());
+        return !m_failed;
+    }
+
+    std::unique_lock lock{m_mutex};
+    if (size > 0u)
+    {
+        m_frameWritten.wait(lock, [this]() {
+            return m_pending.size() < MaxPendingFrames || m_failed;
+        });
+
+        m_frame.resize(size);
+        m_pending.emplace_back(std::move(m_frame));
+        if (m_spare.empty())
+        {
+            m_frame = std::string{};
+        }
+        else
+        {
+            m_frame = std::move(m_spare.front());
+            m_spare.pop_front();
+        }
+        m_frame.resize(m_frameSize);
+        m_frameQueued.notify_one();
+    }
+    setp(m_frame.data(), m_frame.data() + m_frame.size());
+
+    return !m_failed;
+}
+
+bool
+CompressedFrameBuffer::WriteFrame(const char* data, std::size_t size)
+{
+    Compress(data, size);
+    const auto compressedSize = static_cast<std::streamsize>(m_compressed.size());
+    return m_file.sputn(m_compressed.data(), compressedSize) == compressedSize;
+}
+
+void
+CompressedFrameBuffer::Compress([[maybe_unused]] const char* data,
+                                [[maybe_unused]] std::size_t size)
+{
+    switch (m_format)
+    {
+    case Format::Gzip: {
+#ifdef NETSIMULYZER_ZLIB
+        auto stream = static_cast<z_stream*>(m_context);
+        // Every frame is a complete gzip member
+        deflateReset(stream);
+        m_compressed.resize(deflateBound(stream, static_cast<uLong>(size)));
+
+        stream->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        stream->avail_in = static_cast<uInt>(size);
+        stream->next_out = reinterpret_cast<Bytef*>(m_compressed.data());
+        stream->avail_out = static_cast<uInt>(m_compressed.size());
+
+        const auto result = deflate(stream, Z_FINISH);
+        NS_ABORT_MSG_IF(result != Z_STREAM_END, "gzip compression failed: " << result);
+        m_compressed.resize(stream->total_out);
+#endif
+        break;
+    }
+    case Format::Zstd: {
+#ifdef NETSIMULYZER_ZSTD
+        m_compressed.resize(ZSTD_compressBound(size));
+        const auto result = ZSTD_compressCCtx(static_cast<ZSTD_CCtx*>(m_context),
+                                              m_compressed.data(),
+                                              m_compressed.size(),
+                                              data,
+                                              size,
+                                              m_level);
+        NS_ABORT_MSG_IF(ZSTD_isError(result),
+                        "zstd compression failed: " << ZSTD_getErrorName(result));
+        m_compressed.resize(result);
+#endif
+        break;
+    }
+    }
+}
+
+void
+CompressedFrameBuffer::RunWorker(void)
+{
+    std::unique_lock lock{m_mutex};
+    while (true)
+    {
+        m_frameQueued.wait(lock, [this]() { return !m_pending.empty() || m_stop; });
+        if (m_pending.empty())
+        {
+            return;
+        }
+
+        auto frame = std::move(m_pending.front());
+        m_pending.pop_front();
+        const auto failed = m_failed;
+
+        lock.unlock();
+        const auto written = failed || WriteFrame(frame.data(), frame.size());
+        lock.lock();
+
+        m_failed = m_failed || !written;
+        m_spare.emplace_back(std::move(frame));
+        m_frameWritten.notify_one();
+    }
+}
+
+OutputFile::OutputFile()
+    : std::ostream(nullptr)
+{
+    rdbuf(&m_fileBuffer);
+}
+
+OutputFile::~OutputFile()
+{
+    close();
+}
+
+void
+OutputFile::open(const std::string& path)
+{
+    NS_LOG_FUNCTION(this << path);
+    if (m_fileBuffer.open(path, std::ios::out | std::ios::trunc | std::ios::binary))
+    {
+        clear();
+    }
+    else
+    {
+        setstate(std::ios::failbit);
+    }
+}
+
+bool
+OutputFile::is_open(void) const
+{
+    return m_fileBuffer.is_open();
+}
+
+void
+OutputFile::close(void)
+{
+    NS_LOG_FUNCTION(this);
+    const auto state = rdstate();
+    if (m_compressedBuffer)
+    {
+        m_compressedBuffer->Finish();
+        rdbuf(&m_fileBuffer);
+        m_compressedBuffer.reset();
+    }
+
+    // `rdbuf()` clears the state, so restore any errors from before
+    setstate(state);
+    if (m_fileBuffer.is_open() && !m_fileBuffer.close())
+    {
+        setstate(std::ios::failbit);
+    }
+}
+
+void
+OutputFile::SetCompression(OutputFile::Compression compression,
+                           int level,
+                           std::size_t frameSize,
+                           bool threaded)
+{
+    NS_LOG_FUNCTION(this << static_cast<int>(compression) << level << frameSize << threaded);
+    NS_ABORT_MSG_IF(m_compressedBuffer, "Compression may only be set once");
+    NS_ABORT_MSG_IF(m_fileBuffer.pubseekoff(0, std::ios::cur, std::ios::out) > 0,
+                    "Compression must be set before anything is written");
+
+    if (compression == Compression::None)
+    {
+        return;
+    }
+
+    // zlib only accepts levels up to 9, zstd up to 22
+    const auto maxLevel = compression == Compression::Gzip ? 9 : 22;
+    NS_ABORT_MSG_IF(level < 0 || level > maxLevel,
+                    "Compression level " << level << " is out of range for "
+                                         << (compression == Compression::Gzip ? "gzip" : "zstd")
+                                         << ", expected 0-" << maxLevel);
+
+    const auto format = compression == Compression::Gzip ? CompressedFrameBuffer::Format::Gzip
+                                                         : CompressedFrameBuffer::Format::Zstd;
+    m_compressedBuffer =
+        std::make_unique<CompressedFrameBuffer>(m_fileBuffer, format, level, frameSize, threaded);
+
+    const auto state = rdstate();
+    rdbuf(m_compressedBuffer.get());
+    setstate(state);
+}
+
+OutputFile::Compression
+OutputFile::CompressionFromPath(const std::string& path)
+{
+    if (EndsWith(path, ".gz"))
+    {
+        return Compression::Gzip;
+    }
+
+    if (EndsWith(path, ".zst"))
+    {
+        return Compression::Zstd;
+    }
+
+    return Compression::None;
+}
+
+} // namespace ns3::netsimulyzer
@@ -0,0 +1,339 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#ifndef OUTPUT_FILE_H
+#define OUTPUT_FILE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+namespace ns3::netsimulyzer
+{
+
+/**
+ * Stream buffer which collects output into fixed size frames,
+ * and writes each frame to a file as an independent compressed frame
+ * (a gzip member, or a zstd frame).
+ *
+ * Concatenated frames are still a valid file for either format,
+ * and every frame written before a crash may still be decompressed.
+ *
+ * Optionally compresses & writes the frames on a worker thread,
+ * so the thread producing the output only copies into the frame
+ */
+class CompressedFrameBuffer : public std::streambuf
+{
+  public:
+    /**
+     * Supported compression formats
+     */
+    enum class Format
+    {
+        Gzip,
+        Zstd
+    };
+
+    /**
+     * Set up the compressor & frame. Nothing is written until the first frame fills
+     *
+     * @param file
+     * The open file to write frames to. Must outlive the buffer
+     *
+     * @param format
+     * The compression format for each frame.
+     * Aborts if support for the format was not compiled in
+     *
+     * @param level
+     * The compression level, 0 for the default of `format`
+     *
+     * @param frameSize
+     * Number of uncompressed bytes in each frame
+     *
+     * @param threaded
+     * If frames should be compressed & written on a worker thread
+     */
+    CompressedFrameBuffer(std::filebuf& file,
+                          Format format,
+                          int level,
+                          std::size_t frameSize,
+                          bool threaded);
+
+    CompressedFrameBuffer(const CompressedFrameBuffer&) = delete;
+    CompressedFrameBuffer& operator=(const CompressedFrameBuffer&) = delete;
+
+    /**
+     * Calls `Finish()`
+     */
+    ~CompressedFrameBuffer() override;
+
+    /**
+     * Write the last, possibly partial, frame and wait for every frame to
+     * reach the file. Nothing may be written after this call
+     */
+    void Finish(void);
+
+  protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char_type* data, std::streamsize count) override;
+
+  private:
+    /**
+     * Hand the bytes in the put area off as a frame,
+     * and start a new, empty frame
+     *
+     * @return
+     * False if a previous frame failed to write
+     */
+    bool EmitFrame(void);
+
+    /**
+     * Compress a frame and write it to the file
+     *
+     * @param data
+     * The uncompressed bytes of the frame
+     *
+     * @param size
+     * Number of bytes in `data`
+     *
+     * @return
+     * True if the whole frame was written
+     */
+    bool WriteFrame(const char* data, std::size_t size);
+
+    /**
+     * Compress `size` bytes of `data` as a single frame into `m_compressed`
+     *
+     * @param data
+     * The uncompressed bytes
+     *
+     * @param size
+     * Number of bytes in `data`
+     */
+    void Compress(const char* data, std::size_t size);
+
+    /**
+     * Body of the worker thread.
+     * Writes frames from `m_pending` until `m_stop` is set, and none are left
+     */
+    void RunWorker(void);
+
+    /**
+     * The file frames are written to
+     */
+    std::filebuf& m_file;
+
+    /**
+     * The compression format for each frame
+     */
+    Format m_format;
+
+    /**
+     * Compression level passed to the library
+     */
+    int m_level;
+
+    /**
+     * Number of uncompressed bytes in each frame
+     */
+    std::size_t m_frameSize;
+
+    /**
+     * The frame being filled. Backs the put area
+     */
+    std::string m_frame;
+
+    /**
+     * Reused output of `Compress()`
+     */
+    std::string m_compressed;
+
+    /**
+     * Compressor state for the selected format (`z_stream` or `ZSTD_CCtx`)
+     */
+    void* m_context{nullptr};
+
+    /**
+     * Set if a frame could not be written, after which all output fails.
+     * Guarded by `m_mutex` while the worker runs
+     */
+    bool m_failed{false};
+
+    /**
+     * Set once `Finish()` has been called
+     */
+    bool m_finished{false};
+
+    /**
+     * Thread compressing & writing frames. Not started if not threaded
+     */
+    std::thread m_worker;
+
+    /**
+     * Guards `m_pending`, `m_spare`, & `m_stop`
+     */
+    std::mutex m_mutex;
+
+    /**
+     * Signaled when a frame is queued, or the worker is told to stop
+     */
+    std::condition_variable m_frameQueued;
+
+    /**
+     * Signaled when the worker finishes a frame
+     */
+    std::condition_variable m_frameWritten;
+
+    /**
+     * Frames waiting for the worker
+     */
+    std::deque<std::string> m_pending;
+
+    /**
+     * Frames the worker has finished with, reused to avoid
+     * allocating a new frame each time
+     */
+    std::deque<std::string> m_spare;
+
+    /**
+     * Set to stop the worker once `m_pending` is empty
+     */
+    bool m_stop{false};
+};
+
+/**
+ * Output file stream which may compress everything written to it.
+ *
+ * A drop in replacement for the `std::ofstream` the `Orchestrator` writes to
+ *
+ * @see CompressedFrameBuffer
+ */
+class OutputFile : public std::ostream
+{
+  public:
+    /**
+     * How the file is compressed
+     */
+    enum class Compression
+    {
+        None,
+        Gzip,
+        Zstd
+    };
+
+    /**
+     * Construct without opening a file
+     */
+    OutputFile();
+
+    /**
+     * Calls `close()`
+     */
+    ~OutputFile() override;
+
+    /**
+     * Open `path` for writing, replacing any existing file.
+     * Sets `failbit` if the file could not be opened
+     *
+     * @param path
+     * The file to write to
+     */
+    void open(const std::string& path);
+
+    /**
+     * @return
+     * True if a file is open
+     */
+    bool is_open(void) const;
+
+    /**
+     * Write any remaining compressed frames, then close the file
+     */
+    void close(void);
+
+    /**
+     * Compress everything written from now on.
+     * Must be called before anything is written to the file
+     *
+     * @param compression
+     * The compression format, `Compression::None` writes the file as-is
+     *
+     * @param level
+     * The compression level, 0 for the default of the format.
+     * At most 9 for gzip, and 22 for zstd
+     *
+     * @param frameSize
+     * Number of uncompressed bytes in each compressed frame
+     *
+     * @param threaded
+     * If compression should run on a worker thread
+     */
+    void SetCompression(Compression compression, int level, std::size_t frameSize, bool threaded);
+
+    /**
+     * Select a compression format from the extension of `path`
+     *
+     * @param path
+     * The output file path
+     *
+     * @return
+     * `Compression::Gzip` for paths ending in `.gz`,
+     * `Compression::Zstd` for paths ending in `.zst`,
+     * `Compression::None` otherwise
+     */
+    static Compression CompressionFromPath(const std::string& path);
+
+  private:
+    /**
+     * The underlying, uncompressed file
+     */
+    std::filebuf m_fileBuffer;
+
+    /**
+     * Compressing buffer in front of `m_fileBuffer`.
+     * Only set when compression is enabled
+     */
+    std::unique_ptr<CompressedFrameBuffer> m_compressedBuffer;
+};
+
+} // namespace ns3::netsimulyzer
+
+#endif // OUTPUT_FILE_H
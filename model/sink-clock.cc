@@ -0,0 +1,236 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "sink-clock.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SinkClock");
+
+namespace netsimulyzer
+{
+
+SinkClock::SinkClock(Time interval)
+    : m_interval(interval)
+{
+    NS_LOG_FUNCTION(this << interval);
+    NS_ASSERT_MSG(interval.IsStrictlyPositive(), "`interval` must be greater than 0");
+}
+
+SinkClock::~SinkClock()
+{
+    Stop();
+}
+
+std::size_t
+SinkClock::Register(WriteCallback write)
+{
+    NS_LOG_FUNCTION(this);
+    std::size_t slot;
+    if (m_freeSlots.empty())
+    {
+        slot = m_writes.size();
+        m_writes.emplace_back(std::move(write));
+        m_totals.emplace_back(0u);
+        m_since.emplace_back(Simulator::Now());
+    }
+    else
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        m_writes[slot] = std::move(write);
+        m_totals[slot] = 0u;
+        m_since[slot] = Simulator::Now();
+    }
+
+    if (!m_event.has_value())
+    {
+        Start();
+    }
+
+    return slot;
+}
+
+void
+SinkClock::Unregister(std::size_t slot)
+{
+    NS_LOG_FUNCTION(this << slot);
+    m_writes[slot] = nullptr;
+    m_totals[slot] = 0u;
+    m_freeSlots.emplace_back(slot);
+
+    if (GetSinkCount() == 0u)
+    {
+        Stop();
+    }
+}
+
+uint64_t
+SinkClock::Take(std::size_t slot)
+{
+    const auto total = m_totals[slot];
+    m_totals[slot] = 0u;
+    m_since[slot] = Simulator::Now();
+    return total;
+}
+
+Time
+SinkClock::GetSince(std::size_t slot) const
+{
+    return m_since[slot];
+}
+
+Time
+SinkClock::GetInterval(void) const
+{
+    return m_interval;
+}
+
+std::size_t
+SinkClock::GetSinkCount(void) const
+{
+    return m_writes.size() - m_freeSlots.size();
+}
+
+void
+SinkClock::SetWindow(Time start, Time stop)
+{
+    NS_LOG_FUNCTION(this << start << stop);
+    const auto now = Simulator::Now();
+    const auto sweeping = m_event.has_value() && now >= m_start && now < m_stop;
+
+    m_start = start;
+    m_stop = stop;
+    Stop();
+    if (GetSinkCount() == 0u)
+    {
+        return;
+    }
+
+    // Keep the interval in progress
+    if (sweeping && now >= m_start && now < m_stop)
+    {
+        ScheduleSweep();
+        return;
+    }
+
+    Start();
+}
+
+void
+SinkClock::Stop(void)
+{
+    if (m_event.has_value())
+    {
+        Simulator::Cancel(m_event.value());
+        m_event.reset();
+    }
+}
+
+void
+SinkClock::Start(void)
+{
+    const auto now = Simulator::Now();
+    if (now < m_start)
+    {
+        m_event = Simulator::Schedule(m_start - now, &SinkClock::Begin, this);
+    }
+    else if (now < m_stop)
+    {
+        Begin();
+    }
+}
+
+void
+SinkClock::Begin(void)
+{
+    NS_LOG_FUNCTION(this);
+    const auto now = Simulator::Now();
+    for (std::size_t slot = 0u; slot < m_writes.size(); slot++)
+    {
+        m_totals[slot] = 0u;
+        m_since[slot] = now;
+    }
+    m_lastSweep = now;
+    m_event.reset();
+
+    ScheduleSweep();
+}
+
+void
+SinkClock::ScheduleSweep(void)
+{
+    const auto now = Simulator::Now();
+    if (now >= m_stop)
+    {
+        NS_LOG_DEBUG("Past the end of the window, not scheduling another write");
+        m_event.reset();
+        return;
+    }
+
+    // Finish with a shorter interval, rather than losing it
+    const auto next = std::max(std::min(m_lastSweep + m_interval, m_stop), now);
+    m_event = Simulator::Schedule(next - now, &SinkClock::Sweep, this);
+}
+
+void
+SinkClock::Sweep(void)
+{
+    NS_LOG_FUNCTION(this);
+    const auto now = Simulator::Now();
+    for (std::size_t slot = 0u; slot < m_writes.size(); slot++)
+    {
+        // Unused, or registered at this same time
+        if (!m_writes[slot] || m_since[slot] == now)
+        {
+            continue;
+        }
+
+        m_writes[slot](m_totals[slot], now - m_since[slot]);
+        m_totals[slot] = 0u;
+        m_since[slot] = now;
+    }
+    m_lastSweep = now;
+
+    ScheduleSweep();
+}
+
+} // namespace netsimulyzer
+} // namespace ns3
@@ -0,0 +1,238 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#ifndef SINK_CLOCK_H
+#define SINK_CLOCK_H
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace ns3::netsimulyzer
+{
+
+/**
+ * A single scheduled event shared by every sink
+ * which writes its total on the same interval.
+ *
+ * Each sink registers for a slot in a contiguous array of totals,
+ * which it adds to. Every interval, one event writes the total of every slot,
+ * then resets them, rather than one event per sink.
+ *
+ * Nothing is scheduled outside of the window set by `SetWindow()`.
+ * Totals start from the beginning of the window,
+ * and a final, shorter, interval is written at the end of it
+ */
+class SinkClock
+{
+  public:
+    /**
+     * Called for a slot every interval, with its total,
+     * and the time the total was collected over
+     */
+    using WriteCallback = std::function<void(uint64_t, Time)>;
+
+    /**
+     * Set up a clock without any sinks.
+     * Nothing is scheduled until a sink is registered
+     *
+     * @param interval
+     * The time between writes. Must be positive
+     */
+    explicit SinkClock(Time interval);
+
+    /**
+     * Cancels the scheduled write, if any
+     */
+    ~SinkClock();
+
+    /**
+     * Add a sink, starting its first total at the current time
+     *
+     * @param write
+     * Called with the total of the slot every interval
+     *
+     * @return
+     * The slot for the sink to add to
+     */
+    std::size_t Register(WriteCallback write);
+
+    /**
+     * Remove a sink, discarding its total. Its slot may be reused
+     *
+     * @param slot
+     * The slot returned by `Register()`
+     */
+    void Unregister(std::size_t slot);
+
+    /**
+     * Add to the total of a slot
+     *
+     * @param slot
+     * The slot returned by `Register()`
+     *
+     * @param amount
+     * The amount to add
+     */
+    void Add(std::size_t slot, uint64_t amount)
+    {
+        m_totals[slot] += amount;
+    }
+
+    /**
+     * Reset the total of a slot outside of the usual interval
+     *
+     * @param slot
+     * The slot returned by `Register()`
+     *
+     * @return
+     * The total of `slot` before it was reset
+     */
+    uint64_t Take(std::size_t slot);
+
+    /**
+     * @param slot
+     * The slot returned by `Register()`
+     *
+     * @return
+     * The time the current total of `slot` started from
+     */
+    Time GetSince(std::size_t slot) const;
+
+    /**
+     * @return
+     * The time between writes
+     */
+    Time GetInterval(void) const;
+
+    /**
+     * @return
+     * The number of registered sinks
+     */
+    std::size_t GetSinkCount(void) const;
+
+    /**
+     * Only write totals from `start` to `stop`, inclusive.
+     *
+     * If the clock is already writing, & the current time is still
+     * inside the window, the current interval continues. Otherwise,
+     * every total restarts from the beginning of the new window
+     *
+     * @param start
+     * The first time totals are collected from
+     *
+     * @param stop
+     * The last time totals are written
+     */
+    void SetWindow(Time start, Time stop);
+
+    /**
+     * Cancel the scheduled write. Restarted by the next `Register()`
+     */
+    void Stop(void);
+
+  private:
+    /**
+     * Schedule the start of the window, or start it now if the window has started
+     */
+    void Start(void);
+
+    /**
+     * Reset the total of every slot, then schedule the first write
+     */
+    void Begin(void);
+
+    /**
+     * Schedule the next write, if the window has not passed
+     */
+    void ScheduleSweep(void);
+
+    /**
+     * Write, & reset, the total of every slot, then schedule the next write
+     */
+    void Sweep(void);
+
+    /**
+     * The time between writes
+     */
+    Time m_interval;
+
+    /**
+     * The callback of each slot. Empty for unused slots
+     */
+    std::vector<WriteCallback> m_writes;
+
+    /**
+     * The total of each slot, since `m_since` of that slot
+     */
+    std::vector<uint64_t> m_totals;
+
+    /**
+     * The time each slot's total started from
+     */
+    std::vector<Time> m_since;
+
+    /**
+     * The first time totals are collected from
+     */
+    Time m_start;
+
+    /**
+     * The last time totals are written
+     */
+    Time m_stop{Time::Max()};
+
+    /**
+     * The time the totals were last reset
+     */
+    Time m_lastSweep;
+
+    /**
+     * Slots which were unregistered, to be reused
+     */
+    std::vector<std::size_t> m_freeSlots;
+
+    /**
+     * The next write, or the start of the window, if scheduled
+     */
+    std::optional<EventId> m_event;
+};
+
+} // namespace ns3::netsimulyzer
+
+#endif
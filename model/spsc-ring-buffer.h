@@ -0,0 +1,198 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#ifndef SPSC_RING_BUFFER_H
+#define SPSC_RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ns3::netsimulyzer
+{
+
+/**
+ * Fixed capacity, lock-free queue for handing values from
+ * exactly one producer thread to exactly one consumer thread.
+ *
+ * Slots are allocated once on construction, so neither side
+ * allocates while pushing or popping.
+ *
+ * @tparam T
+ * The type stored in each slot. Must be default constructible and movable
+ */
+template <typename T>
+class SpscRingBuffer
+{
+  public:
+    /**
+     * Allocate the slots for the buffer
+     *
+     * @param capacity
+     * The minimum number of values the buffer may hold at once.
+     * Rounded up to the next power of two
+     */
+    explicit SpscRingBuffer(std::size_t capacity)
+    {
+        std::size_t size = 2u;
+        while (size < capacity)
+        {
+            size <<= 1u;
+        }
+
+        m_slots.resize(size);
+        m_mask = size - 1u;
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    /**
+     * Attempt to add `value` to the end of the buffer.
+     * Must only be called from the producer thread.
+     *
+     * @param value
+     * The value to move into the buffer.
+     * Left untouched if the buffer is full
+     *
+     * @return
+     * True if the value was added,
+     * False if the buffer was full
+     */
+    bool TryPush(T& value)
+    {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail > m_mask)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail > m_mask)
+            {
+                return false;
+            }
+        }
+
+        m_slots[head & m_mask] = std::move(value);
+        m_head.store(head + 1u, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Attempt to remove the value at the front of the buffer.
+     * Must only be called from the consumer thread.
+     *
+     * @param value
+     * Where to move the removed value.
+     * Left untouched if the buffer is empty
+     *
+     * @return
+     * True if a value was removed,
+     * False if the buffer was empty
+     */
+    bool TryPop(T& value)
+    {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_cachedHead)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail == m_cachedHead)
+            {
+                return false;
+            }
+        }
+
+        value = std::move(m_slots[tail & m_mask]);
+        m_tail.store(tail + 1u, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @return
+     * True if there are no values in the buffer.
+     * Only a snapshot if the other thread is active
+     */
+    bool IsEmpty(void) const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return
+     * The number of values the buffer may hold at once
+     */
+    std::size_t GetCapacity(void) const
+    {
+        return m_slots.size();
+    }
+
+  private:
+    /**
+     * Assumed size of a cache line,
+     * used to keep the producer & consumer indices from sharing one
+     */
+    static constexpr std::size_t CacheLineSize = 64u;
+
+    /**
+     * Storage for the values in the buffer
+     */
+    std::vector<T> m_slots;
+
+    /**
+     * `m_slots.size() - 1`, for wrapping the indices
+     */
+    std::size_t m_mask;
+
+    /**
+     * Index of the next slot to write. Only written by the producer
+     */
+    alignas(CacheLineSize) std::atomic<std::size_t> m_head{0u};
+
+    /**
+     * The producer's last seen value of `m_tail`
+     */
+    std::size_t m_cachedTail{0u};
+
+    /**
+     * Index of the next slot to read. Only written by the consumer
+     */
+    alignas(CacheLineSize) std::atomic<std::size_t> m_tail{0u};
+
+    /**
+     * The consumer's last seen value of `m_head`
+     */
+    std::size_t m_cachedHead{0u};
+};
+
+} // namespace ns3::netsimulyzer
+
+#endif // SPSC_RING_BUFFER_H
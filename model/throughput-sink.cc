@@ -62,9 +62,6 @@ ThroughputSink::ThroughputSink(Ptr<Orchestrator> orchestrator, const std::string
     PointerValue xAxis;
     m_series->GetAttribute("XAxis", xAxis);
     xAxis.Get<ValueAxis>()->SetAttribute("Name", StringValue("Time (s)"));
-
-    // Set callback for data dump
-    m_timer.SetFunction(&ThroughputSink::WriteThroughput, this);
 }
 
 TypeId
@@ -178,13 +175,14 @@ ThroughputSink::SetInterval(Time interval)
 {
     NS_LOG_FUNCTION(this << interval);
     NS_ASSERT_MSG(interval.GetSeconds() > 0, "Needs interval greater than 0");
-    if (m_timer.IsRunning())
+    if (m_clock)
     {
-        m_timer.Cancel();
+        m_clock->Unregister(m_clockSlot);
     }
     m_packetsInterval = interval;
-    m_timer.SetDelay(m_packetsInterval);
-    m_timer.Schedule();
+    m_clock = m_orchestrator->GetSinkClock(m_packetsInterval);
+    m_clockSlot = m_clock->Register(
+        [this](uint64_t total, Time duration) { WriteThroughput(total, duration); });
 }
 
 void
@@ -198,18 +196,31 @@ void
 ThroughputSink::AddPacketSize(uint32_t size)
 {
     NS_LOG_FUNCTION(this << size);
-    m_total += size;
+    m_clock->Add(m_clockSlot, size);
 }
 
 void
 ThroughputSink::WriteThroughput()
 {
     NS_LOG_FUNCTION(this);
+    // Over the time actually elapsed, the same as the clock's writes,
+    // since this may be called partway through an interval
+    const auto elapsed = Simulator::Now() - m_clock->GetSince(m_clockSlot);
+    if (!elapsed.IsStrictlyPositive())
+    {
+        NS_LOG_DEBUG("No time elapsed since the last write, not writing throughput");
+        return;
+    }
+
+    WriteThroughput(m_clock->Take(m_clockSlot), elapsed);
+}
 
-    double y = (m_total * m_unitScale) / m_packetsInterval.GetSeconds();
+void
+ThroughputSink::WriteThroughput(uint64_t total, Time duration)
+{
+    NS_LOG_FUNCTION(this << total << duration);
+    double y = (total * m_unitScale) / duration.GetSeconds();
     m_series->Append(Simulator::Now().GetSeconds(), y);
-    m_total = 0;
-    m_timer.Schedule();
 }
 
 void
@@ -264,7 +275,11 @@ ThroughputSink::DoDispose(void)
     NS_LOG_FUNCTION(this);
     m_orchestrator = nullptr;
     m_series = nullptr;
-    m_timer.Cancel();
+    if (m_clock)
+    {
+        m_clock->Unregister(m_clockSlot);
+        m_clock.reset();
+    }
     Object::DoDispose();
 }
 
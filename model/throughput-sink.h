@@ -35,14 +35,16 @@
 #define THROUGHPUT_SINK_H
 
 #include "orchestrator.h"
+#include "sink-clock.h"
 
 #include "ns3/nstime.h"
 #include "ns3/object.h"
 #include "ns3/packet.h"
 #include "ns3/ptr.h"
-#include "ns3/timer.h"
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 
 namespace ns3::netsimulyzer
@@ -93,7 +95,9 @@ class ThroughputSink : public ns3::Object
     void SetUnit(ThroughputSink::Unit unit);
 
     /**
-     * Set the interval between data points in the XY series
+     * Set the interval between data points in the XY series.
+     * Every sink with the same interval is written by a single shared event
+     *
      * @param interval The interval between data points in the XY series
      */
     void SetInterval(Time interval);
@@ -119,7 +123,9 @@ class ThroughputSink : public ns3::Object
     void AddPacketSize(uint32_t size);
 
     /**
-     * Write the throughput at `Simulation::Now()` time
+     * Write the throughput since the last write at `Simulation::Now()` time,
+     * over the time elapsed since that write.
+     * Throughput is written every interval without calling this
      */
     void WriteThroughput();
 
@@ -223,29 +229,41 @@ class ThroughputSink : public ns3::Object
 
     /**
      * Scale factor based on `m_unit`,
-     * applied to `m_total` before it is written
+     * applied to the total before it is written
      */
     double m_unitScale{1.0};
 
     /**
-     * The series that tracks the value accumulated in `m_total`
+     * The series that tracks the value accumulated in `m_clock`
      */
     Ptr<XYSeries> m_series;
 
     /**
-     * Size of data received since last period
+     * Interval of time between updates
      */
-    uint32_t m_total{0u};
+    Time m_packetsInterval;
 
     /**
-     * Interval of time between updates
+     * The clock shared by every sink with the same interval,
+     * which holds the size of data received since the last period
      */
-    Time m_packetsInterval;
+    std::shared_ptr<SinkClock> m_clock;
 
     /**
-     * Timer for writing values in the XY series
+     * This sink's slot in `m_clock`
+     */
+    std::size_t m_clockSlot{0u};
+
+    /**
+     * Write the throughput of `total` bytes received over `duration`
+     *
+     * @param total
+     * The number of bytes received
+     *
+     * @param duration
+     * The time the bytes were received over
      */
-    Timer m_timer;
+    void WriteThroughput(uint64_t total, Time duration);
 
     /**
      * Update the unit labels on the X & Y axes
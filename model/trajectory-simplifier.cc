@@ -0,0 +1,205 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "trajectory-simplifier.h"
+
+#include "ns3/abort.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+/**
+ * Narrow the range [`low`, `high`] to the velocities within
+ * `radius` of `center`
+ *
+ * @param low
+ * The lowest velocity in the range
+ *
+ * @param high
+ * The highest velocity in the range
+ *
+ * @param center
+ * The velocity which passes through the position exactly
+ *
+ * @param radius
+ * The furthest a velocity may be from `center`
+ *
+ * @return
+ * True if the narrowed range is not empty
+ */
+bool
+narrow(double& low, double& high, double center, double radius)
+{
+    low = std::max(low, center - radius);
+    high = std::min(high, center + radius);
+    return low <= high;
+}
+
+} // namespace
+
+namespace ns3::netsimulyzer
+{
+
+TrajectorySimplifier::TrajectorySimplifier(double maxError)
+    : m_maxError(maxError)
+{
+    NS_ABORT_MSG_IF(maxError < 0.0, "Trajectory error may not be negative");
+}
+
+std::optional<TrajectorySimplifier::Segment>
+TrajectorySimplifier::Add(int64_t time, const Vector3D& position)
+{
+    if (!m_open)
+    {
+        Start(time, position);
+        return {};
+    }
+
+    if (time <= m_lastTime)
+    {
+        // Nothing to fit a line through. Either the Node hasn't
+        // meaningfully moved, or it jumped
+        if (std::abs(position.x - m_lastPosition.x) <= m_maxError &&
+            std::abs(position.y - m_lastPosition.y) <= m_maxError &&
+            std::abs(position.z - m_lastPosition.z) <= m_maxError)
+        {
+            return {};
+        }
+
+        const auto segment = Close();
+        Start(time, position);
+        return segment;
+    }
+
+    const auto seconds = static_cast<double>(time - m_startTime) * 1e-9;
+    const auto radius = m_maxError / seconds;
+
+    auto minVelocity = m_minVelocity;
+    auto maxVelocity = m_maxVelocity;
+
+    // Not short-circuited, so every axis is narrowed
+    const auto fits =
+        narrow(minVelocity.x, maxVelocity.x, (position.x - m_startPosition.x) / seconds, radius) &
+        narrow(minVelocity.y, maxVelocity.y, (position.y - m_startPosition.y) / seconds, radius) &
+        narrow(minVelocity.z, maxVelocity.z, (position.z - m_startPosition.z) / seconds, radius);
+
+    if (fits)
+    {
+        m_minVelocity = minVelocity;
+        m_maxVelocity = maxVelocity;
+        m_lastTime = time;
+        m_lastPosition = position;
+        return {};
+    }
+
+    // Continue from where the closed segment ended, so there are no gaps.
+    // A single position always fits, so this can't close another segment
+    const auto segment = Close();
+    Start(m_lastTime, m_lastPosition);
+    Add(time, position);
+
+    return segment;
+}
+
+std::optional<TrajectorySimplifier::Segment>
+TrajectorySimplifier::Finish(void)
+{
+    if (!m_open)
+    {
+        return {};
+    }
+
+    m_open = false;
+    return Close();
+}
+
+std::optional<int64_t>
+TrajectorySimplifier::GetLastTime(void) const
+{
+    if (!m_open)
+    {
+        return {};
+    }
+
+    return m_lastTime;
+}
+
+const Vector3D&
+TrajectorySimplifier::GetLastPosition(void) const
+{
+    return m_lastPosition;
+}
+
+void
+TrajectorySimplifier::Start(int64_t time, const Vector3D& position)
+{
+    m_open = true;
+    m_startTime = time;
+    m_startPosition = position;
+    m_lastTime = time;
+    m_lastPosition = position;
+
+    constexpr auto infinity = std::numeric_limits<double>::infinity();
+    m_minVelocity = {-infinity, -infinity, -infinity};
+    m_maxVelocity = {infinity, infinity, infinity};
+}
+
+TrajectorySimplifier::Segment
+TrajectorySimplifier::Close(void) const
+{
+    Segment segment{m_startTime, m_lastTime, m_startPosition, {0.0, 0.0, 0.0}};
+    if (m_lastTime == m_startTime)
+    {
+        return segment;
+    }
+
+    // Prefer the line straight to the last position, if it's within the error of the rest
+    const auto seconds = static_cast<double>(m_lastTime - m_startTime) * 1e-9;
+    segment.velocity.x = std::clamp((m_lastPosition.x - m_startPosition.x) / seconds,
+                                    m_minVelocity.x,
+                                    m_maxVelocity.x);
+    segment.velocity.y = std::clamp((m_lastPosition.y - m_startPosition.y) / seconds,
+                                    m_minVelocity.y,
+                                    m_maxVelocity.y);
+    segment.velocity.z = std::clamp((m_lastPosition.z - m_startPosition.z) / seconds,
+                                    m_minVelocity.z,
+                                    m_maxVelocity.z);
+
+    return segment;
+}
+
+} // namespace ns3::netsimulyzer
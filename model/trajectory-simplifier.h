@@ -0,0 +1,191 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#ifndef TRAJECTORY_SIMPLIFIER_H
+#define TRAJECTORY_SIMPLIFIER_H
+
+#include "ns3/vector.h"
+
+#include <cstdint>
+#include <optional>
+
+namespace ns3::netsimulyzer
+{
+
+/**
+ * Reduces the positions of a single Node to straight line segments,
+ * each within a maximum error of every position it replaces.
+ *
+ * Each segment starts at a written position, & keeps, for each axis,
+ * the range of velocities which pass within the error of every
+ * position added since. A position which empties any range
+ * closes the segment at the previous position, & starts the next one there.
+ *
+ * Error is measured on each axis independently, the same way
+ * `PositionTolerance` is, at the time of each position
+ */
+class TrajectorySimplifier
+{
+  public:
+    /**
+     * Straight line motion between two positions
+     */
+    struct Segment
+    {
+        /**
+         * Time the segment starts, in nanoseconds
+         */
+        int64_t start;
+
+        /**
+         * Time the segment ends, in nanoseconds
+         */
+        int64_t end;
+
+        /**
+         * Position at `start`
+         */
+        Vector3D position;
+
+        /**
+         * Velocity from `start` until `end`, in units per second
+         */
+        Vector3D velocity;
+    };
+
+    /**
+     * @param maxError
+     * The furthest any added position may be
+     * from its segment, on any axis. Must not be negative
+     */
+    explicit TrajectorySimplifier(double maxError);
+
+    /**
+     * Add the next position of the Node
+     *
+     * @param time
+     * The time of the position, in nanoseconds.
+     * Must not be before the previous position
+     *
+     * @param position
+     * The position of the Node at `time`
+     *
+     * @return
+     * The segment closed by this position, if any
+     */
+    std::optional<Segment> Add(int64_t time, const Vector3D& position);
+
+    /**
+     * Close the current segment at the last position added.
+     * The next position added starts a new segment
+     *
+     * @return
+     * The closed segment, or an unset optional
+     * if no position has been added since the last one closed
+     */
+    std::optional<Segment> Finish(void);
+
+    /**
+     * @return
+     * The time of the last position added, if any
+     */
+    std::optional<int64_t> GetLastTime(void) const;
+
+    /**
+     * @return
+     * The last position added. Only meaningful if `GetLastTime()` is set
+     */
+    const Vector3D& GetLastPosition(void) const;
+
+  private:
+    /**
+     * Start a new segment at `time` & `position`
+     *
+     * @param time
+     * The start of the segment, in nanoseconds
+     *
+     * @param position
+     * The position at `time`
+     */
+    void Start(int64_t time, const Vector3D& position);
+
+    /**
+     * @return
+     * The current segment, ending at the last position added
+     */
+    Segment Close(void) const;
+
+    /**
+     * The furthest a position may be from its segment
+     */
+    double m_maxError;
+
+    /**
+     * Flag indicating a segment has been started
+     */
+    bool m_open{false};
+
+    /**
+     * Start of the current segment, in nanoseconds
+     */
+    int64_t m_startTime{0};
+
+    /**
+     * Position at the start of the current segment
+     */
+    Vector3D m_startPosition;
+
+    /**
+     * Time of the last position added, in nanoseconds
+     */
+    int64_t m_lastTime{0};
+
+    /**
+     * The last position added
+     */
+    Vector3D m_lastPosition;
+
+    /**
+     * Lowest velocity on each axis which keeps every position within the error
+     */
+    Vector3D m_minVelocity;
+
+    /**
+     * Highest velocity on each axis which keeps every position within the error
+     */
+    Vector3D m_maxVelocity;
+};
+
+} // namespace ns3::netsimulyzer
+
+#endif // TRAJECTORY_SIMPLIFIER_H
@@ -0,0 +1,126 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "worker-pool.h"
+
+namespace ns3::netsimulyzer
+{
+
+WorkerPool::WorkerPool(std::size_t threads)
+{
+    for (std::size_t i = 1u; i < threads; i++)
+    {
+        m_workers.emplace_back(&WorkerPool::RunWorker, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard lock{m_mutex};
+        m_stopping = true;
+    }
+    m_batchStarted.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+std::size_t
+WorkerPool::GetThreadCount(void) const
+{
+    return m_workers.size() + 1u;
+}
+
+void
+WorkerPool::Run(std::size_t tasks, const std::function<void(std::size_t)>& task)
+{
+    {
+        std::lock_guard lock{m_mutex};
+        m_task = &task;
+        m_taskCount = tasks;
+        m_nextTask.store(0u, std::memory_order_relaxed);
+        m_activeWorkers = m_workers.size();
+        m_batch++;
+    }
+    m_batchStarted.notify_all();
+
+    Work();
+
+    std::unique_lock lock{m_mutex};
+    m_batchFinished.wait(lock, [this]() { return m_activeWorkers == 0u; });
+    m_task = nullptr;
+}
+
+void
+WorkerPool::RunWorker(void)
+{
+    uint64_t lastBatch = 0u;
+    while (true)
+    {
+        {
+            std::unique_lock lock{m_mutex};
+            m_batchStarted.wait(lock, [this, lastBatch]() {
+                return m_stopping || m_batch != lastBatch;
+            });
+
+            if (m_stopping)
+            {
+                return;
+            }
+            lastBatch = m_batch;
+        }
+
+        Work();
+
+        std::lock_guard lock{m_mutex};
+        if (--m_activeWorkers == 0u)
+        {
+            m_batchFinished.notify_one();
+        }
+    }
+}
+
+void
+WorkerPool::Work(void)
+{
+    for (auto i = m_nextTask.fetch_add(1u, std::memory_order_relaxed); i < m_taskCount;
+         i = m_nextTask.fetch_add(1u, std::memory_order_relaxed))
+    {
+        (*m_task)(i);
+    }
+}
+
+} // namespace ns3::netsimulyzer
@@ -0,0 +1,161 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3::netsimulyzer
+{
+
+/**
+ * A small, fixed set of threads which run
+ * the tasks of a single batch at a time.
+ *
+ * The thread calling `Run()` works on the batch as well,
+ * & does not return until every task in it is finished
+ */
+class WorkerPool
+{
+  public:
+    /**
+     * Start the worker threads
+     *
+     * @param threads
+     * The number of threads to run each batch on, including the thread calling `Run()`.
+     * One or fewer runs every task on the calling thread
+     */
+    explicit WorkerPool(std::size_t threads);
+
+    /**
+     * Stop & join the worker threads
+     */
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @return
+     * The number of threads each batch runs on, including the calling thread
+     */
+    std::size_t GetThreadCount(void) const;
+
+    /**
+     * Run `task` once for each index in [0, `tasks`), spread across the threads.
+     * Returns once every task has finished.
+     *
+     * Tasks may run in any order, on any thread, so they must not
+     * touch anything shared with another task
+     *
+     * @param tasks
+     * The number of tasks to run
+     *
+     * @param task
+     * Called with the index of each task
+     */
+    void Run(std::size_t tasks, const std::function<void(std::size_t)>& task);
+
+  private:
+    /**
+     * Loop run by each worker thread, waiting for a batch then working on it
+     */
+    void RunWorker(void);
+
+    /**
+     * Claim & run tasks from the current batch until none are left
+     */
+    void Work(void);
+
+    /**
+     * The worker threads, not including the thread calling `Run()`
+     */
+    std::vector<std::thread> m_workers;
+
+    /**
+     * Guards the batch state below, other than `m_nextTask`
+     */
+    std::mutex m_mutex;
+
+    /**
+     * Notified when a batch starts, or the pool is stopping
+     */
+    std::condition_variable m_batchStarted;
+
+    /**
+     * Notified when the last worker finishes a batch
+     */
+    std::condition_variable m_batchFinished;
+
+    /**
+     * The task of the current batch
+     */
+    const std::function<void(std::size_t)>* m_task{nullptr};
+
+    /**
+     * The number of tasks in the current batch
+     */
+    std::size_t m_taskCount{0u};
+
+    /**
+     * The index of the next task to claim
+     */
+    std::atomic<std::size_t> m_nextTask{0u};
+
+    /**
+     * The number of workers still working on the current batch
+     */
+    std::size_t m_activeWorkers{0u};
+
+    /**
+     * Incremented for each batch, so workers know when a new one starts
+     */
+    uint64_t m_batch{0u};
+
+    /**
+     * Flag to stop the workers
+     */
+    bool m_stopping{false};
+};
+
+} // namespace ns3::netsimulyzer
+
+#endif
@@ -33,6 +33,7 @@
 #define XY_SERIES_H
 
 #include "color.h"
+#include "event-message.h"
 #include "orchestrator.h"
 #include "value-axis.h"
 
@@ -49,15 +50,6 @@ namespace ns3::netsimulyzer
 class Orchestrator;
 class ValueAxis;
 
-/**
- * Representation of a single point on an XYSeries
- */
-struct XYPoint
-{
-    double x;
-    double y;
-};
-
 class XYSeries : public ns3::Object
 {
   public:
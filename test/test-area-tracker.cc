@@ -0,0 +1,218 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "netsimulyzer-test-utils.h"
+
+#include "ns3/core-module.h"
+#include "ns3/netsimulyzer-module.h"
+#include "ns3/netsimulyzer-ns3-compatibility.h"
+#include "ns3/rectangle.h"
+#include "ns3/test.h"
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace ns3::test
+{
+
+using namespace netsimulyzer;
+
+class TestCaseAreaTrackerFind : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseAreaTrackerFind();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseAreaTrackerFind::TestCaseAreaTrackerFind()
+    : NetSimulyzerTestCase("NetSimulyzer Area Tracker - Find areas containing a point")
+{
+}
+
+void
+TestCaseAreaTrackerFind::DoRun()
+{
+    AreaTracker tracker;
+    tracker.Add(1u, Rectangle{0.0, 10.0, 0.0, 10.0});
+    tracker.Add(2u, Rectangle{5.0, 25.0, 5.0, 8.0});
+    tracker.Add(3u, Rectangle{-40.0, -30.0, -40.0, -30.0});
+
+    // Smaller than the areas, so each spans several cells
+    tracker.Build(3.0);
+    NS_TEST_ASSERT_MSG_EQ(tracker.GetSize(), 3u, "Every area should be tracked");
+
+    std::vector<uint32_t> areas;
+    tracker.Find(1.0, 1.0, areas);
+    NS_TEST_ASSERT_MSG_EQ((areas == std::vector<uint32_t>{1u}), true, "Only inside area 1");
+
+    tracker.Find(6.0, 6.0, areas);
+    NS_TEST_ASSERT_MSG_EQ((areas == std::vector<uint32_t>{1u, 2u}), true, "Inside both areas");
+
+    tracker.Find(25.0, 8.0, areas);
+    NS_TEST_ASSERT_MSG_EQ((areas == std::vector<uint32_t>{2u}), true, "Corners are inside");
+
+    tracker.Find(-35.0, -35.0, areas);
+    NS_TEST_ASSERT_MSG_EQ((areas == std::vector<uint32_t>{3u}), true, "Only inside area 3");
+
+    tracker.Find(12.0, 12.0, areas);
+    NS_TEST_ASSERT_MSG_EQ(areas.empty(), true, "Outside every area");
+
+    // The same areas found with the cell size picked by the tracker
+    tracker.Build(0.0);
+    NS_TEST_ASSERT_MSG_GT(tracker.GetCellSize(), 0.0, "A cell size should be picked");
+    tracker.Find(6.0, 6.0, areas);
+    NS_TEST_ASSERT_MSG_EQ((areas == std::vector<uint32_t>{1u, 2u}), true, "Inside both areas");
+    tracker.Find(12.0, 12.0, areas);
+    NS_TEST_ASSERT_MSG_EQ(areas.empty(), true, "Outside every area");
+}
+
+class TestCaseAreaTrackerUpdate : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseAreaTrackerUpdate();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseAreaTrackerUpdate::TestCaseAreaTrackerUpdate()
+    : NetSimulyzerTestCase("NetSimulyzer Area Tracker - Nodes enter & exit areas")
+{
+}
+
+void
+TestCaseAreaTrackerUpdate::DoRun()
+{
+    AreaTracker tracker;
+    tracker.Add(1u, Rectangle{0.0, 10.0, 0.0, 10.0});
+    tracker.Add(2u, Rectangle{5.0, 25.0, 5.0, 8.0});
+    tracker.Build(0.0);
+
+    // {area ID, entered}
+    std::vector<std::pair<uint32_t, bool>> changes;
+    const auto record = [&changes](uint32_t areaId, bool entered) {
+        changes.emplace_back(areaId, entered);
+    };
+
+    auto inside = tracker.Update(7u, {-5.0, -5.0, 0.0}, record);
+    NS_TEST_ASSERT_MSG_EQ(inside, false, "Outside before & after");
+    NS_TEST_ASSERT_MSG_EQ(changes.empty(), true, "Nothing should be crossed");
+    NS_TEST_ASSERT_MSG_EQ(tracker.IsInside(7u), false, "Node should be outside");
+
+    inside = tracker.Update(7u, {6.0, 6.0, 0.0}, record);
+    NS_TEST_ASSERT_MSG_EQ(inside, true, "Node moved inside");
+    NS_TEST_ASSERT_MSG_EQ(changes.size(), 2u, "Both areas should be entered");
+    NS_TEST_ASSERT_MSG_EQ((changes[0] == std::pair{1u, true}), true, "Area 1 entered");
+    NS_TEST_ASSERT_MSG_EQ((changes[1] == std::pair{2u, true}), true, "Area 2 entered");
+    NS_TEST_ASSERT_MSG_EQ(tracker.IsInside(7u), true, "Node should be inside");
+
+    changes.clear();
+    inside = tracker.Update(7u, {20.0, 6.0, 0.0}, record);
+    NS_TEST_ASSERT_MSG_EQ(inside, true, "Node is still inside area 2");
+    NS_TEST_ASSERT_MSG_EQ(changes.size(), 1u, "Only area 1 should be exited");
+    NS_TEST_ASSERT_MSG_EQ((changes[0] == std::pair{1u, false}), true, "Area 1 exited");
+
+    changes.clear();
+    inside = tracker.Update(7u, {20.0, 6.5, 0.0}, record);
+    NS_TEST_ASSERT_MSG_EQ(inside, true, "Node is still inside area 2");
+    NS_TEST_ASSERT_MSG_EQ(changes.empty(), true, "Moving within an area crosses nothing");
+
+    changes.clear();
+    inside = tracker.Update(7u, {30.0, 30.0, 0.0}, record);
+    NS_TEST_ASSERT_MSG_EQ(inside, true, "Node was inside before the move");
+    NS_TEST_ASSERT_MSG_EQ(changes.size(), 1u, "Area 2 should be exited");
+    NS_TEST_ASSERT_MSG_EQ((changes[0] == std::pair{2u, false}), true, "Area 2 exited");
+    NS_TEST_ASSERT_MSG_EQ(tracker.IsInside(7u), false, "Node should be outside");
+}
+
+class TestCaseAreaTrackerLargeAreas : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseAreaTrackerLargeAreas();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseAreaTrackerLargeAreas::TestCaseAreaTrackerLargeAreas()
+    : NetSimulyzerTestCase("NetSimulyzer Area Tracker - Large & unbounded areas")
+{
+}
+
+void
+TestCaseAreaTrackerLargeAreas::DoRun()
+{
+    AreaTracker tracker;
+    tracker.Add(1u, Rectangle{-1e6, 1e6, -1e6, 1e6});
+    tracker.Add(2u, Rectangle{0.0, 1.0, 0.0, 1.0});
+    tracker.Add(3u, Rectangle{-std::numeric_limits<double>::infinity(),
+                              std::numeric_limits<double>::infinity(),
+                              -5.0,
+                              5.0});
+
+    // Far too many cells for area 1, so they should be made larger
+    tracker.Build(1e-3);
+    NS_TEST_ASSERT_MSG_GT(tracker.GetCellSize(), 1e-3, "The cells should be made larger");
+
+    std::vector<uint32_t> areas;
+    tracker.Find(0.5, 0.5, areas);
+    NS_TEST_ASSERT_MSG_EQ((areas == std::vector<uint32_t>{1u, 2u, 3u}), true, "Inside every area");
+
+    tracker.Find(1e12, 1.0, areas);
+    NS_TEST_ASSERT_MSG_EQ((areas == std::vector<uint32_t>{3u}), true, "Only inside area 3");
+
+    tracker.Find(-1e5, 1e5, areas);
+    NS_TEST_ASSERT_MSG_EQ((areas == std::vector<uint32_t>{1u}), true, "Only inside area 1");
+}
+
+class AreaTrackerTestSuite : public TestSuite
+{
+  public:
+    AreaTrackerTestSuite();
+};
+
+AreaTrackerTestSuite::AreaTrackerTestSuite()
+    : TestSuite("netsimulyzer-area-tracker", TEST_TYPE_UNIT)
+{
+    AddTestCase(new TestCaseAreaTrackerFind{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseAreaTrackerUpdate{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseAreaTrackerLargeAreas{}, TEST_DURATION_QUICK);
+}
+
+static AreaTrackerTestSuite g_areaTrackerTestSuite{};
+
+} // namespace ns3::test
@@ -0,0 +1,226 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "netsimulyzer-test-utils.h"
+
+#include "ns3/core-module.h"
+#include "ns3/netsimulyzer-module.h"
+#include "ns3/netsimulyzer-ns3-compatibility.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ns3::test
+{
+
+using namespace netsimulyzer;
+
+class TestCaseBinaryRoundTrip : public NetSimulyzerTestCase
+{
+  public:
+    explicit TestCaseBinaryRoundTrip(BinaryFormat::Encoding encoding);
+
+  private:
+    void DoRun() override;
+    BinaryFormat::Encoding m_encoding;
+};
+
+TestCaseBinaryRoundTrip::TestCaseBinaryRoundTrip(BinaryFormat::Encoding encoding)
+    : NetSimulyzerTestCase(
+          std::string{"NetSimulyzer Binary Output - Converts back to the JSON output - "} +
+          (encoding == BinaryFormat::Encoding::Raw ? "Raw" : "Delta")),
+      m_encoding(encoding)
+{
+}
+
+void
+TestCaseBinaryRoundTrip::DoRun()
+{
+    const nlohmann::json header{{"nodes", {{{"id", 0}, {"type", "node"}}}},
+                                {"areas", nlohmann::json::array()}};
+    const nlohmann::json trailer{{"configuration", {{"max-time", 5000}}},
+                                 {"series", nlohmann::json::array()}};
+
+    // Interleave the block types, so the original order
+    // must be restored from the sequence numbers
+    const std::vector<EventRecord> events{
+        CourseChangeEvent{NanoSeconds(0), 0u, {1.0, 2.0, 3.0}},
+        XYSeriesAppendEvent{NanoSeconds(10), 4u, 0.5, -0.5},
+        NodeModelChangeEvent{NanoSeconds(10), 0u, "models/a.obj"},
+        CourseChangeEvent{NanoSeconds(20), 0u, {1.5, 2.0, 3.0}},
+        CourseChangeEvent{NanoSeconds(30), 1u, {-7.25, 0.0, 1e-5}},
+        XYSeriesAppendArrayEvent{NanoSeconds(40), 4u, {{1.0, 2.0}, {3.0, 4.0}}},
+        XYSeriesAppendEvent{NanoSeconds(50), 4u, 1.0, 1.0},
+        CourseChangeEvent{NanoSeconds(60), 0u, {2.0, 2.0, 3.0}},
+        LogMessageEvent{NanoSeconds(70), 2u, "done\n"},
+        CourseChangeEvent{NanoSeconds(80), 1u, {-8.0, 0.1, 0.2}},
+        XYSeriesAppendEvent{NanoSeconds(90), 3u, 0.0, 0.0},
+        CourseChangeEvent{NanoSeconds(100), 0u, {1.0, 2.0, 3.0}},
+    };
+
+    std::string expectedEvents;
+    JsonEventEmitter emitter{expectedEvents};
+
+    // Small blocks, so each type spans multiple blocks
+    std::stringstream file{std::ios::in | std::ios::out | std::ios::binary};
+    BinaryOutputWriter writer{file, 2u, m_encoding};
+    writer.WriteHeader(header);
+    for (const auto& event : events)
+    {
+        if (!expectedEvents.empty())
+        {
+            expectedEvents.push_back(',');
+        }
+        emitter.Write(event);
+        writer.Write(event);
+    }
+    writer.Finish(trailer);
+
+    file.seekg(0);
+    BinaryOutputReader reader{file};
+    NS_TEST_ASSERT_MSG_EQ(reader.GetHeader(), header, "Header should be read back unchanged");
+    NS_TEST_ASSERT_MSG_EQ(reader.GetTrailer(), trailer, "Trailer should be read back unchanged");
+
+    std::size_t indexedEvents = 0u;
+    for (const auto& entry : reader.GetIndex())
+    {
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(entry.count, 2u, "Blocks should not exceed the block size");
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(entry.firstNanoseconds,
+                                    entry.lastNanoseconds,
+                                    "Block time range should be ordered");
+        indexedEvents += entry.count;
+    }
+    NS_TEST_ASSERT_MSG_EQ(indexedEvents, events.size(), "Every event should be in the index");
+
+    std::ostringstream converted;
+    reader.WriteJson(converted);
+
+    // Built the same way `Orchestrator::Flush ()` writes the JSON output
+    const auto expected = R"({"areas":[],"configuration":{"max-time":5000},"events":[)" +
+                          expectedEvents +
+                          R"(],"nodes":[{"id":0,"type":"node"}],"series":[]})";
+    NS_TEST_ASSERT_MSG_EQ(converted.str(), expected, "Converted output should match JSON output");
+}
+
+class TestCaseBinaryPositionResolution : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseBinaryPositionResolution();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseBinaryPositionResolution::TestCaseBinaryPositionResolution()
+    : NetSimulyzerTestCase("NetSimulyzer Binary Output - Positions are rounded to the resolution")
+{
+}
+
+void
+TestCaseBinaryPositionResolution::DoRun()
+{
+    constexpr auto resolution = 0.001;
+    constexpr auto nodes = 3u;
+    constexpr auto steps = 50u;
+
+    std::stringstream file{std::ios::in | std::ios::out | std::ios::binary};
+    BinaryOutputWriter writer{file, 16u, BinaryFormat::Encoding::Delta, resolution};
+    writer.WriteHeader(nlohmann::json::object());
+
+    std::vector<Vector> positions;
+    for (auto step = 0u; step < steps; step++)
+    {
+        for (auto node = 0u; node < nodes; node++)
+        {
+            // Mix small moves with large jumps, and negative coordinates
+            const auto t = static_cast<double>(step);
+            const Vector position{std::sin(t * 0.1 + node) * 100.0 - 12.3456789,
+                                   t * 0.0123456 * (node + 1),
+                                   step % 10 == 0 ? -1e4 : 1.5};
+            positions.emplace_back(position);
+            writer.Write(CourseChangeEvent{MilliSeconds(step * 100), node, position});
+        }
+    }
+    writer.Finish(nlohmann::json::object());
+
+    file.seekg(0);
+    BinaryOutputReader reader{file};
+    std::ostringstream converted;
+    reader.WriteJson(converted);
+
+    const auto events = nlohmann::json::parse(converted.str())["events"];
+    NS_TEST_ASSERT_MSG_EQ(events.size(), positions.size(), "Every position should be read back");
+
+    for (auto i = 0u; i < events.size(); i++)
+    {
+        const auto& event = events[i];
+        NS_TEST_ASSERT_MSG_EQ(event["id"].get<uint32_t>(), i % nodes, "Ids should be exact");
+        NS_TEST_ASSERT_MSG_EQ(event["nanoseconds"].get<int64_t>(),
+                              MilliSeconds(i / nodes * 100).GetNanoSeconds(),
+                              "Times should be exact");
+        NS_TEST_ASSERT_MSG_EQ_TOL(event["x"].get<double>(),
+                                  positions[i].x,
+                                  resolution / 2.0 + 1e-9,
+                                  "X should be within half the resolution");
+        NS_TEST_ASSERT_MSG_EQ_TOL(event["y"].get<double>(),
+                                  positions[i].y,
+                                  resolution / 2.0 + 1e-9,
+                                  "Y should be within half the resolution");
+        NS_TEST_ASSERT_MSG_EQ_TOL(event["z"].get<double>(),
+                                  positions[i].z,
+                                  resolution / 2.0 + 1e-9,
+                                  "Z should be within half the resolution");
+    }
+}
+
+class BinaryOutputTestSuite : public TestSuite
+{
+  public:
+    BinaryOutputTestSuite();
+};
+
+BinaryOutputTestSuite::BinaryOutputTestSuite()
+    : TestSuite("netsimulyzer-binary-output", TEST_TYPE_UNIT)
+{
+    AddTestCase(new TestCaseBinaryRoundTrip{BinaryFormat::Encoding::Raw}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseBinaryRoundTrip{BinaryFormat::Encoding::Delta}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseBinaryPositionResolution{}, TEST_DURATION_QUICK);
+}
+
+static BinaryOutputTestSuite g_binaryOutputTestSuite{};
+
+} // namespace ns3::test
@@ -0,0 +1,558 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "netsimulyzer-test-utils.h"
+
+#include "ns3/core-module.h"
+#include "ns3/netsimulyzer-module.h"
+#include "ns3/netsimulyzer-ns3-compatibility.h"
+#include "ns3/test.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3::test
+{
+
+using namespace netsimulyzer;
+
+class TestCaseFenwickTree : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseFenwickTree();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseFenwickTree::TestCaseFenwickTree()
+    : NetSimulyzerTestCase("NetSimulyzer Fenwick Tree - Counts match a plain array")
+{
+}
+
+void
+TestCaseFenwickTree::DoRun()
+{
+    FenwickTree tree;
+    std::vector<uint64_t> expected;
+
+    tree.Extend(13u);
+    expected.resize(13u, 0u);
+    for (auto i = 0u; i < 13u; i++)
+    {
+        tree.Add(i, i * 3u % 7u);
+        expected[i] += i * 3u % 7u;
+    }
+
+    // Growing in either direction keeps the existing counts
+    tree.Prepend(5u);
+    expected.insert(expected.begin(), 5u, 0u);
+    tree.Extend(6u);
+    expected.resize(expected.size() + 6u, 0u);
+    tree.Add(0u, 4u);
+    expected[0u] += 4u;
+    tree.Add(20u, 2u);
+    expected[20u] += 2u;
+
+    NS_TEST_ASSERT_MSG_EQ(tree.GetSize(), expected.size(), "Size should include added indices");
+
+    uint64_t sum = 0u;
+    for (auto i = 0u; i < expected.size(); i++)
+    {
+        sum += expected[i];
+        NS_TEST_ASSERT_MSG_EQ(tree.Get(i), expected[i], "Count of index " << i);
+        NS_TEST_ASSERT_MSG_EQ(tree.GetPrefixSum(i), sum, "Sum up to index " << i);
+    }
+}
+
+class TestCaseEcdfSinkPoints : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseEcdfSinkPoints();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseEcdfSinkPoints::TestCaseEcdfSinkPoints()
+    : NetSimulyzerTestCase("NetSimulyzer ECDF Sink - Points are sorted & cumulative")
+{
+}
+
+void
+TestCaseEcdfSinkPoints::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    auto ecdf = CreateObject<EcdfSink>(o, "ECDF");
+    ecdf->SetAttribute("FlushMode", EnumValue(EcdfSink::FlushMode::Manual));
+
+    UintegerValue seriesId;
+    ecdf->GetSeries()->GetAttribute("Id", seriesId);
+
+    Simulator::Schedule(Seconds(1), [ecdf]() {
+        for (const auto value : {3.0, 1.0, 2.0, 2.0})
+        {
+            ecdf->Append(value);
+        }
+        ecdf->Flush();
+    });
+
+    Simulator::Stop(Seconds(2));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(ecdf->GetCdf(0.5), 0.0, "No values below the smallest");
+    NS_TEST_ASSERT_MSG_EQ(ecdf->GetCdf(2.0), 0.75, "Values equal to 2.0 are included");
+    NS_TEST_ASSERT_MSG_EQ(ecdf->GetCdf(2.5), 0.75, "No values between 2.0 & 3.0");
+    NS_TEST_ASSERT_MSG_EQ(ecdf->GetCdf(3.0), 1.0, "Every value is at or below the largest");
+
+    auto batches = 0u;
+    std::vector<std::pair<double, double>> points;
+    for (const auto& event : o->GetJson()["events"])
+    {
+        if (event["type"].get<std::string>() == "xy-series-append-array" &&
+            event["series-id"].get<uint64_t>() == seriesId.Get())
+        {
+            batches++;
+            for (const auto& point : event["points"])
+            {
+                points.emplace_back(point["x"].get<double>(), point["y"].get<double>());
+            }
+        }
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(batches, 1u, "A flush should write a single batch");
+
+    // A step for each distinct value
+    const std::vector<std::pair<double, double>> expected{{1.0, 0.0},
+                                                          {1.0, 0.25},
+                                                          {2.0, 0.25},
+                                                          {2.0, 0.75},
+                                                          {3.0, 0.75},
+                                                          {3.0, 1.0}};
+    NS_TEST_ASSERT_MSG_EQ(points.size(), expected.size(), "Two points per distinct value");
+    for (auto i = 0u; i < std::min(points.size(), expected.size()); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(points[i].first, expected[i].first, "X of point " << i);
+        NS_TEST_ASSERT_MSG_EQ(points[i].second, expected[i].second, "Y of point " << i);
+    }
+
+    Simulator::Destroy();
+}
+
+class TestCaseEcdfSinkMinFlushInterval : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseEcdfSinkMinFlushInterval();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseEcdfSinkMinFlushInterval::TestCaseEcdfSinkMinFlushInterval()
+    : NetSimulyzerTestCase("NetSimulyzer ECDF Sink - `MinFlushInterval` limits writes")
+{
+}
+
+void
+TestCaseEcdfSinkMinFlushInterval::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    auto ecdf = CreateObject<EcdfSink>(o, "ECDF");
+    ecdf->SetAttribute("MinFlushInterval", TimeValue(Seconds(1)));
+
+    UintegerValue seriesId;
+    ecdf->GetSeries()->GetAttribute("Id", seriesId);
+
+    // The first append is written immediately,
+    // the next two together once the interval passes
+    for (const auto ms : {100, 200, 300, 1500})
+    {
+        Simulator::Schedule(MilliSeconds(ms), [ecdf, ms]() { ecdf->Append(ms); });
+    }
+
+    // Nothing changed since the last flush
+    Simulator::Schedule(MilliSeconds(2500), [ecdf]() { ecdf->Flush(); });
+
+    Simulator::Stop(Seconds(3));
+    Simulator::Run();
+
+    std::vector<std::pair<int64_t, std::size_t>> batches;
+    for (const auto& event : o->GetJson()["events"])
+    {
+        if (event["type"].get<std::string>() == "xy-series-append-array" &&
+            event["series-id"].get<uint64_t>() == seriesId.Get())
+        {
+            batches.emplace_back(event["nanoseconds"].get<int64_t>(), event["points"].size());
+        }
+    }
+
+    const std::vector<std::pair<int64_t, std::size_t>> expected{
+        {MilliSeconds(100).GetNanoSeconds(), 2u},
+        {MilliSeconds(1100).GetNanoSeconds(), 6u},
+        {MilliSeconds(2100).GetNanoSeconds(), 8u}};
+    NS_TEST_ASSERT_MSG_EQ(batches.size(), expected.size(), "One batch per interval with appends");
+    for (auto i = 0u; i < std::min(batches.size(), expected.size()); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(batches[i].first, expected[i].first, "Time of batch " << i);
+        NS_TEST_ASSERT_MSG_EQ(batches[i].second, expected[i].second, "Points in batch " << i);
+    }
+
+    Simulator::Destroy();
+}
+
+class TestCaseEcdfSinkIntervalWindow : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseEcdfSinkIntervalWindow();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseEcdfSinkIntervalWindow::TestCaseEcdfSinkIntervalWindow()
+    : NetSimulyzerTestCase("NetSimulyzer ECDF Sink - `Interval` flushes inside the window")
+{
+}
+
+void
+TestCaseEcdfSinkIntervalWindow::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    o->SetAttribute("StartTime", TimeValue(Seconds(2)));
+    o->SetAttribute("StopTime", TimeValue(Seconds(3)));
+
+    auto ecdf = CreateObject<EcdfSink>(o, "ECDF");
+    ecdf->SetAttribute("FlushMode", EnumValue(EcdfSink::FlushMode::Interval));
+    ecdf->SetAttribute("Interval", TimeValue(Seconds(1)));
+
+    UintegerValue seriesId;
+    ecdf->GetSeries()->GetAttribute("Id", seriesId);
+
+    Simulator::Schedule(MilliSeconds(500), [ecdf]() { ecdf->Append(1.0); });
+    Simulator::Schedule(MilliSeconds(2500), [ecdf]() { ecdf->Append(2.0); });
+    Simulator::Schedule(MilliSeconds(3500), [ecdf]() { ecdf->Append(3.0); });
+
+    Simulator::Stop(Seconds(10));
+    Simulator::Run();
+
+    std::vector<int64_t> flushes;
+    for (const auto& event : o->GetJson()["events"])
+    {
+        if (event["type"].get<std::string>() == "xy-series-append-array" &&
+            event["series-id"].get<uint64_t>() == seriesId.Get())
+        {
+            flushes.emplace_back(event["nanoseconds"].get<int64_t>());
+            NS_TEST_ASSERT_MSG_EQ(event["points"].size(), 4u, "Values before the window count");
+        }
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(flushes.size(), 1u, "Only flushed inside the window");
+    NS_TEST_ASSERT_MSG_EQ(flushes.front(), Seconds(3).GetNanoSeconds(), "Flushed at the stop");
+
+    Simulator::Destroy();
+}
+
+class TestCaseEcdfSinkBinned : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseEcdfSinkBinned();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseEcdfSinkBinned::TestCaseEcdfSinkBinned()
+    : NetSimulyzerTestCase("NetSimulyzer ECDF Sink - `BinWidth` rounds values into bins")
+{
+}
+
+void
+TestCaseEcdfSinkBinned::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    auto ecdf = CreateObject<EcdfSink>(o, "ECDF");
+    ecdf->SetAttribute("FlushMode", EnumValue(EcdfSink::FlushMode::Manual));
+    ecdf->SetAttribute("BinWidth", DoubleValue(1.0));
+
+    // Grows the bins up, then down
+    for (const auto value : {0.9, 1.1, 2.6, -1.2})
+    {
+        ecdf->Append(value);
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(ecdf->GetCdf(-5.0), 0.0, "No values below the first bin");
+    NS_TEST_ASSERT_MSG_EQ(ecdf->GetCdf(-1.0), 0.25, "-1.2 rounds to -1");
+    NS_TEST_ASSERT_MSG_EQ(ecdf->GetCdf(1.0), 0.75, "0.9 & 1.1 round to 1");
+    NS_TEST_ASSERT_MSG_EQ(ecdf->GetCdf(2.0), 0.75, "2.6 rounds to 3");
+    NS_TEST_ASSERT_MSG_EQ(ecdf->GetCdf(100.0), 1.0, "Every value is below the last bin");
+
+    // Queries far outside the bins, or not finite, are not rounded into a bin
+    constexpr auto infinity = std::numeric_limits<double>::infinity();
+    NS_TEST_ASSERT_MSG_EQ(ecdf->GetCdf(1e300), 1.0, "Every value is below a huge value");
+    NS_TEST_ASSERT_MSG_EQ(ecdf->GetCdf(infinity), 1.0, "Every value is below infinity");
+    NS_TEST_ASSERT_MSG_EQ(ecdf->GetCdf(-infinity), 0.0, "No value is below -infinity");
+    NS_TEST_ASSERT_MSG_EQ(ecdf->GetCdf(std::numeric_limits<double>::quiet_NaN()),
+                          0.0,
+                          "No value compares below NaN");
+
+    Simulator::Destroy();
+}
+
+class TestCaseEcdfSinkManyAppends : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseEcdfSinkManyAppends();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseEcdfSinkManyAppends::TestCaseEcdfSinkManyAppends()
+    : NetSimulyzerTestCase("NetSimulyzer ECDF Sink - Millions of appends finish in seconds")
+{
+}
+
+void
+TestCaseEcdfSinkManyAppends::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    auto exact = CreateObject<EcdfSink>(o, "Exact");
+    exact->SetAttribute("FlushMode", EnumValue(EcdfSink::FlushMode::Manual));
+    auto binned = CreateObject<EcdfSink>(o, "Binned");
+    binned->SetAttribute("FlushMode", EnumValue(EcdfSink::FlushMode::Manual));
+    binned->SetAttribute("BinWidth", DoubleValue(0.01));
+
+    constexpr auto count = 2'000'000u;
+    const auto start = std::chrono::steady_clock::now();
+    for (auto i = 0u; i < count; i++)
+    {
+        // Spread over 100,000 distinct values in [0, 100)
+        const auto value = static_cast<double>(i * 7919u % 100'000u) / 1'000.0;
+        exact->Append(value);
+        binned->Append(value);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    NS_TEST_ASSERT_MSG_LT(std::chrono::duration_cast<std::chrono::seconds>(elapsed).count(),
+                          10,
+                          "Appends should not grow with the number of distinct values");
+    NS_TEST_ASSERT_MSG_EQ_TOL(exact->GetCdf(49.999), 0.5, 1e-9, "Half the values are below 50");
+    NS_TEST_ASSERT_MSG_EQ_TOL(binned->GetCdf(49.99), 0.5, 1e-3, "Bins should match the values");
+
+    Simulator::Destroy();
+}
+
+class TestCaseDdSketch : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseDdSketch();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseDdSketch::TestCaseDdSketch()
+    : NetSimulyzerTestCase("NetSimulyzer DDSketch - Quantiles are within the relative error")
+{
+}
+
+void
+TestCaseDdSketch::DoRun()
+{
+    DdSketch sketch{0.01};
+    NS_TEST_ASSERT_MSG_EQ(sketch.GetQuantile(0.5), 0.0, "An empty sketch has no quantiles");
+
+    // -1000 to 99,999, with 0 counted as well
+    constexpr auto count = 101'000u;
+    for (auto i = 0u; i < count; i++)
+    {
+        sketch.Add(static_cast<double>(i) - 1'000.0);
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(sketch.GetCount(), count, "Every value should be counted");
+    NS_TEST_ASSERT_MSG_LT(sketch.GetBucketCount(), 2'000u, "Buckets should follow magnitudes");
+
+    std::vector<double> quantiles;
+    sketch.GetQuantiles(100u, quantiles);
+    NS_TEST_ASSERT_MSG_EQ(quantiles.size(), 100u, "One value per quantile");
+
+    for (auto k = 1u; k <= 100u; k++)
+    {
+        const auto q = static_cast<double>(k) / 100.0;
+        const auto expected = std::floor(q * (count - 1u)) - 1'000.0;
+
+        NS_TEST_ASSERT_MSG_EQ_TOL(sketch.GetQuantile(q),
+                                  expected,
+                                  std::abs(expected) * 0.01,
+                                  "Quantile " << q);
+        NS_TEST_ASSERT_MSG_EQ(quantiles[k - 1u],
+                              sketch.GetQuantile(q),
+                              "One pass should match single quantiles");
+    }
+
+    NS_TEST_ASSERT_MSG_EQ_TOL(sketch.GetCdf(0.0), 1'001.0 / count, 1e-9, "Values up to 0");
+}
+
+class TestCaseDdSketchInfinity : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseDdSketchInfinity();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseDdSketchInfinity::TestCaseDdSketchInfinity()
+    : NetSimulyzerTestCase("NetSimulyzer DDSketch - Infinite values are counted at the ends")
+{
+}
+
+void
+TestCaseDdSketchInfinity::DoRun()
+{
+    constexpr auto infinity = std::numeric_limits<double>::infinity();
+    DdSketch sketch{0.01};
+
+    for (auto i = 1u; i <= 8u; i++)
+    {
+        sketch.Add(static_cast<double>(i));
+    }
+    sketch.Add(infinity);
+    sketch.Add(-infinity);
+    sketch.Add(infinity);
+
+    NS_TEST_ASSERT_MSG_EQ(sketch.GetCount(), 11u, "Every value should be counted");
+    NS_TEST_ASSERT_MSG_EQ(sketch.GetBucketCount(), 10u, "One bucket for each infinity");
+
+    NS_TEST_ASSERT_MSG_EQ(sketch.GetQuantile(0.0), -infinity, "Smallest value is -infinity");
+    NS_TEST_ASSERT_MSG_EQ(sketch.GetQuantile(1.0), infinity, "Largest value is infinity");
+    NS_TEST_ASSERT_MSG_EQ_TOL(sketch.GetQuantile(0.5), 5.0, 5.0 * 0.01, "Median is unchanged");
+
+    NS_TEST_ASSERT_MSG_EQ_TOL(sketch.GetCdf(-infinity), 1.0 / 11.0, 1e-9, "Only -infinity");
+    NS_TEST_ASSERT_MSG_EQ_TOL(sketch.GetCdf(100.0), 9.0 / 11.0, 1e-9, "Every finite value");
+    NS_TEST_ASSERT_MSG_EQ(sketch.GetCdf(infinity), 1.0, "Every value is at most infinity");
+}
+
+class TestCaseEcdfSinkSketch : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseEcdfSinkSketch();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseEcdfSinkSketch::TestCaseEcdfSinkSketch()
+    : NetSimulyzerTestCase("NetSimulyzer ECDF Sink - `SketchRelativeError` draws quantiles")
+{
+}
+
+void
+TestCaseEcdfSinkSketch::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    auto ecdf = CreateObject<EcdfSink>(o, "ECDF");
+    ecdf->SetAttribute("FlushMode", EnumValue(EcdfSink::FlushMode::Manual));
+    ecdf->SetAttribute("SketchRelativeError", DoubleValue(0.01));
+    ecdf->SetAttribute("SketchPoints", UintegerValue(50u));
+
+    UintegerValue seriesId;
+    ecdf->GetSeries()->GetAttribute("Id", seriesId);
+
+    Simulator::Schedule(Seconds(1), [ecdf]() {
+        // One distinct value each
+        for (auto i = 1u; i <= 1'000'000u; i++)
+        {
+            ecdf->Append(static_cast<double>(i) / 1'000.0);
+        }
+        ecdf->Flush();
+    });
+
+    Simulator::Stop(Seconds(2));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ_TOL(ecdf->GetCdf(500.0), 0.5, 0.01, "Half the values are below 500");
+
+    std::vector<std::pair<double, double>> points;
+    for (const auto& event : o->GetJson()["events"])
+    {
+        if (event["type"].get<std::string>() == "xy-series-append-array" &&
+            event["series-id"].get<uint64_t>() == seriesId.Get())
+        {
+            for (const auto& point : event["points"])
+            {
+                points.emplace_back(point["x"].get<double>(), point["y"].get<double>());
+            }
+        }
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(points.size() <= 100u, true, "At most a step per quantile");
+    NS_TEST_ASSERT_MSG_EQ_TOL(points.back().first, 1'000.0, 10.0, "Ends at the largest value");
+    NS_TEST_ASSERT_MSG_EQ_TOL(points.back().second, 1.0, 1e-9, "Ends with every value");
+    for (auto i = 1u; i < points.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(points[i].first >= points[i - 1u].first, true, "Sorted by value");
+    }
+
+    Simulator::Destroy();
+}
+
+class EcdfSinkTestSuite : public TestSuite
+{
+  public:
+    EcdfSinkTestSuite();
+};
+
+EcdfSinkTestSuite::EcdfSinkTestSuite()
+    : TestSuite("netsimulyzer-ecdf-sink", TEST_TYPE_UNIT)
+{
+    AddTestCase(new TestCaseFenwickTree{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseEcdfSinkPoints{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseEcdfSinkMinFlushInterval{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseEcdfSinkIntervalWindow{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseEcdfSinkBinned{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseEcdfSinkManyAppends{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseDdSketch{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseDdSketchInfinity{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseEcdfSinkSketch{}, TEST_DURATION_QUICK);
+}
+
+static EcdfSinkTestSuite g_ecdfSinkTestSuite{};
+
+} // namespace ns3::test
@@ -0,0 +1,137 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "netsimulyzer-test-utils.h"
+
+#include "ns3/core-module.h"
+#include "ns3/netsimulyzer-module.h"
+#include "ns3/netsimulyzer-ns3-compatibility.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+
+#include <variant>
+#include <vector>
+
+namespace ns3::test
+{
+
+using namespace netsimulyzer;
+
+class TestCaseReorderWithinWindow : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseReorderWithinWindow();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseReorderWithinWindow::TestCaseReorderWithinWindow()
+    : NetSimulyzerTestCase("NetSimulyzer Event Reorder Buffer - Releases events in time order")
+{
+}
+
+void
+TestCaseReorderWithinWindow::DoRun()
+{
+    EventReorderBuffer buffer{10};
+
+    // {time, late}. Each series ID records the order the event was pushed
+    const std::vector<std::pair<int64_t, bool>> pushes{{5, false},
+                                                       {0, false},
+                                                       {12, false},
+                                                       {5, false},
+                                                       {8, false},
+                                                       {30, false},
+                                                       // 30 released everything up to 12,
+                                                       // so 10 can no longer be placed in order
+                                                       {10, true},
+                                                       {25, false},
+                                                       {20, false}};
+
+    std::vector<int64_t> times;
+    std::vector<uint32_t> ids;
+    auto collect = [&times, &ids](const EventRecord& event) {
+        const auto& append = std::get<XYSeriesAppendEvent>(event);
+        times.emplace_back(append.time.GetNanoSeconds());
+        ids.emplace_back(append.id);
+    };
+
+    EventRecord released;
+    for (auto i = 0u; i < pushes.size(); i++)
+    {
+        const auto [time, late] = pushes[i];
+        NS_TEST_ASSERT_MSG_EQ(buffer.Push(XYSeriesAppendEvent{NanoSeconds(time), i, 0.0, 0.0}),
+                              !late,
+                              "Only events behind a released event should be late");
+
+        while (buffer.PopReady(released))
+        {
+            NS_TEST_ASSERT_MSG_LT_OR_EQ(std::get<XYSeriesAppendEvent>(released).time,
+                                        NanoSeconds(time),
+                                        "Events should not be released before the window passes");
+            collect(released);
+        }
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(buffer.GetSize(), 2u, "Events within the window should be held");
+    while (buffer.Pop(released))
+    {
+        collect(released);
+    }
+
+    const std::vector<int64_t> expectedTimes{0, 5, 5, 8, 12, 20, 25, 30};
+    const std::vector<uint32_t> expectedIds{1u, 0u, 3u, 4u, 2u, 8u, 7u, 5u};
+    NS_TEST_ASSERT_MSG_EQ(times.size(), expectedTimes.size(), "Every on time event is released");
+    for (auto i = 0u; i < times.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(times[i], expectedTimes[i], "Events should be in time order");
+        NS_TEST_ASSERT_MSG_EQ(ids[i], expectedIds[i], "Ties should keep the order they arrived");
+    }
+}
+
+class EventReorderBufferTestSuite : public TestSuite
+{
+  public:
+    EventReorderBufferTestSuite();
+};
+
+EventReorderBufferTestSuite::EventReorderBufferTestSuite()
+    : TestSuite("netsimulyzer-event-reorder-buffer", TEST_TYPE_UNIT)
+{
+    AddTestCase(new TestCaseReorderWithinWindow{}, TEST_DURATION_QUICK);
+}
+
+static EventReorderBufferTestSuite g_eventReorderBufferTestSuite{};
+
+} // namespace ns3::test
@@ -0,0 +1,217 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "netsimulyzer-test-utils.h"
+
+#include "ns3/core-module.h"
+#include "ns3/netsimulyzer-module.h"
+#include "ns3/netsimulyzer-ns3-compatibility.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3::test
+{
+
+using namespace netsimulyzer;
+
+class TestCaseSpillBufferOrder : public NetSimulyzerTestCase
+{
+  public:
+    /**
+     * @param memoryLimit
+     * Budget for the buffer, small budgets spill more often
+     */
+    explicit TestCaseSpillBufferOrder(std::size_t memoryLimit);
+
+  private:
+    void DoRun() override;
+    std::size_t m_memoryLimit;
+};
+
+TestCaseSpillBufferOrder::TestCaseSpillBufferOrder(std::size_t memoryLimit)
+    : NetSimulyzerTestCase("NetSimulyzer Event Spill Buffer - Events merged in time order - " +
+                           std::to_string(memoryLimit) + " bytes"),
+      m_memoryLimit(memoryLimit)
+{
+}
+
+void
+TestCaseSpillBufferOrder::DoRun()
+{
+    const auto prefix = CreateTempDirFilename("spill-run-");
+    EventSpillBuffer buffer{prefix, m_memoryLimit};
+
+    // Times out of order, with duplicates. The series ID
+    // records the order each event was added in
+    const std::vector<int64_t> times{50, 10, 30, 10, 70, 20, 30, 0, 60, 10, 40, 30};
+    for (auto i = 0u; i < times.size(); i++)
+    {
+        buffer.Add(XYSeriesAppendEvent{NanoSeconds(times[i]), i, 0.0, 0.0});
+    }
+    buffer.Add(KeyframeEvent{NanoSeconds(35), {}, {}, {}});
+
+    const auto runs = buffer.GetRunCount();
+    if (m_memoryLimit == 0u)
+    {
+        NS_TEST_ASSERT_MSG_EQ(runs, times.size() + 1u, "Every event should be its own run");
+    }
+
+    std::vector<int64_t> mergedTimes;
+    std::vector<std::string> mergedJson;
+    auto keyframes = 0u;
+    buffer.Merge([&](const EventSpillBuffer::SortedEvent& event) {
+        mergedTimes.emplace_back(event.nanoseconds);
+        mergedJson.emplace_back(event.json);
+        if (event.keyframe)
+        {
+            keyframes++;
+        }
+    });
+
+    NS_TEST_ASSERT_MSG_EQ(mergedTimes.size(), times.size() + 1u, "Every event should be merged");
+    NS_TEST_ASSERT_MSG_EQ(keyframes, 1u, "The keyframe should be flagged");
+
+    for (auto i = 1u; i < mergedTimes.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(mergedTimes[i - 1u],
+                                    mergedTimes[i],
+                                    "Events should be in time order");
+    }
+
+    // Ties are kept in the order they were added
+    for (auto i = 1u; i < mergedJson.size(); i++)
+    {
+        if (mergedTimes[i - 1u] != mergedTimes[i])
+        {
+            continue;
+        }
+
+        const auto previous = nlohmann::json::parse(mergedJson[i - 1u]);
+        const auto current = nlohmann::json::parse(mergedJson[i]);
+        NS_TEST_ASSERT_MSG_LT(previous["series-id"].get<uint32_t>(),
+                              current["series-id"].get<uint32_t>(),
+                              "Events with the same time should keep their order");
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(buffer.GetRunCount(), 0u, "Runs should be removed after merging");
+    for (auto i = 0u; i < runs; i++)
+    {
+        std::ifstream run{prefix + std::to_string(i)};
+        NS_TEST_ASSERT_MSG_EQ(run.is_open(), false, "Run files should be deleted");
+    }
+}
+
+class TestCaseSpillBufferFanIn : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseSpillBufferFanIn();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseSpillBufferFanIn::TestCaseSpillBufferFanIn()
+    : NetSimulyzerTestCase("NetSimulyzer Event Spill Buffer - More runs than the merge fan-in")
+{
+}
+
+void
+TestCaseSpillBufferFanIn::DoRun()
+{
+    const auto prefix = CreateTempDirFilename("spill-fan-in-run-");
+    // Spill every event
+    EventSpillBuffer buffer{prefix, 0u};
+
+    // Enough for more than one round of merging groups
+    constexpr auto eventCount =
+        static_cast<uint32_t>(EventSpillBuffer::MaxMergeFanIn * EventSpillBuffer::MaxMergeFanIn + 3u);
+    for (auto i = 0u; i < eventCount; i++)
+    {
+        // Few distinct times, so many ties cross group boundaries
+        buffer.Add(XYSeriesAppendEvent{NanoSeconds((i * 7919u) % 50u), i, 0.0, 0.0});
+    }
+
+    NS_TEST_ASSERT_MSG_GT(buffer.GetRunCount(),
+                          EventSpillBuffer::MaxMergeFanIn,
+                          "There should be more runs than the merge fan-in");
+
+    auto merged = 0u;
+    int64_t previousTime{-1};
+    uint32_t previousId{0u};
+    buffer.Merge([&](const EventSpillBuffer::SortedEvent& event) {
+        const auto id = nlohmann::json::parse(event.json)["series-id"].get<uint32_t>();
+
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(previousTime,
+                                    event.nanoseconds,
+                                    "Events should be in time order");
+        if (previousTime == event.nanoseconds)
+        {
+            NS_TEST_ASSERT_MSG_LT(previousId,
+                                  id,
+                                  "Events with the same time should keep their order");
+        }
+
+        previousTime = event.nanoseconds;
+        previousId = id;
+        merged++;
+    });
+
+    NS_TEST_ASSERT_MSG_EQ(merged, eventCount, "Every event should be merged");
+    NS_TEST_ASSERT_MSG_EQ(buffer.GetRunCount(), 0u, "Runs should be removed after merging");
+}
+
+class EventSpillBufferTestSuite : public TestSuite
+{
+  public:
+    EventSpillBufferTestSuite();
+};
+
+EventSpillBufferTestSuite::EventSpillBufferTestSuite()
+    : TestSuite("netsimulyzer-event-spill-buffer", TEST_TYPE_UNIT)
+{
+    // Never spills
+    AddTestCase(new TestCaseSpillBufferOrder{1024u * 1024u}, TEST_DURATION_QUICK);
+    // Spills every few events
+    AddTestCase(new TestCaseSpillBufferOrder{3u * sizeof(EventRecord)}, TEST_DURATION_QUICK);
+    // Spills every event
+    AddTestCase(new TestCaseSpillBufferOrder{0u}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseSpillBufferFanIn{}, TEST_DURATION_QUICK);
+}
+
+static EventSpillBufferTestSuite g_eventSpillBufferTestSuite{};
+
+} // namespace ns3::test
@@ -0,0 +1,312 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "netsimulyzer-test-utils.h"
+
+#include "ns3/core-module.h"
+#include "ns3/netsimulyzer-module.h"
+#include "ns3/netsimulyzer-ns3-compatibility.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace ns3::test
+{
+
+using namespace netsimulyzer;
+
+class TestCaseEmitterMatchesDocument : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseEmitterMatchesDocument();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Write `event` with the emitter, and check that it is
+     * exactly what `nlohmann::json` would write for `expected`
+     *
+     * @param event
+     * The event to write
+     *
+     * @param expected
+     * The document previously built for the same event
+     */
+    void Check(const EventRecord& event, const nlohmann::json& expected);
+};
+
+TestCaseEmitterMatchesDocument::TestCaseEmitterMatchesDocument()
+    : NetSimulyzerTestCase("NetSimulyzer JSON Event Emitter - Matches nlohmann::json output")
+{
+}
+
+void
+TestCaseEmitterMatchesDocument::Check(const EventRecord& event, const nlohmann::json& expected)
+{
+    std::string buffer;
+    JsonEventEmitter{buffer}.Write(event);
+    NS_TEST_ASSERT_MSG_EQ(buffer, expected.dump(), "Emitted event should match nlohmann::json");
+}
+
+void
+TestCaseEmitterMatchesDocument::DoRun()
+{
+    const Color3 color{1u, 128u, 255u};
+    const nlohmann::json colorObject{{"red", 1u}, {"green", 128u}, {"blue", 255u}};
+
+    Check(CourseChangeEvent{NanoSeconds(12345), 3u, {1.5, -0.25, 100.0}},
+          {{"type", "node-position"},
+           {"nanoseconds", 12345},
+           {"id", 3u},
+           {"x", 1.5},
+           {"y", -0.25},
+           {"z", 100.0}});
+
+    Check(TransmitEvent{Seconds(2), 1u, MilliSeconds(5), 4.0, color},
+          {{"type", "node-transmit"},
+           {"nanoseconds", Seconds(2).GetNanoSeconds()},
+           {"id", 1u},
+           {"duration", MilliSeconds(5).GetNanoSeconds()},
+           {"target-size", 4.0},
+           {"color", colorObject}});
+
+    Check(NodeColorChangeEvent{Seconds(1), 2u, NodeColorChangeEvent::ColorType::Base, color},
+          {{"type", "node-color"},
+           {"nanoseconds", Seconds(1).GetNanoSeconds()},
+           {"id", 2u},
+           {"color-type", "base"},
+           {"color", colorObject}});
+
+    Check(NodeColorChangeEvent{Seconds(1), 2u, NodeColorChangeEvent::ColorType::Highlight, {}},
+          {{"type", "node-color"},
+           {"nanoseconds", Seconds(1).GetNanoSeconds()},
+           {"id", 2u},
+           {"color-type", "highlight"}});
+
+    Check(NodeVisibilityChangeEvent{Seconds(1), 7u, false},
+          {{"type", "node-change"},
+           {"nanoseconds", Seconds(1).GetNanoSeconds()},
+           {"id", 7u},
+           {"visibility", false}});
+
+    // Strings which require escaping
+    Check(NodeModelChangeEvent{Seconds(1), 7u, "models/\"quoted\"\\path.obj"},
+          {{"type", "node-model-change"},
+           {"nanoseconds", Seconds(1).GetNanoSeconds()},
+           {"id", 7u},
+           {"model", "models/\"quoted\"\\path.obj"}});
+
+    Check(LogMessageEvent{Seconds(3), 4u, "line one\nline\ttwo\x01 \xc3\xa9"},
+          {{"type", "stream-append"},
+           {"nanoseconds", Seconds(3).GetNanoSeconds()},
+           {"stream-id", 4u},
+           {"data", "line one\nline\ttwo\x01 \xc3\xa9"}});
+
+    Check(XYSeriesAppendArrayEvent{Seconds(4), 9u, {{0.0, 1.0}, {2.5, -3.0}}},
+          {{"type", "xy-series-append-array"},
+           {"nanoseconds", Seconds(4).GetNanoSeconds()},
+           {"series-id", 9u},
+           {"points", {{{"x", 0.0}, {"y", 1.0}}, {{"x", 2.5}, {"y", -3.0}}}}});
+
+    Check(XYSeriesAppendArrayEvent{Seconds(4), 9u, {}},
+          {{"type", "xy-series-append-array"},
+           {"nanoseconds", Seconds(4).GetNanoSeconds()},
+           {"series-id", 9u},
+           {"points", nlohmann::json::array()}});
+
+    Check(XYSeriesClearEvent{Seconds(5), 9u},
+          {{"type", "xy-series-clear"},
+           {"nanoseconds", Seconds(5).GetNanoSeconds()},
+           {"series-id", 9u}});
+
+    Check(CategorySeriesAppendEvent{Seconds(5), 10u, -2, 0.5},
+          {{"type", "category-series-append"},
+           {"nanoseconds", Seconds(5).GetNanoSeconds()},
+           {"series-id", 10u},
+           {"category", -2},
+           {"value", 0.5}});
+
+    Check(LogicalLinkEvent{Seconds(6),
+                           LogicalLinkEvent::EventType::Update,
+                           11u,
+                           {1u, 2u},
+                           true,
+                           color,
+                           0.25},
+          {{"nanoseconds", Seconds(6).GetNanoSeconds()},
+           {"type", "logical-link-update"},
+           {"link-id", 11u},
+           {"nodes", {1u, 2u}},
+           {"active", true},
+           {"color", colorObject},
+           {"diameter", 0.25}});
+
+    KeyframeEvent keyframe{Seconds(7), {}, {}, {}};
+    keyframe.nodes.push_back({0u, {1.0, 2.0, 3.0}, {0.0, 0.0, 90.0}, color, {}, true, "a.obj"});
+    keyframe.nodes.push_back({1u, {-1.0, 0.5, 0.0}, {}, {}, color, false, ""});
+    keyframe.decorations.push_back({5u, {10.0, 10.0, 0.0}, {0.0, 45.0, 0.0}});
+    keyframe.links.push_back({2u, {0u, 1u}, false, color, 0.5});
+    Check(keyframe,
+          {{"type", "keyframe"},
+           {"nanoseconds", Seconds(7).GetNanoSeconds()},
+           {"nodes",
+            {{{"id", 0u},
+              {"position", {{"x", 1.0}, {"y", 2.0}, {"z", 3.0}}},
+              {"orientation", {{"x", 0.0}, {"y", 0.0}, {"z", 90.0}}},
+              {"base-color", colorObject},
+              {"visible", true},
+              {"model", "a.obj"}},
+             {{"id", 1u},
+              {"position", {{"x", -1.0}, {"y", 0.5}, {"z", 0.0}}},
+              {"orientation", {{"x", 0.0}, {"y", 0.0}, {"z", 0.0}}},
+              {"highlight-color", colorObject},
+              {"visible", false},
+              {"model", ""}}}},
+           {"decorations",
+            {{{"id", 5u},
+              {"position", {{"x", 10.0}, {"y", 10.0}, {"z", 0.0}}},
+              {"orientation", {{"x", 0.0}, {"y", 45.0}, {"z", 0.0}}}}}},
+           {"links",
+            {{{"id", 2u},
+              {"nodes", {0u, 1u}},
+              {"active", false},
+              {"color", colorObject},
+              {"diameter", 0.5}}}}});
+
+    Check(KeyframeEvent{Seconds(8), {}, {}, {}},
+          {{"type", "keyframe"},
+           {"nanoseconds", Seconds(8).GetNanoSeconds()},
+           {"nodes", nlohmann::json::array()},
+           {"decorations", nlohmann::json::array()},
+           {"links", nlohmann::json::array()}});
+
+    Check(NodeSegmentEvent{Seconds(9),
+                           4u,
+                           Seconds(6),
+                           MilliSeconds(8500),
+                           {1.0, 2.0, 0.0},
+                           {0.5, -1.25, 0.0}},
+          {{"type", "node-segment"},
+           {"nanoseconds", Seconds(9).GetNanoSeconds()},
+           {"id", 4u},
+           {"start-nanoseconds", Seconds(6).GetNanoSeconds()},
+           {"end-nanoseconds", MilliSeconds(8500).GetNanoSeconds()},
+           {"position", {{"x", 1.0}, {"y", 2.0}, {"z", 0.0}}},
+           {"velocity", {{"x", 0.5}, {"y", -1.25}, {"z", 0.0}}}});
+
+    Check(NodePoseEvent{Seconds(10), 4u, {1.0, 2.0, 0.0}, {0.0, 0.0, 135.0}},
+          {{"type", "node-pose"},
+           {"nanoseconds", Seconds(10).GetNanoSeconds()},
+           {"id", 4u},
+           {"position", {{"x", 1.0}, {"y", 2.0}, {"z", 0.0}}},
+           {"orientation", {{"x", 0.0}, {"y", 0.0}, {"z", 135.0}}}});
+
+    Check(AreaCrossingEvent{Seconds(11), 4u, 2u, true},
+          {{"type", "area-enter"},
+           {"nanoseconds", Seconds(11).GetNanoSeconds()},
+           {"id", 4u},
+           {"area-id", 2u}});
+
+    Check(NodeFrameEvent{Seconds(13),
+                         {{4u, Vector3D{1.0, 2.0, 0.0}, std::nullopt},
+                          {5u, std::nullopt, Vector3D{0.0, 0.0, 90.0}},
+                          {6u, Vector3D{-1.0, 0.5, 2.0}, Vector3D{0.0, 0.0, 45.0}}}},
+          {{"type", "node-frame"},
+           {"nanoseconds", Seconds(13).GetNanoSeconds()},
+           {"nodes",
+            {{{"id", 4u}, {"position", {{"x", 1.0}, {"y", 2.0}, {"z", 0.0}}}},
+             {{"id", 5u}, {"orientation", {{"x", 0.0}, {"y", 0.0}, {"z", 90.0}}}},
+             {{"id", 6u},
+              {"orientation", {{"x", 0.0}, {"y", 0.0}, {"z", 45.0}}},
+              {"position", {{"x", -1.0}, {"y", 0.5}, {"z", 2.0}}}}}}});
+
+    Check(AreaCrossingEvent{Seconds(12), 4u, 2u, false},
+          {{"type", "area-exit"},
+           {"nanoseconds", Seconds(12).GetNanoSeconds()},
+           {"id", 4u},
+           {"area-id", 2u}});
+
+    // Each branch of the number formatting
+    const std::vector<double> values{0.0,
+                                     -0.0,
+                                     1.0,
+                                     0.1,
+                                     -123.456,
+                                     1e15,
+                                     1e16,
+                                     123456789012345.0,
+                                     0.0001,
+                                     0.00001,
+                                     1.5e-10,
+                                     6.02214076e23,
+                                     std::numeric_limits<double>::max(),
+                                     std::numeric_limits<double>::denorm_min()};
+    for (const auto value : values)
+    {
+        Check(XYSeriesAppendEvent{Seconds(1), 1u, value, -value},
+              {{"type", "xy-series-append"},
+               {"nanoseconds", Seconds(1).GetNanoSeconds()},
+               {"series-id", 1u},
+               {"x", value},
+               {"y", -value}});
+    }
+
+    // Not representable in JSON, nlohmann::json writes `null`
+    Check(XYSeriesAppendEvent{Seconds(1), 1u, std::nan(""), 0.0},
+          {{"type", "xy-series-append"},
+           {"nanoseconds", Seconds(1).GetNanoSeconds()},
+           {"series-id", 1u},
+           {"x", nullptr},
+           {"y", 0.0}});
+}
+
+class JsonEventEmitterTestSuite : public TestSuite
+{
+  public:
+    JsonEventEmitterTestSuite();
+};
+
+JsonEventEmitterTestSuite::JsonEventEmitterTestSuite()
+    : TestSuite("netsimulyzer-json-event-emitter", TEST_TYPE_UNIT)
+{
+    AddTestCase(new TestCaseEmitterMatchesDocument{}, TEST_DURATION_QUICK);
+}
+
+static JsonEventEmitterTestSuite g_jsonEventEmitterTestSuite{};
+
+} // namespace ns3::test
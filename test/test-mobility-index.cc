@@ -0,0 +1,626 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "netsimulyzer-test-utils.h"
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/netsimulyzer-module.h"
+#include "ns3/netsimulyzer-ns3-compatibility.h"
+#include "ns3/network-module.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3::test
+{
+
+using namespace netsimulyzer;
+
+class TestCaseMobilityIndexTolerance : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseMobilityIndexTolerance();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseMobilityIndexTolerance::TestCaseMobilityIndexTolerance()
+    : NetSimulyzerTestCase("NetSimulyzer Mobility Index - Batch tolerance check")
+{
+}
+
+void
+TestCaseMobilityIndexTolerance::DoRun()
+{
+    // Enough entries to cover the vectorized body & the remainder
+    const std::vector<double> lastX{0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 1.0, 1.0, 1.0, 0.0, 0.0};
+    const std::vector<double> lastY{0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 1.0, 1.0, 1.0, 0.0, 0.0};
+    const std::vector<double> lastZ{0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 1.0, 1.0, 1.0, 0.0, 0.0};
+
+    const std::vector<double> currentX{0.0, 0.25, 0.0, 0.0, -0.75, 1.0, 1.0, 1.0, 1.0, 0.0, 0.0};
+    const std::vector<double> currentY{0.0, 0.0, 0.25, 0.0, 0.0, 1.5, 1.0, 1.0, 1.0, 0.0, 0.0};
+    const std::vector<double> currentZ{0.0, 0.0, 0.0, -0.25, 0.0, 1.0, 1.75, 1.0, 1.0, 0.0, 0.0};
+
+    const std::vector<double> tolerance{0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.0, -1.0, 0.0};
+    const std::vector<uint8_t> expected{0u, 0u, 0u, 0u, 1u, 1u, 1u, 0u, 0u, 1u, 0u};
+
+    std::vector<double> excess(expected.size());
+    MobilityIndex::ExcessOverTolerance(lastX.data(),
+                                       lastY.data(),
+                                       lastZ.data(),
+                                       currentX.data(),
+                                       currentY.data(),
+                                       currentZ.data(),
+                                       tolerance.data(),
+                                       expected.size(),
+                                       excess.data());
+
+    for (auto i = 0u; i < expected.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(static_cast<int>(excess[i] > 0.0),
+                              static_cast<int>(expected[i]),
+                              "Only positions beyond the tolerance on any axis should change");
+    }
+}
+
+class TestCaseMobilityIndexPoll : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseMobilityIndexPoll();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseMobilityIndexPoll::TestCaseMobilityIndexPoll()
+    : NetSimulyzerTestCase("NetSimulyzer Mobility Index - Polls only write moved Nodes")
+{
+}
+
+void
+TestCaseMobilityIndexPoll::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    o->SetAttribute("MobilityPollInterval", TimeValue(MilliSeconds(100)));
+
+    // {speed, use tolerance}
+    const std::vector<std::pair<double, bool>> setup{{1.0, true}, {0.3, true}, {0.0, false}};
+
+    std::vector<uint32_t> ids;
+    for (const auto& [speed, useTolerance] : setup)
+    {
+        auto node = CreateObject<Node>();
+        auto config = CreateObject<NodeConfiguration>(o);
+        config->SetAttribute("PositionTolerance", DoubleValue(0.05));
+        config->SetAttribute("UsePositionTolerance", BooleanValue(useTolerance));
+        node->AggregateObject(config);
+
+        auto mobility = CreateObject<ConstantVelocityMobilityModel>();
+        node->AggregateObject(mobility);
+        mobility->SetVelocity({speed, 0.0, 0.0});
+
+        ids.emplace_back(node->GetId());
+    }
+
+    // A Node without a mobility model is skipped, not an error
+    auto stationary = CreateObject<Node>();
+    stationary->AggregateObject(CreateObject<NodeConfiguration>(o));
+
+    Simulator::Stop(MilliSeconds(1050));
+    Simulator::Run();
+
+    std::unordered_map<uint32_t, int> writes;
+    for (const auto& event : o->GetJson()["events"])
+    {
+        if (event["type"].get<std::string>() == "node-position")
+        {
+            writes[event["id"].get<uint32_t>()]++;
+        }
+    }
+
+    // Polls at 0.0, 0.1, ..., 1.0 seconds
+    NS_TEST_ASSERT_MSG_EQ(writes[ids[0]],
+                          10,
+                          "Moves 0.1 per poll, so all but the first are written");
+    NS_TEST_ASSERT_MSG_EQ(writes[ids[1]], 5, "Moves 0.03 per poll, so every other poll is written");
+    NS_TEST_ASSERT_MSG_EQ(writes[ids[2]], 11, "Without a tolerance every poll is written");
+    NS_TEST_ASSERT_MSG_EQ(writes[stationary->GetId()], 0, "Nodes without mobility are not written");
+
+    Simulator::Destroy();
+}
+
+class TestCaseMobilityIndexPrediction : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseMobilityIndexPrediction();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseMobilityIndexPrediction::TestCaseMobilityIndexPrediction()
+    : NetSimulyzerTestCase("NetSimulyzer Mobility Index - Predicts when Nodes leave the tolerance")
+{
+}
+
+void
+TestCaseMobilityIndexPrediction::DoRun()
+{
+    const Vector3D origin{0.0, 0.0, 0.0};
+
+    NS_TEST_ASSERT_MSG_EQ(
+        std::isinf(MobilityIndex::TimeBeyondTolerance(origin, origin, origin, 0.5)),
+        true,
+        "A Node that is not moving never leaves the tolerance");
+
+    NS_TEST_ASSERT_MSG_EQ_TOL(
+        MobilityIndex::TimeBeyondTolerance(origin, origin, {0.0, -2.0, 0.0}, 0.5),
+        0.25,
+        1e-12,
+        "The time should be the tolerance over the speed");
+
+    NS_TEST_ASSERT_MSG_EQ_TOL(
+        MobilityIndex::TimeBeyondTolerance({0.25, 0.0, 0.0}, origin, {1.0, 4.0, 0.0}, 0.5),
+        0.125,
+        1e-12,
+        "The fastest axis to leave the tolerance should be used");
+
+    NS_TEST_ASSERT_MSG_EQ(
+        MobilityIndex::TimeBeyondTolerance({1.0, 0.0, 0.0}, origin, {1.0, 0.0, 0.0}, 0.5),
+        0.0,
+        "A Node already beyond the tolerance is due now");
+
+    NS_TEST_ASSERT_MSG_EQ(MobilityIndex::TimeBeyondTolerance(origin, origin, origin, -1.0),
+                          0.0,
+                          "A Node without a tolerance is always due");
+}
+
+class TestCaseMobilityIndexAdaptive : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseMobilityIndexAdaptive();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Run the same scenario with or without adaptive polling
+     *
+     * @return
+     * Every 'node-position' event written, as {id, nanoseconds, x}
+     */
+    std::vector<std::tuple<uint32_t, int64_t, double>> RunScenario(bool adaptive);
+};
+
+TestCaseMobilityIndexAdaptive::TestCaseMobilityIndexAdaptive()
+    : NetSimulyzerTestCase("NetSimulyzer Mobility Index - Adaptive polls match fixed polls")
+{
+}
+
+std::vector<std::tuple<uint32_t, int64_t, double>>
+TestCaseMobilityIndexAdaptive::RunScenario(bool adaptive)
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    o->SetAttribute("MobilityPollInterval", TimeValue(MilliSeconds(100)));
+    o->SetAttribute("AdaptiveMobilityPolling", BooleanValue(adaptive));
+
+    std::vector<Ptr<ConstantVelocityMobilityModel>> models;
+    for (const auto speed : {1.0, 0.3, 0.0})
+    {
+        auto node = CreateObject<Node>();
+        auto config = CreateObject<NodeConfiguration>(o);
+        config->SetAttribute("PositionTolerance", DoubleValue(0.05));
+        node->AggregateObject(config);
+
+        auto mobility = CreateObject<ConstantVelocityMobilityModel>();
+        node->AggregateObject(mobility);
+        mobility->SetVelocity({speed, 0.0, 0.0});
+        models.emplace_back(mobility);
+    }
+
+    // Start the stationary Node, & stop the slow one, between polls
+    Simulator::Schedule(MilliSeconds(450), [models]() {
+        models[1]->SetVelocity({0.0, 0.0, 0.0});
+        models[2]->SetVelocity({0.5, 0.0, 0.0});
+    });
+
+    Simulator::Stop(MilliSeconds(1050));
+    Simulator::Run();
+
+    std::vector<std::tuple<uint32_t, int64_t, double>> positions;
+    for (const auto& event : o->GetJson()["events"])
+    {
+        if (event["type"].get<std::string>() == "node-position")
+        {
+            positions.emplace_back(event["id"].get<uint32_t>(),
+                                   event["nanoseconds"].get<int64_t>(),
+                                   event["x"].get<double>());
+        }
+    }
+
+    Simulator::Destroy();
+    return positions;
+}
+
+void
+TestCaseMobilityIndexAdaptive::DoRun()
+{
+    const auto fixed = RunScenario(false);
+    const auto adaptive = RunScenario(true);
+
+    NS_TEST_ASSERT_MSG_EQ(fixed.empty(), false, "Positions should be written");
+    NS_TEST_ASSERT_MSG_EQ(adaptive.size(), fixed.size(), "The same positions should be written");
+    for (auto i = 0u; i < std::min(fixed.size(), adaptive.size()); i++)
+    {
+        // IDs differ between runs, so compare the time & position only
+        NS_TEST_ASSERT_MSG_EQ(std::get<1>(adaptive[i]),
+                              std::get<1>(fixed[i]),
+                              "Positions should be written at the same times");
+        NS_TEST_ASSERT_MSG_EQ(std::get<2>(adaptive[i]),
+                              std::get<2>(fixed[i]),
+                              "The same positions should be written");
+    }
+}
+
+class TestCaseMobilityIndexAdaptiveCourseChangeTolerance : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseMobilityIndexAdaptiveCourseChangeTolerance();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseMobilityIndexAdaptiveCourseChangeTolerance::
+    TestCaseMobilityIndexAdaptiveCourseChangeTolerance()
+    : NetSimulyzerTestCase(
+          "NetSimulyzer Mobility Index - Adaptive polls wake on course changes within tolerance")
+{
+}
+
+void
+TestCaseMobilityIndexAdaptiveCourseChangeTolerance::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    o->SetAttribute("MobilityPollInterval", TimeValue(MilliSeconds(100)));
+    o->SetAttribute("AdaptiveMobilityPolling", BooleanValue(true));
+
+    auto node = CreateObject<Node>();
+    auto config = CreateObject<NodeConfiguration>(o);
+    config->SetAttribute("PositionTolerance", DoubleValue(0.01));
+    config->SetAttribute("CourseChangeTolerance", BooleanValue(true));
+    node->AggregateObject(config);
+
+    auto mobility = CreateObject<ConstantVelocityMobilityModel>();
+    node->AggregateObject(mobility);
+
+    // The course change is where the parked Node already is,
+    // so its position is not written, but it must be polled again
+    Simulator::Schedule(MilliSeconds(450),
+                        [mobility]() { mobility->SetVelocity({1.0, 0.0, 0.0}); });
+
+    Simulator::Stop(MilliSeconds(1050));
+    Simulator::Run();
+
+    std::vector<std::pair<int64_t, double>> positions;
+    for (const auto& event : o->GetJson()["events"])
+    {
+        if (event["type"].get<std::string>() == "node-position")
+        {
+            positions.emplace_back(event["nanoseconds"].get<int64_t>(), event["x"].get<double>());
+        }
+    }
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(positions.empty(), false, "Positions should be written once moving");
+    NS_TEST_ASSERT_MSG_EQ(positions.back().first,
+                          MilliSeconds(1000).GetNanoSeconds(),
+                          "The Node should be polled until the end of the simulation");
+    NS_TEST_ASSERT_MSG_EQ_TOL(positions.back().second,
+                              0.55,
+                              1e-9,
+                              "The latest position should be written");
+}
+
+class TestCaseMobilityIndexParallel : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseMobilityIndexParallel();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Run the same scenario sampling on `threads` threads
+     *
+     * @return
+     * Every 'node-position' event written, as {id, nanoseconds, x}
+     */
+    std::vector<std::tuple<uint32_t, int64_t, double>> RunScenario(uint32_t threads);
+};
+
+TestCaseMobilityIndexParallel::TestCaseMobilityIndexParallel()
+    : NetSimulyzerTestCase("NetSimulyzer Mobility Index - Parallel polls match serial polls")
+{
+}
+
+std::vector<std::tuple<uint32_t, int64_t, double>>
+TestCaseMobilityIndexParallel::RunScenario(uint32_t threads)
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    o->SetAttribute("MobilityPollInterval", TimeValue(MilliSeconds(100)));
+    o->SetAttribute("MobilityPollThreads", UintegerValue(threads));
+
+    // Enough Nodes to be split across threads,
+    // with some models which must stay on the simulation thread
+    for (auto i = 0; i < 10'000; i++)
+    {
+        auto node = CreateObject<Node>();
+        auto config = CreateObject<NodeConfiguration>(o);
+        node->AggregateObject(config);
+
+        if (i % 5 == 0)
+        {
+            auto mobility = CreateObject<WaypointMobilityModel>();
+            node->AggregateObject(mobility);
+            mobility->AddWaypoint(Waypoint(Seconds(0), Vector(0.0, 0.0, 0.0)));
+            mobility->AddWaypoint(Waypoint(MilliSeconds(500), Vector(1.0, 0.0, 0.0)));
+            mobility->AddWaypoint(Waypoint(Seconds(1), Vector(0.0, 0.0, 0.0)));
+            continue;
+        }
+
+        auto mobility = CreateObject<ConstantVelocityMobilityModel>();
+        node->AggregateObject(mobility);
+        mobility->SetVelocity({(i % 7) * 0.1, 0.0, 0.0});
+    }
+
+    Simulator::Stop(MilliSeconds(1050));
+    Simulator::Run();
+
+    std::vector<std::tuple<uint32_t, int64_t, double>> positions;
+    for (const auto& event : o->GetJson()["events"])
+    {
+        if (event["type"].get<std::string>() == "node-position")
+        {
+            positions.emplace_back(event["id"].get<uint32_t>(),
+                                   event["nanoseconds"].get<int64_t>(),
+                                   event["x"].get<double>());
+        }
+    }
+
+    Simulator::Destroy();
+    return positions;
+}
+
+void
+TestCaseMobilityIndexParallel::DoRun()
+{
+    const auto serial = RunScenario(0u);
+    const auto parallel = RunScenario(4u);
+
+    NS_TEST_ASSERT_MSG_EQ(serial.empty(), false, "Positions should be written");
+    NS_TEST_ASSERT_MSG_EQ(parallel.size(), serial.size(), "The same positions should be written");
+    for (auto i = 0u; i < std::min(serial.size(), parallel.size()); i++)
+    {
+        // IDs differ between runs, so compare the order, time, & position only
+        NS_TEST_ASSERT_MSG_EQ(std::get<1>(parallel[i]),
+                              std::get<1>(serial[i]),
+                              "Positions should be written at the same times");
+        NS_TEST_ASSERT_MSG_EQ(std::get<2>(parallel[i]),
+                              std::get<2>(serial[i]),
+                              "Positions should be written in the same order");
+    }
+}
+
+class TestCaseMobilityPollIntervals : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseMobilityPollIntervals();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseMobilityPollIntervals::TestCaseMobilityPollIntervals()
+    : NetSimulyzerTestCase("NetSimulyzer Mobility Index - Nodes polled on their own interval")
+{
+}
+
+void
+TestCaseMobilityPollIntervals::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    o->SetAttribute("MobilityPollInterval", TimeValue(MilliSeconds(100)));
+
+    // Zero uses the Orchestrator's interval
+    const std::vector<Time> intervals{MilliSeconds(20), Seconds(0), MilliSeconds(20)};
+
+    std::vector<uint32_t> ids;
+    for (const auto& interval : intervals)
+    {
+        auto node = CreateObject<Node>();
+        auto config = CreateObject<NodeConfiguration>(o);
+        config->SetAttribute("UsePositionTolerance", BooleanValue(false));
+        config->SetAttribute("MobilityPollInterval", TimeValue(interval));
+        node->AggregateObject(config);
+        node->AggregateObject(CreateObject<ConstantPositionMobilityModel>());
+
+        ids.emplace_back(node->GetId());
+    }
+
+    Simulator::Stop(MilliSeconds(1010));
+    Simulator::Run();
+
+    std::unordered_map<uint32_t, std::vector<int64_t>> writes;
+    for (const auto& event : o->GetJson()["events"])
+    {
+        if (event["type"].get<std::string>() == "node-position")
+        {
+            writes[event["id"].get<uint32_t>()].emplace_back(event["nanoseconds"].get<int64_t>());
+        }
+    }
+
+    for (auto i = 0u; i < ids.size(); i++)
+    {
+        const auto interval = intervals[i].IsZero() ? MilliSeconds(100) : intervals[i];
+        const auto& times = writes[ids[i]];
+
+        // Polls from 0 through 1 second
+        const auto expected = Seconds(1).GetNanoSeconds() / interval.GetNanoSeconds() + 1;
+        NS_TEST_ASSERT_MSG_EQ(static_cast<int64_t>(times.size()),
+                              expected,
+                              "Each Node should be polled on its own interval");
+
+        for (auto j = 0u; j < times.size(); j++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(times[j],
+                                  static_cast<int64_t>(j) * interval.GetNanoSeconds(),
+                                  "Polls should be on the Node's interval");
+        }
+    }
+
+    Simulator::Destroy();
+}
+
+class TestCaseMobilityPollIntervalChange : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseMobilityPollIntervalChange();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseMobilityPollIntervalChange::TestCaseMobilityPollIntervalChange()
+    : NetSimulyzerTestCase("NetSimulyzer Mobility Index - Poll intervals changed while running")
+{
+}
+
+void
+TestCaseMobilityPollIntervalChange::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    o->SetAttribute("MobilityPollInterval", TimeValue(MilliSeconds(100)));
+
+    std::vector<Ptr<NodeConfiguration>> configs;
+    std::vector<uint32_t> ids;
+    for (auto i = 0; i < 2; i++)
+    {
+        auto node = CreateObject<Node>();
+        auto config = CreateObject<NodeConfiguration>(o);
+        config->SetAttribute("UsePositionTolerance", BooleanValue(false));
+        node->AggregateObject(config);
+        node->AggregateObject(CreateObject<ConstantPositionMobilityModel>());
+
+        configs.emplace_back(config);
+        ids.emplace_back(node->GetId());
+    }
+
+    // One Node follows the Orchestrator, the other gets its own interval
+    Simulator::Schedule(MilliSeconds(500), [o, configs]() {
+        o->SetAttribute("MobilityPollInterval", TimeValue(MilliSeconds(50)));
+        configs[1]->SetAttribute("MobilityPollInterval", TimeValue(MilliSeconds(25)));
+    });
+
+    Simulator::Stop(MilliSeconds(1010));
+    Simulator::Run();
+
+    std::unordered_map<uint32_t, std::vector<int64_t>> writes;
+    for (const auto& event : o->GetJson()["events"])
+    {
+        if (event["type"].get<std::string>() == "node-position")
+        {
+            writes[event["id"].get<uint32_t>()].emplace_back(event["nanoseconds"].get<int64_t>());
+        }
+    }
+
+    const std::vector<Time> newIntervals{MilliSeconds(50), MilliSeconds(25)};
+    for (auto i = 0u; i < ids.size(); i++)
+    {
+        // The old interval through the change, then the new one
+        std::vector<int64_t> expected;
+        for (auto time = Seconds(0); time <= MilliSeconds(500); time += MilliSeconds(100))
+        {
+            expected.emplace_back(time.GetNanoSeconds());
+        }
+        for (auto time = MilliSeconds(500) + newIntervals[i]; time <= Seconds(1);
+             time += newIntervals[i])
+        {
+            expected.emplace_back(time.GetNanoSeconds());
+        }
+
+        const auto& times = writes[ids[i]];
+        NS_TEST_ASSERT_MSG_EQ(times.size(),
+                              expected.size(),
+                              "Nodes should be polled on the changed interval");
+        for (auto j = 0u; j < times.size(); j++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(times[j], expected[j], "Polls should follow the new interval");
+        }
+    }
+
+    Simulator::Destroy();
+}
+
+class MobilityIndexTestSuite : public TestSuite
+{
+  public:
+    MobilityIndexTestSuite();
+};
+
+MobilityIndexTestSuite::MobilityIndexTestSuite()
+    : TestSuite("netsimulyzer-mobility-index", TEST_TYPE_UNIT)
+{
+    AddTestCase(new TestCaseMobilityIndexTolerance{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseMobilityIndexPoll{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseMobilityIndexPrediction{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseMobilityIndexAdaptive{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseMobilityIndexAdaptiveCourseChangeTolerance{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseMobilityIndexParallel{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseMobilityPollIntervals{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseMobilityPollIntervalChange{}, TEST_DURATION_QUICK);
+}
+
+static MobilityIndexTestSuite g_mobilityIndexTestSuite{};
+
+} // namespace ns3::test
@@ -44,6 +44,7 @@
 #include <algorithm>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 namespace ns3::test
@@ -504,6 +505,370 @@ TestCaseNodeChangeEventVisibility::DoRun()
     Simulator::Destroy();
 }
 
+class TestCaseNodePoseEvent : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseNodePoseEvent();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseNodePoseEvent::TestCaseNodePoseEvent()
+    : NetSimulyzerTestCase("NetSimulyzer - Node pose events & `OrientationTolerance`")
+{
+}
+
+void
+TestCaseNodePoseEvent::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    o->SetAttribute("PollMobility", BooleanValue{false});
+    o->SetAttribute("PoseEvents", BooleanValue{true});
+
+    auto ns3Node = CreateObject<Node>();
+    auto nodeConfig = CreateObject<NodeConfiguration>(o);
+    nodeConfig->SetAttribute("FaceForward", BooleanValue{true});
+    nodeConfig->SetAttribute("OrientationTolerance", DoubleValue{5.0});
+    ns3Node->AggregateObject(nodeConfig);
+
+    auto mobility = CreateObject<ConstantPositionMobilityModel>();
+    mobility->SetAttribute("Position", VectorValue{{0.0, 0.0, 0.0}});
+    ns3Node->AggregateObject(mobility);
+
+    Simulator::Stop(MilliSeconds(100UL));
+
+    // Turn to face +x, drift slightly left, turn around to face -x,
+    // then drift slightly right, across the +/-180 degree boundary
+    const std::vector<Vector3D> path{{10.0, 0.0, 0.0},
+                                     {20.0, 0.1, 0.0},
+                                     {10.0, 0.1, 0.0},
+                                     {0.0, 0.0, 0.0}};
+    for (auto i = 0u; i < path.size(); i++)
+    {
+        const auto position = path[i];
+        Simulator::Schedule(MilliSeconds(10UL * (i + 1u)),
+                            [mobility, position]() { mobility->SetPosition(position); });
+    }
+
+    Simulator::Run();
+
+    std::vector<std::string> types;
+    std::vector<double> headings;
+    for (const auto& event : o->GetJson()["events"])
+    {
+        const auto type = event["type"].get<std::string>();
+        if (type != "node-pose" && type != "node-position" && type != "node-orientation")
+        {
+            continue;
+        }
+
+        types.emplace_back(type);
+        if (type == "node-pose")
+        {
+            RequiredFields({"id", "nanoseconds", "orientation", "position"}, event, "node-pose");
+            headings.emplace_back(event["orientation"]["z"].get<double>());
+        }
+    }
+
+    const std::vector<std::string> expected{"node-pose",
+                                            "node-position",
+                                            "node-pose",
+                                            "node-position"};
+    NS_TEST_ASSERT_MSG_EQ(types.size(), expected.size(), "One event per course change");
+    for (auto i = 0u; i < types.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(types[i],
+                              expected[i],
+                              "Only turns beyond the tolerance should write an orientation");
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(headings.size(), 2u, "Both turns should be written");
+    NS_TEST_ASSERT_MSG_EQ_TOL(headings[0], 90.0, 0.5, "Node should face +x");
+    NS_TEST_ASSERT_MSG_EQ_TOL(headings[1], 270.0, 0.5, "Node should face -x");
+
+    Simulator::Destroy();
+}
+
+/**
+ * Every 'node-position' event in `events`, as {nanoseconds, x}
+ */
+std::vector<std::pair<int64_t, double>>
+NodePositions(const nlohmann::json& events)
+{
+    std::vector<std::pair<int64_t, double>> positions;
+    for (const auto& event : events)
+    {
+        if (event["type"].get<std::string>() == "node-position")
+        {
+            positions.emplace_back(event["nanoseconds"].get<int64_t>(), event["x"].get<double>());
+        }
+    }
+    return positions;
+}
+
+class TestCaseNodePositionCoalesced : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseNodePositionCoalesced();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseNodePositionCoalesced::TestCaseNodePositionCoalesced()
+    : NetSimulyzerTestCase("NetSimulyzer - One Node position per time")
+{
+}
+
+void
+TestCaseNodePositionCoalesced::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    o->SetAttribute("MobilityPollInterval", TimeValue(MilliSeconds(25)));
+
+    auto ns3Node = CreateObject<Node>();
+    auto nodeConfig = CreateObject<NodeConfiguration>(o);
+    ns3Node->AggregateObject(nodeConfig);
+
+    auto mobility = CreateObject<ConstantPositionMobilityModel>();
+    mobility->SetAttribute("Position", VectorValue{{0.0, 0.0, 0.0}});
+    ns3Node->AggregateObject(mobility);
+
+    Simulator::Stop(MilliSeconds(100));
+
+    // Two course changes at the same time as a poll
+    Simulator::Schedule(MilliSeconds(50), [mobility]() {
+        mobility->SetPosition({5.0, 0.0, 0.0});
+        mobility->SetPosition({10.0, 0.0, 0.0});
+    });
+
+    Simulator::Run();
+
+    const auto positions = NodePositions(o->GetJson()["events"]);
+    NS_TEST_ASSERT_MSG_EQ(positions.size(), 1u, "Only one position should be written");
+    NS_TEST_ASSERT_MSG_EQ(positions.front().first,
+                          MilliSeconds(50).GetNanoSeconds(),
+                          "Position should be written at the time of the course changes");
+    NS_TEST_ASSERT_MSG_EQ(positions.front().second, 10.0, "The last position should be written");
+
+    Simulator::Destroy();
+}
+
+class TestCaseNodeCourseChangeInterval : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseNodeCourseChangeInterval();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseNodeCourseChangeInterval::TestCaseNodeCourseChangeInterval()
+    : NetSimulyzerTestCase("NetSimulyzer - Course changes respect `MinCourseChangeInterval`")
+{
+}
+
+void
+TestCaseNodeCourseChangeInterval::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    o->SetAttribute("PollMobility", BooleanValue{false});
+
+    auto ns3Node = CreateObject<Node>();
+    auto nodeConfig = CreateObject<NodeConfiguration>(o);
+    nodeConfig->SetAttribute("MinCourseChangeInterval", TimeValue(MilliSeconds(50)));
+    nodeConfig->SetAttribute("CourseChangeTolerance", BooleanValue(true));
+    ns3Node->AggregateObject(nodeConfig);
+
+    auto mobility = CreateObject<ConstantPositionMobilityModel>();
+    mobility->SetAttribute("Position", VectorValue{{0.0, 0.0, 0.0}});
+    ns3Node->AggregateObject(mobility);
+
+    Simulator::Stop(MilliSeconds(200));
+
+    // Held until 60ms, then only the latest position is written
+    for (auto step = 1; step <= 3; step++)
+    {
+        Simulator::Schedule(MilliSeconds(step * 10), [mobility, step]() {
+            mobility->SetPosition({static_cast<double>(step), 0.0, 0.0});
+        });
+    }
+
+    // Within the default `PositionTolerance`
+    Simulator::Schedule(MilliSeconds(150),
+                        [mobility]() { mobility->SetPosition({3.01, 0.0, 0.0}); });
+
+    Simulator::Run();
+
+    const auto positions = NodePositions(o->GetJson()["events"]);
+    NS_TEST_ASSERT_MSG_EQ(positions.size(), 2u, "Two positions should be written");
+    NS_TEST_ASSERT_MSG_EQ(positions[0].first,
+                          MilliSeconds(10).GetNanoSeconds(),
+                          "The first course change should be written immediately");
+    NS_TEST_ASSERT_MSG_EQ(positions[0].second, 1.0, "The first position should be written");
+    NS_TEST_ASSERT_MSG_EQ(positions[1].first,
+                          MilliSeconds(60).GetNanoSeconds(),
+                          "Held course changes should be written once the interval passes");
+    NS_TEST_ASSERT_MSG_EQ(positions[1].second, 3.0, "The latest position should be written");
+
+    Simulator::Destroy();
+}
+
+class TestCaseNodeFrameMode : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseNodeFrameMode();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseNodeFrameMode::TestCaseNodeFrameMode()
+    : NetSimulyzerTestCase("NetSimulyzer - `FrameMode` writes one event per frame")
+{
+}
+
+void
+TestCaseNodeFrameMode::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    o->SetAttribute("PollMobility", BooleanValue{false});
+    o->SetAttribute("FrameMode", BooleanValue{true});
+    o->SetTimeStep(MilliSeconds(100), Time::Unit::MS);
+
+    auto ns3Node = CreateObject<Node>();
+    auto nodeConfig = CreateObject<NodeConfiguration>(o);
+    ns3Node->AggregateObject(nodeConfig);
+
+    auto mobility = CreateObject<ConstantPositionMobilityModel>();
+    mobility->SetAttribute("Position", VectorValue{{0.0, 0.0, 0.0}});
+    ns3Node->AggregateObject(mobility);
+
+    Simulator::Stop(MilliSeconds(300));
+
+    // First frame: two positions & a turn
+    Simulator::Schedule(MilliSeconds(10), [mobility]() { mobility->SetPosition({1.0, 0.0, 0.0}); });
+    Simulator::Schedule(MilliSeconds(20), [mobility]() { mobility->SetPosition({2.0, 0.0, 0.0}); });
+    Simulator::Schedule(MilliSeconds(50), [nodeConfig]() {
+        nodeConfig->SetOrientation({0.0, 0.0, 90.0});
+    });
+
+    // Second frame: only a position, on the boundary of the frame
+    Simulator::Schedule(MilliSeconds(200),
+                        [mobility]() { mobility->SetPosition({3.0, 0.0, 0.0}); });
+
+    Simulator::Run();
+
+    std::vector<nlohmann::json> frames;
+    for (const auto& event : o->GetJson()["events"])
+    {
+        const auto type = event["type"].get<std::string>();
+        NS_TEST_ASSERT_MSG_NE(type, "node-position", "Positions should only be in frames");
+        NS_TEST_ASSERT_MSG_NE(type, "node-orientation", "Orientations should only be in frames");
+        if (type == "node-frame")
+        {
+            frames.emplace_back(event);
+        }
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(frames.size(), 2u, "One frame should be written per step with changes");
+
+    NS_TEST_ASSERT_MSG_EQ(frames[0]["nanoseconds"].get<int64_t>(),
+                          MilliSeconds(100).GetNanoSeconds(),
+                          "Frames should be written at the end of the step");
+    NS_TEST_ASSERT_MSG_EQ(frames[0]["nodes"].size(), 1u, "Only one Node changed");
+    const auto& first = frames[0]["nodes"][0];
+    NS_TEST_ASSERT_MSG_EQ(first["id"].get<uint32_t>(), ns3Node->GetId(), "Node ID should match");
+    NS_TEST_ASSERT_MSG_EQ(first["position"]["x"].get<double>(), 2.0, "Last position in frame");
+    NS_TEST_ASSERT_MSG_EQ(first["orientation"]["z"].get<double>(), 90.0, "Orientation in frame");
+
+    NS_TEST_ASSERT_MSG_EQ(frames[1]["nanoseconds"].get<int64_t>(),
+                          MilliSeconds(200).GetNanoSeconds(),
+                          "Changes on a boundary belong to the frame ending there");
+    const auto& second = frames[1]["nodes"][0];
+    NS_TEST_ASSERT_MSG_EQ(second["position"]["x"].get<double>(), 3.0, "Last position in frame");
+    NS_TEST_ASSERT_MSG_EQ(second.contains("orientation"), false, "Orientation did not change");
+
+    Simulator::Destroy();
+}
+
+class TestCaseNodeGeofence : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseNodeGeofence();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseNodeGeofence::TestCaseNodeGeofence()
+    : NetSimulyzerTestCase("NetSimulyzer - Geofences write crossings & occupancy")
+{
+}
+
+void
+TestCaseNodeGeofence::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    o->SetAttribute("MobilityPollInterval", TimeValue(MilliSeconds(100)));
+
+    auto area = CreateObject<RectangularArea>(o, Rectangle{4.5, 14.5, -1.0, 1.0});
+    const auto occupancy = o->AddGeofence(area);
+
+    UintegerValue areaId;
+    area->GetAttribute("Id", areaId);
+    UintegerValue seriesId;
+    occupancy->GetAttribute("Id", seriesId);
+
+    auto ns3Node = CreateObject<Node>();
+    auto nodeConfig = CreateObject<NodeConfiguration>(o);
+    ns3Node->AggregateObject(nodeConfig);
+
+    // Inside from 0.5s to 1.5s
+    auto mobility = CreateObject<ConstantVelocityMobilityModel>();
+    ns3Node->AggregateObject(mobility);
+    mobility->SetVelocity({10.0, 0.0, 0.0});
+
+    Simulator::Stop(Seconds(2));
+    Simulator::Run();
+
+    std::vector<std::pair<std::string, int64_t>> crossings;
+    std::vector<std::pair<double, double>> counts;
+    for (const auto& event : o->GetJson()["events"])
+    {
+        const auto type = event["type"].get<std::string>();
+        if (type == "area-enter" || type == "area-exit")
+        {
+            NS_TEST_ASSERT_MSG_EQ(event["area-id"].get<uint64_t>(), areaId.Get(), "Area ID");
+            NS_TEST_ASSERT_MSG_EQ(event["id"].get<uint32_t>(), ns3Node->GetId(), "Node ID");
+            crossings.emplace_back(type, event["nanoseconds"].get<int64_t>());
+        }
+        else if (type == "xy-series-append" && event["series-id"].get<uint64_t>() == seriesId.Get())
+        {
+            counts.emplace_back(event["x"].get<double>(), event["y"].get<double>());
+        }
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(crossings.size(), 2u, "The Node should enter & exit once");
+    NS_TEST_ASSERT_MSG_EQ(crossings[0].first, "area-enter", "The Node enters first");
+    NS_TEST_ASSERT_MSG_EQ(crossings[0].second,
+                          MilliSeconds(500).GetNanoSeconds(),
+                          "Entered on the first poll inside");
+    NS_TEST_ASSERT_MSG_EQ(crossings[1].first, "area-exit", "The Node exits last");
+    NS_TEST_ASSERT_MSG_EQ(crossings[1].second,
+                          MilliSeconds(1500).GetNanoSeconds(),
+                          "Exited on the first poll outside");
+
+    NS_TEST_ASSERT_MSG_EQ(counts.size(), 3u, "Occupancy is written at the start & each change");
+    NS_TEST_ASSERT_MSG_EQ(counts[0].second, 0.0, "The area starts empty");
+    NS_TEST_ASSERT_MSG_EQ(counts[1].first, 0.5, "Occupancy changes with the crossing");
+    NS_TEST_ASSERT_MSG_EQ(counts[1].second, 1.0, "The Node is inside");
+    NS_TEST_ASSERT_MSG_EQ(counts[2].second, 0.0, "The Node left");
+
+    Simulator::Destroy();
+}
+
 class NodeEventsTestSuite : public TestSuite
 {
   public:
@@ -519,6 +884,11 @@ NodeEventsTestSuite::NodeEventsTestSuite()
     AddTestCase(new TestCaseNodeModelChangeEvent{}, TEST_DURATION_QUICK);
     AddTestCase(new TestCaseNodeTransmitEvent{}, TEST_DURATION_QUICK);
     AddTestCase(new TestCaseNodeChangeEventVisibility{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseNodePoseEvent{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseNodePositionCoalesced{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseNodeCourseChangeInterval{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseNodeFrameMode{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseNodeGeofence{}, TEST_DURATION_QUICK);
 }
 
 static NodeEventsTestSuite g_nodeEventsTestSuite{};
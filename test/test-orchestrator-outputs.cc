@@ -41,10 +41,19 @@
 #include "ns3/nstime.h"
 #include "ns3/test.h"
 
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <fstream>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 namespace ns3::test
 {
 
@@ -215,6 +224,390 @@ TestCaseNodeMobility::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * Run a short scenario with a moving Node & a series,
+ * then read back the output written to `path`
+ */
+nlohmann::json
+RunOutputScenario(const std::string& path, bool streaming)
+{
+    auto o = CreateObject<Orchestrator>(path);
+    o->SetAttribute("StreamOutput", BooleanValue(streaming));
+
+    auto ns3Node = CreateObject<Node>();
+    auto nodeConfig = CreateObject<NodeConfiguration>(o);
+    ns3Node->AggregateObject(nodeConfig);
+
+    auto mobility = CreateObject<ConstantPositionMobilityModel>();
+    mobility->SetAttribute("Position", VectorValue{{1.0, 2.0, 3.0}});
+    ns3Node->AggregateObject(mobility);
+
+    auto series = CreateObject<XYSeries>(o);
+    series->SetAttribute("Name", StringValue("Series"));
+
+    // One event before the header is written in streaming mode, the rest after
+    series->Append(0.0, 0.0);
+    for (auto i = 1; i < 10; i++)
+    {
+        Simulator::Schedule(MilliSeconds(i * 10), [mobility, series, nodeConfig, i]() {
+            const auto value = static_cast<double>(i);
+            mobility->SetPosition({value, 2.0, 3.0});
+            series->Append(value, value * 2.0);
+            nodeConfig->SetAttribute("Orientation", Vector3DValue({0.0, 0.0, value}));
+        });
+    }
+
+    Simulator::Stop(MilliSeconds(200UL));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    std::ifstream file{path};
+    return nlohmann::json::parse(file);
+}
+
+class TestCaseStreamingOutputMatches : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseStreamingOutputMatches();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseStreamingOutputMatches::TestCaseStreamingOutputMatches()
+    : NetSimulyzerTestCase("NetSimulyzer Orchestrator - Streaming output matches document output")
+{
+}
+
+void
+TestCaseStreamingOutputMatches::DoRun()
+{
+    const auto document = RunOutputScenario(CreateTempDirFilename("document-output.json"), false);
+    const auto streamed = RunOutputScenario(CreateTempDirFilename("streamed-output.json"), true);
+
+    NS_TEST_ASSERT_MSG_EQ(document["events"].empty(), false, "Scenario should write events");
+    NS_TEST_ASSERT_MSG_EQ(streamed.size(), document.size(), "Both outputs should have the same keys");
+    for (const auto& [key, value] : document.items())
+    {
+        NS_TEST_ASSERT_MSG_EQ(streamed.contains(key), true, "Streamed output is missing " + key);
+        NS_TEST_ASSERT_MSG_EQ(streamed[key] == value,
+                              true,
+                              "Streamed '" + key + "' should match the document output");
+    }
+}
+
+class TestCaseAsyncFileOutput : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseAsyncFileOutput();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseAsyncFileOutput::TestCaseAsyncFileOutput()
+    : NetSimulyzerTestCase("NetSimulyzer Orchestrator - Asynchronous file output")
+{
+}
+
+void
+TestCaseAsyncFileOutput::DoRun()
+{
+    const auto path = CreateTempDirFilename("async-output.json");
+    auto o = CreateObject<Orchestrator>(path);
+    o->SetAttribute("AsyncOutput", BooleanValue(true));
+    // Small enough the simulation thread will have to wait on the writer
+    o->SetAttribute("AsyncQueueSize", UintegerValue(4u));
+
+    auto series = CreateObject<XYSeries>(o);
+
+    constexpr auto pointCount = 10000;
+    // One before the header is written, the rest after the writer thread starts
+    series->Append(0.0, 0.0);
+    Simulator::Schedule(MilliSeconds(1UL), [series]() {
+        for (auto i = 1; i < pointCount; i++)
+        {
+            series->Append(static_cast<double>(i), static_cast<double>(i));
+        }
+    });
+
+    Simulator::Stop(MilliSeconds(10UL));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(o->GetDroppedEventCount(), 0u, "No events should be dropped when blocking");
+
+    std::ifstream file{path};
+    const auto output = nlohmann::json::parse(file);
+
+    NS_TEST_ASSERT_MSG_EQ(output["events"].size(),
+                          static_cast<std::size_t>(pointCount),
+                          "Every appended point should be written");
+    NS_TEST_ASSERT_MSG_EQ(output.contains("series"), true, "Output must contain a 'series' entry");
+
+    auto expected = 0.0;
+    for (const auto& event : output["events"])
+    {
+        NS_TEST_ASSERT_MSG_EQ(event["x"].get<double>(), expected, "Events should be in order");
+        expected += 1.0;
+    }
+}
+
+class TestCaseAsyncDropBackpressure : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseAsyncDropBackpressure();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseAsyncDropBackpressure::TestCaseAsyncDropBackpressure()
+    : NetSimulyzerTestCase("NetSimulyzer Orchestrator - Asynchronous output, drop backpressure")
+{
+}
+
+void
+TestCaseAsyncDropBackpressure::DoRun()
+{
+    const auto path = CreateTempDirFilename("async-drop-output.json");
+    auto o = CreateObject<Orchestrator>(path);
+    o->SetAttribute("AsyncOutput", BooleanValue(true));
+    o->SetAttribute("AsyncQueueSize", UintegerValue(4u));
+    o->SetAttribute("AsyncBackpressure", EnumValue(Orchestrator::BackpressurePolicy::Drop));
+
+    auto series = CreateObject<XYSeries>(o);
+
+    constexpr auto pointCount = 10000;
+    Simulator::Schedule(MilliSeconds(1UL), [series]() {
+        for (auto i = 0; i < pointCount; i++)
+        {
+            series->Append(static_cast<double>(i), static_cast<double>(i));
+        }
+    });
+
+    Simulator::Stop(MilliSeconds(10UL));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    std::ifstream file{path};
+    const auto output = nlohmann::json::parse(file);
+    const auto written = output["events"].size();
+
+    // Whether any events are dropped depends on the writer thread,
+    // but every event must be either written or counted
+    NS_TEST_ASSERT_MSG_EQ(written + o->GetDroppedEventCount(),
+                          static_cast<std::size_t>(pointCount),
+                          "Every event should be either written or counted as dropped");
+
+    auto previous = -1.0;
+    for (const auto& event : output["events"])
+    {
+        const auto x = event["x"].get<double>();
+        NS_TEST_ASSERT_MSG_GT(x, previous, "Written events should remain in order");
+        previous = x;
+    }
+}
+
+#ifndef _WIN32
+namespace
+{
+
+// Shared with `FlushFromWriter()`, which runs on the writer thread
+Orchestrator* writerFlushOrchestrator{nullptr};
+std::atomic<bool> writerInterrupted{false};
+std::atomic<bool> writerQueueFilled{false};
+std::atomic<bool> writerFlushed{false};
+
+// Stands in for the crash handler interrupting the writer thread.
+// Holds the writer until the queue is full, then flushes from it
+void
+FlushFromWriter(int)
+{
+    writerInterrupted.store(true);
+    while (!writerQueueFilled.load())
+    {
+        std::this_thread::yield();
+    }
+
+    writerFlushOrchestrator->Flush();
+    writerFlushed.store(true);
+}
+
+} // namespace
+
+class TestCaseAsyncFlushFromWriter : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseAsyncFlushFromWriter();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseAsyncFlushFromWriter::TestCaseAsyncFlushFromWriter()
+    : NetSimulyzerTestCase("NetSimulyzer Orchestrator - Asynchronous output, flush from the writer")
+{
+}
+
+void
+TestCaseAsyncFlushFromWriter::DoRun()
+{
+    const auto path = CreateTempDirFilename("async-writer-flush.json");
+    auto o = CreateObject<Orchestrator>(path);
+    o->SetAttribute("AsyncOutput", BooleanValue(true));
+    o->SetAttribute("AsyncQueueSize", UintegerValue(4u));
+    o->SetAttribute("AsyncBackpressure", EnumValue(Orchestrator::BackpressurePolicy::Block));
+
+    auto ns3Node = CreateObject<Node>();
+    ns3Node->AggregateObject(CreateObject<NodeConfiguration>(o));
+    auto mobility = CreateObject<ConstantPositionMobilityModel>();
+    ns3Node->AggregateObject(mobility);
+
+    auto series = CreateObject<XYSeries>(o);
+
+    writerFlushOrchestrator = PeekPointer(o);
+    Simulator::Schedule(MilliSeconds(1UL), [series, mobility]() {
+        // Let the writer thread go idle, so the signal doesn't interrupt a write
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        // Block the signal here, so it can only be taken by the writer thread
+        const auto previousHandler = std::signal(SIGUSR1, FlushFromWriter);
+        sigset_t signals;
+        sigset_t previousSignals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGUSR1);
+        pthread_sigmask(SIG_BLOCK, &signals, &previousSignals);
+        kill(getpid(), SIGUSR1);
+        while (!writerInterrupted.load())
+        {
+            std::this_thread::yield();
+        }
+
+        // Exactly fills the queue, as nothing will consume it
+        for (auto i = 0; i < 4; i++)
+        {
+            series->Append(static_cast<double>(i), static_cast<double>(i));
+        }
+        // Pending until the end of this event, so only written by the flush
+        mobility->SetPosition({1.0, 2.0, 3.0});
+
+        writerQueueFilled.store(true);
+        while (!writerFlushed.load())
+        {
+            std::this_thread::yield();
+        }
+
+        // Let the writer thread finish its loop after the handler returns
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        pthread_sigmask(SIG_SETMASK, &previousSignals, nullptr);
+        std::signal(SIGUSR1, previousHandler);
+    });
+
+    Simulator::Stop(MilliSeconds(10UL));
+    Simulator::Run();
+    Simulator::Destroy();
+    writerFlushOrchestrator = nullptr;
+
+    std::ifstream file{path};
+    const auto output = nlohmann::json::parse(file);
+
+    auto expected = 0.0;
+    auto positionWritten = false;
+    for (const auto& event : output["events"])
+    {
+        const auto type = event["type"].get<std::string>();
+        if (type == "xy-series-append")
+        {
+            NS_TEST_ASSERT_MSG_EQ(event["x"].get<double>(), expected, "Events should be in order");
+            expected += 1.0;
+        }
+        else if (type == "node-position" && event["x"].get<double>() == 1.0)
+        {
+            positionWritten = true;
+        }
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(expected, 4.0, "Every queued event should be written by the flush");
+    NS_TEST_ASSERT_MSG_EQ(positionWritten, true, "The pending position should be written");
+}
+#endif
+
+class TestCaseKeyframes : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseKeyframes();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseKeyframes::TestCaseKeyframes()
+    : NetSimulyzerTestCase("NetSimulyzer Orchestrator - Keyframes & index")
+{
+}
+
+void
+TestCaseKeyframes::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    o->SetAttribute("KeyframeInterval", TimeValue(Seconds(1)));
+    o->SetAttribute("PollMobility", BooleanValue(false));
+
+    auto ns3Node = CreateObject<Node>();
+    auto nodeConfig = CreateObject<NodeConfiguration>(o);
+    ns3Node->AggregateObject(nodeConfig);
+
+    auto mobility = CreateObject<ConstantPositionMobilityModel>();
+    mobility->SetAttribute("Position", VectorValue{{1.0, 2.0, 3.0}});
+    ns3Node->AggregateObject(mobility);
+
+    // Should be reflected in every keyframe after the change
+    Simulator::Schedule(MilliSeconds(1500UL), [nodeConfig, mobility]() {
+        nodeConfig->SetAttribute("Model", StringValue("changed.obj"));
+        mobility->SetPosition({4.0, 5.0, 6.0});
+    });
+
+    Simulator::Stop(MilliSeconds(3500UL));
+    Simulator::Run();
+
+    const auto& output = o->GetJson();
+    NS_TEST_ASSERT_MSG_EQ(output.contains("keyframes"),
+                          true,
+                          "Output must contain a 'keyframes' entry");
+
+    const auto& index = output["keyframes"];
+    const auto& events = output["events"];
+    NS_TEST_ASSERT_MSG_EQ(index.size(), 3u, "Should be one keyframe per second");
+
+    for (auto i = 0u; i < index.size(); i++)
+    {
+        const auto& entry = index[i];
+        RequiredFields({"event", "nanoseconds"}, entry, "keyframe index");
+        NS_TEST_ASSERT_MSG_EQ(entry["nanoseconds"].get<int64_t>(),
+                              Seconds(i + 1).GetNanoSeconds(),
+                              "Keyframes should be spaced by the interval");
+
+        const auto& keyframe = events[entry["event"].get<std::size_t>()];
+        NS_TEST_ASSERT_MSG_EQ(keyframe["type"].get<std::string>(),
+                              "keyframe",
+                              "Index should point at a keyframe");
+        NS_TEST_ASSERT_MSG_EQ(keyframe["nanoseconds"], entry["nanoseconds"], "Times should match");
+        NS_TEST_ASSERT_MSG_EQ(keyframe["nodes"].size(), 1u, "Every Node should be in the keyframe");
+
+        const auto& node = keyframe["nodes"][0];
+        RequiredFields({"id", "model", "orientation", "position", "visible"}, node, "keyframe node");
+        NS_TEST_ASSERT_MSG_EQ(node["position"]["x"].get<double>(),
+                              i == 0u ? 1.0 : 4.0,
+                              "Keyframe should have the current position");
+        NS_TEST_ASSERT_MSG_EQ(node["model"].get<std::string>() == "changed.obj",
+                              i != 0u,
+                              "Keyframe should have the current model");
+    }
+
+    Simulator::Destroy();
+}
+
 class OrchestratorBasicOutputTestSuite : public TestSuite
 {
   public:
@@ -227,6 +620,13 @@ OrchestratorBasicOutputTestSuite::OrchestratorBasicOutputTestSuite()
     AddTestCase(new TestCaseOutputStructure(), TEST_DURATION_QUICK);
     AddTestCase(new TestCaseNodeInOutput(), TEST_DURATION_QUICK);
     AddTestCase(new TestCaseNodeMobility(), TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseStreamingOutputMatches(), TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseAsyncFileOutput(), TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseAsyncDropBackpressure(), TEST_DURATION_QUICK);
+#ifndef _WIN32
+    AddTestCase(new TestCaseAsyncFlushFromWriter(), TEST_DURATION_QUICK);
+#endif
+    AddTestCase(new TestCaseKeyframes(), TEST_DURATION_QUICK);
 }
 
 static OrchestratorBasicOutputTestSuite g_orchestratorBasicOutputTestSuite{};
@@ -0,0 +1,277 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "netsimulyzer-test-utils.h"
+
+#include "ns3/netsimulyzer-module.h"
+#include "ns3/netsimulyzer-ns3-compatibility.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#ifdef NETSIMULYZER_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef NETSIMULYZER_ZSTD
+#include <zstd.h>
+#endif
+
+namespace ns3::test
+{
+
+using namespace netsimulyzer;
+
+namespace
+{
+
+/**
+ * @param path
+ * The file to read
+ *
+ * @return
+ * Every byte of the file
+ */
+std::string
+ReadFile(const std::string& path)
+{
+    std::ifstream file{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+/**
+ * Build a string large enough to span several frames
+ *
+ * @return
+ * Some JSON-like, compressible text
+ */
+std::string
+SampleText(void)
+{
+    std::string text;
+    for (auto i = 0; i < 5000; i++)
+    {
+        text += R"({"id":)" + std::to_string(i % 17) + R"(,"nanoseconds":)" +
+                std::to_string(i * 1000) + R"(,"type":"node-position"},)";
+    }
+    return text;
+}
+
+} // namespace
+
+class TestCaseCompressionFromPath : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseCompressionFromPath();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseCompressionFromPath::TestCaseCompressionFromPath()
+    : NetSimulyzerTestCase("NetSimulyzer Output File - Compression selected from the extension")
+{
+}
+
+void
+TestCaseCompressionFromPath::DoRun()
+{
+    NS_TEST_ASSERT_MSG_EQ(static_cast<int>(OutputFile::CompressionFromPath("a.json.gz")),
+                          static_cast<int>(OutputFile::Compression::Gzip),
+                          "`.gz` should be gzip");
+    NS_TEST_ASSERT_MSG_EQ(static_cast<int>(OutputFile::CompressionFromPath("a.json.zst")),
+                          static_cast<int>(OutputFile::Compression::Zstd),
+                          "`.zst` should be zstd");
+    NS_TEST_ASSERT_MSG_EQ(static_cast<int>(OutputFile::CompressionFromPath("a.json")),
+                          static_cast<int>(OutputFile::Compression::None),
+                          "`.json` should not be compressed");
+    NS_TEST_ASSERT_MSG_EQ(static_cast<int>(OutputFile::CompressionFromPath("gz")),
+                          static_cast<int>(OutputFile::Compression::None),
+                          "Only the extension should be checked");
+}
+
+#ifdef NETSIMULYZER_ZLIB
+class TestCaseGzipFrames : public NetSimulyzerTestCase
+{
+  public:
+    explicit TestCaseGzipFrames(bool threaded);
+
+  private:
+    void DoRun() override;
+    bool m_threaded;
+};
+
+TestCaseGzipFrames::TestCaseGzipFrames(bool threaded)
+    : NetSimulyzerTestCase(std::string{"NetSimulyzer Output File - gzip frames decompress"} +
+                           (threaded ? " - Threaded" : "")),
+      m_threaded(threaded)
+{
+}
+
+void
+TestCaseGzipFrames::DoRun()
+{
+    const auto path = CreateTempDirFilename("output.json.gz");
+    const auto text = SampleText();
+    constexpr auto frameSize = 4096u;
+
+    OutputFile file;
+    file.open(path);
+    file.SetCompression(OutputFile::Compression::Gzip, 0, frameSize, m_threaded);
+    // Mix single characters with larger writes
+    for (auto i = 0u; i < text.size(); i += 1000u)
+    {
+        file << text[i];
+        file.write(text.data() + i + 1u,
+                   static_cast<std::streamsize>(std::min<std::size_t>(999u, text.size() - i - 1u)));
+    }
+    NS_TEST_ASSERT_MSG_EQ(file.good(), true, "Writing should succeed");
+    file.close();
+    NS_TEST_ASSERT_MSG_EQ(file.good(), true, "Closing should succeed");
+
+    // Decompress each gzip member one after the other
+    auto compressed = ReadFile(path);
+    std::string decompressed;
+    std::string chunk(frameSize, '\0');
+    auto members = 0u;
+
+    z_stream stream{};
+    NS_TEST_ASSERT_MSG_EQ(inflateInit2(&stream, 15 + 16), Z_OK, "inflate should initialize");
+    stream.next_in = reinterpret_cast<Bytef*>(compressed.data());
+    stream.avail_in = static_cast<uInt>(compressed.size());
+    while (stream.avail_in > 0u)
+    {
+        stream.next_out = reinterpret_cast<Bytef*>(chunk.data());
+        stream.avail_out = static_cast<uInt>(chunk.size());
+        const auto result = inflate(&stream, Z_NO_FLUSH);
+        NS_TEST_ASSERT_MSG_EQ((result == Z_OK || result == Z_STREAM_END),
+                              true,
+                              "Every member should be valid");
+        decompressed.append(chunk.data(), chunk.size() - stream.avail_out);
+
+        if (result == Z_STREAM_END)
+        {
+            members++;
+            inflateReset(&stream);
+        }
+    }
+    inflateEnd(&stream);
+
+    NS_TEST_ASSERT_MSG_EQ(decompressed, text, "Decompressed output should match");
+    NS_TEST_ASSERT_MSG_EQ(members,
+                          (text.size() + frameSize - 1u) / frameSize,
+                          "Each frame should be its own gzip member");
+}
+#endif
+
+#ifdef NETSIMULYZER_ZSTD
+class TestCaseZstdFrames : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseZstdFrames();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseZstdFrames::TestCaseZstdFrames()
+    : NetSimulyzerTestCase("NetSimulyzer Output File - zstd frames decompress")
+{
+}
+
+void
+TestCaseZstdFrames::DoRun()
+{
+    const auto path = CreateTempDirFilename("output.json.zst");
+    const auto text = SampleText();
+    constexpr auto frameSize = 4096u;
+
+    OutputFile file;
+    file.open(path);
+    file.SetCompression(OutputFile::Compression::Zstd, 0, frameSize, true);
+    file << text;
+    file.close();
+    NS_TEST_ASSERT_MSG_EQ(file.good(), true, "Writing should succeed");
+
+    // Each frame records its content size, so decompress them one at a time
+    const auto compressed = ReadFile(path);
+    std::string decompressed;
+    std::size_t offset = 0u;
+    auto frames = 0u;
+    while (offset < compressed.size())
+    {
+        const auto frameLength =
+            ZSTD_findFrameCompressedSize(compressed.data() + offset, compressed.size() - offset);
+        NS_TEST_ASSERT_MSG_EQ(ZSTD_isError(frameLength), 0u, "Every frame should be complete");
+
+        std::string frame(frameSize, '\0');
+        const auto size =
+            ZSTD_decompress(frame.data(), frame.size(), compressed.data() + offset, frameLength);
+        NS_TEST_ASSERT_MSG_EQ(ZSTD_isError(size), 0u, "Every frame should decompress");
+        decompressed.append(frame.data(), size);
+
+        offset += frameLength;
+        frames++;
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(decompressed, text, "Decompressed output should match");
+    NS_TEST_ASSERT_MSG_EQ(frames,
+                          (text.size() + frameSize - 1u) / frameSize,
+                          "Each frame should be its own zstd frame");
+}
+#endif
+
+class OutputFileTestSuite : public TestSuite
+{
+  public:
+    OutputFileTestSuite();
+};
+
+OutputFileTestSuite::OutputFileTestSuite()
+    : TestSuite("netsimulyzer-output-file", TEST_TYPE_UNIT)
+{
+    AddTestCase(new TestCaseCompressionFromPath{}, TEST_DURATION_QUICK);
+#ifdef NETSIMULYZER_ZLIB
+    AddTestCase(new TestCaseGzipFrames{false}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseGzipFrames{true}, TEST_DURATION_QUICK);
+#endif
+#ifdef NETSIMULYZER_ZSTD
+    AddTestCase(new TestCaseZstdFrames{}, TEST_DURATION_QUICK);
+#endif
+}
+
+static OutputFileTestSuite g_outputFileTestSuite{};
+
+} // namespace ns3::test
@@ -0,0 +1,266 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "netsimulyzer-test-utils.h"
+
+#include "ns3/core-module.h"
+#include "ns3/netsimulyzer-module.h"
+#include "ns3/netsimulyzer-ns3-compatibility.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3::test
+{
+
+using namespace netsimulyzer;
+
+/**
+ * Collect every point appended to each series
+ *
+ * @param o
+ * The Orchestrator to read the output of
+ *
+ * @return
+ * The {seconds, y} points appended to each series, by series ID
+ */
+std::map<uint64_t, std::vector<std::pair<double, double>>>
+SeriesPoints(Ptr<Orchestrator> o)
+{
+    std::map<uint64_t, std::vector<std::pair<double, double>>> points;
+    for (const auto& event : o->GetJson()["events"])
+    {
+        if (event["type"].get<std::string>() == "xy-series-append")
+        {
+            points[event["series-id"].get<uint64_t>()].emplace_back(event["x"].get<double>(),
+                                                                    event["y"].get<double>());
+        }
+    }
+
+    return points;
+}
+
+/**
+ * @param sink
+ * The sink to get the series ID of
+ *
+ * @return
+ * The ID of the series of `sink`
+ */
+uint64_t
+SeriesId(Ptr<ThroughputSink> sink)
+{
+    UintegerValue id;
+    sink->GetSeries()->GetAttribute("Id", id);
+    return id.Get();
+}
+
+class TestCaseThroughputSharedClock : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseThroughputSharedClock();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseThroughputSharedClock::TestCaseThroughputSharedClock()
+    : NetSimulyzerTestCase("NetSimulyzer Throughput Sink - Sinks share a clock per interval")
+{
+}
+
+void
+TestCaseThroughputSharedClock::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+
+    auto first = CreateObject<ThroughputSink>(o, "First");
+    first->SetAttribute("Unit", EnumValue(ThroughputSink::Unit::Byte));
+    auto second = CreateObject<ThroughputSink>(o, "Second");
+    second->SetAttribute("Unit", EnumValue(ThroughputSink::Unit::Byte));
+
+    NS_TEST_ASSERT_MSG_EQ(o->GetSinkClock(Seconds(1))->GetSinkCount(),
+                          2u,
+                          "Sinks with the same interval should share a clock");
+
+    Simulator::Schedule(MilliSeconds(500), [first]() { first->AddPacketSize(1'000u); });
+    Simulator::Schedule(MilliSeconds(1500), [second]() { second->AddPacketSize(500u); });
+
+    // Joins partway through an interval
+    Ptr<ThroughputSink> late;
+    Simulator::Schedule(MilliSeconds(1500), [o, &late]() {
+        late = CreateObject<ThroughputSink>(o, "Late");
+        late->SetAttribute("Unit", EnumValue(ThroughputSink::Unit::Byte));
+        late->AddPacketSize(1'000u);
+    });
+
+    Simulator::Stop(MilliSeconds(2500));
+    Simulator::Run();
+
+    auto points = SeriesPoints(o);
+    const std::vector<std::pair<double, double>> firstExpected{{1.0, 1'000.0}, {2.0, 0.0}};
+    const std::vector<std::pair<double, double>> secondExpected{{1.0, 0.0}, {2.0, 500.0}};
+    NS_TEST_ASSERT_MSG_EQ((points[SeriesId(first)] == firstExpected), true, "First sink");
+    NS_TEST_ASSERT_MSG_EQ((points[SeriesId(second)] == secondExpected), true, "Second sink");
+
+    // 1,000 bytes over half a second
+    const std::vector<std::pair<double, double>> lateExpected{{2.0, 2'000.0}};
+    NS_TEST_ASSERT_MSG_EQ((points[SeriesId(late)] == lateExpected),
+                          true,
+                          "A late sink should be written with the shared clock");
+
+    // Leaves its slot to be reused
+    late->Dispose();
+    NS_TEST_ASSERT_MSG_EQ(o->GetSinkClock(Seconds(1))->GetSinkCount(),
+                          2u,
+                          "Disposed sinks should leave the clock");
+
+    Simulator::Destroy();
+}
+
+class TestCaseThroughputManualWrite : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseThroughputManualWrite();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseThroughputManualWrite::TestCaseThroughputManualWrite()
+    : NetSimulyzerTestCase("NetSimulyzer Throughput Sink - Manual writes use the elapsed time")
+{
+}
+
+void
+TestCaseThroughputManualWrite::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+
+    auto sink = CreateObject<ThroughputSink>(o, "Sink");
+    sink->SetAttribute("Unit", EnumValue(ThroughputSink::Unit::Byte));
+
+    Simulator::Schedule(MilliSeconds(100), [sink]() { sink->AddPacketSize(1'000u); });
+    // Partway through the interval
+    Simulator::Schedule(MilliSeconds(500), [sink]() { sink->WriteThroughput(); });
+    Simulator::Schedule(MilliSeconds(700), [sink]() { sink->AddPacketSize(500u); });
+
+    Simulator::Stop(MilliSeconds(1400));
+    Simulator::Run();
+
+    // Both over half a second, the rest of the interval after the manual write
+    const std::vector<std::pair<double, double>> expected{{0.5, 2'000.0}, {1.0, 1'000.0}};
+    const auto points = SeriesPoints(o)[SeriesId(sink)];
+    NS_TEST_ASSERT_MSG_EQ((points == expected),
+                          true,
+                          "Manual & interval writes should divide by the time elapsed");
+
+    Simulator::Destroy();
+}
+
+class TestCaseThroughputWindow : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseThroughputWindow();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseThroughputWindow::TestCaseThroughputWindow()
+    : NetSimulyzerTestCase("NetSimulyzer Throughput Sink - Only written inside the window")
+{
+}
+
+void
+TestCaseThroughputWindow::DoRun()
+{
+    auto o = CreateObject<Orchestrator>(Orchestrator::MemoryOutputMode::On);
+    o->SetAttribute("StartTime", TimeValue(Seconds(2)));
+    o->SetAttribute("StopTime", TimeValue(MilliSeconds(4500)));
+
+    auto sink = CreateObject<ThroughputSink>(o, "Sink");
+    sink->SetAttribute("Unit", EnumValue(ThroughputSink::Unit::Byte));
+
+    // Received before the window, & while it is suspended, so never written
+    Simulator::Schedule(MilliSeconds(1500), [sink]() { sink->AddPacketSize(300u); });
+    Simulator::Schedule(MilliSeconds(4700), [sink]() { sink->AddPacketSize(300u); });
+
+    Simulator::Schedule(MilliSeconds(2500), [sink]() { sink->AddPacketSize(1'000u); });
+    Simulator::Schedule(MilliSeconds(5500), [sink]() { sink->AddPacketSize(500u); });
+
+    // Resume the window
+    Simulator::Schedule(Seconds(5), [o]() { o->SetAttribute("StopTime", TimeValue(Seconds(7))); });
+
+    Simulator::Stop(Seconds(10));
+    Simulator::Run();
+
+    // The last interval of a window is cut short
+    const std::vector<std::pair<double, double>> expected{{3.0, 1'000.0},
+                                                          {4.0, 0.0},
+                                                          {4.5, 0.0},
+                                                          {6.0, 500.0},
+                                                          {7.0, 0.0}};
+    const auto points = SeriesPoints(o)[SeriesId(sink)];
+    NS_TEST_ASSERT_MSG_EQ(points.size(), expected.size(), "One point per interval in the window");
+    for (auto i = 0u; i < std::min(points.size(), expected.size()); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(points[i].first, expected[i].first, "Time of point " << i);
+        NS_TEST_ASSERT_MSG_EQ(points[i].second, expected[i].second, "Throughput of point " << i);
+    }
+
+    Simulator::Destroy();
+}
+
+class ThroughputSinkTestSuite : public TestSuite
+{
+  public:
+    ThroughputSinkTestSuite();
+};
+
+ThroughputSinkTestSuite::ThroughputSinkTestSuite()
+    : TestSuite("netsimulyzer-throughput-sink", TEST_TYPE_UNIT)
+{
+    AddTestCase(new TestCaseThroughputSharedClock{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseThroughputManualWrite{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseThroughputWindow{}, TEST_DURATION_QUICK);
+}
+
+static ThroughputSinkTestSuite g_throughputSinkTestSuite{};
+
+} // namespace ns3::test
@@ -0,0 +1,189 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve,modify and create derivative
+ * works of the software or any portion of the software, and you may copy and
+ * distribute such modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and nature of
+ * any such change. Please explicitly acknowledge the National Institute of
+ * Standards and Technology as the source of the software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO
+ * WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY OPERATION OF
+ * LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT
+ * AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR WARRANTS THAT THE
+ * OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED OR ERROR-FREE, OR THAT
+ * ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT WARRANT OR MAKE ANY
+ * REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR THE RESULTS THEREOF,
+ * INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY, RELIABILITY,
+ * OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This
+ * software is not intended to be used in any situation where a failure could
+ * cause risk of injury or damage to property. The software developed by NIST
+ * employees is not subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "netsimulyzer-test-utils.h"
+
+#include "ns3/core-module.h"
+#include "ns3/netsimulyzer-module.h"
+#include "ns3/netsimulyzer-ns3-compatibility.h"
+#include "ns3/test.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace ns3::test
+{
+
+using namespace netsimulyzer;
+
+class TestCaseTrajectoryTurn : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseTrajectoryTurn();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseTrajectoryTurn::TestCaseTrajectoryTurn()
+    : NetSimulyzerTestCase("NetSimulyzer Trajectory Simplifier - Straight motion is one segment")
+{
+}
+
+void
+TestCaseTrajectoryTurn::DoRun()
+{
+    TrajectorySimplifier simplifier{0.01};
+    constexpr int64_t step = 100'000'000; // 100ms
+
+    // 1 m/s along x for 1 second, then 2 m/s along y for 1 second
+    for (auto i = 0; i <= 10; i++)
+    {
+        const auto segment = simplifier.Add(i * step, {i * 0.1, 0.0, 0.0});
+        NS_TEST_ASSERT_MSG_EQ(segment.has_value(), false, "Straight motion should not close");
+    }
+
+    std::vector<TrajectorySimplifier::Segment> segments;
+    for (auto i = 1; i <= 10; i++)
+    {
+        const auto segment = simplifier.Add((10 + i) * step, {1.0, i * 0.2, 0.0});
+        if (segment)
+        {
+            segments.emplace_back(segment.value());
+        }
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(segments.size(), 1u, "The turn should close exactly one segment");
+    const auto last = simplifier.Finish();
+    NS_TEST_ASSERT_MSG_EQ(last.has_value(), true, "Finish should close the open segment");
+    segments.emplace_back(last.value());
+
+    NS_TEST_ASSERT_MSG_EQ(simplifier.Finish().has_value(),
+                          false,
+                          "Nothing should be left to close");
+
+    NS_TEST_ASSERT_MSG_EQ(segments[0].start, 0, "First segment should start at the first position");
+    NS_TEST_ASSERT_MSG_EQ(segments[0].end, 10 * step, "First segment should end at the turn");
+    NS_TEST_ASSERT_MSG_EQ_TOL(segments[0].velocity.x, 1.0, 1e-9, "First segment moves along x");
+    NS_TEST_ASSERT_MSG_EQ_TOL(segments[0].velocity.y, 0.0, 1e-9, "First segment moves along x");
+
+    NS_TEST_ASSERT_MSG_EQ(segments[1].start, 10 * step, "Second segment should continue the first");
+    NS_TEST_ASSERT_MSG_EQ(segments[1].end, 20 * step, "Second segment should end at the end");
+    NS_TEST_ASSERT_MSG_EQ_TOL(segments[1].position.x, 1.0, 1e-9, "Second segment starts at turn");
+    NS_TEST_ASSERT_MSG_EQ_TOL(segments[1].velocity.x, 0.0, 1e-9, "Second segment moves along y");
+    NS_TEST_ASSERT_MSG_EQ_TOL(segments[1].velocity.y, 2.0, 1e-9, "Second segment moves along y");
+}
+
+class TestCaseTrajectoryError : public NetSimulyzerTestCase
+{
+  public:
+    TestCaseTrajectoryError();
+
+  private:
+    void DoRun() override;
+};
+
+TestCaseTrajectoryError::TestCaseTrajectoryError()
+    : NetSimulyzerTestCase("NetSimulyzer Trajectory Simplifier - Segments stay within the error")
+{
+}
+
+void
+TestCaseTrajectoryError::DoRun()
+{
+    constexpr auto maxError = 0.05;
+    constexpr int64_t step = 100'000'000; // 100ms
+    TrajectorySimplifier simplifier{maxError};
+
+    // Circular motion, which no single line fits for long
+    std::vector<Vector3D> positions;
+    for (auto i = 0; i <= 200; i++)
+    {
+        const auto angle = i * 0.05;
+        positions.push_back({10.0 * std::cos(angle), 10.0 * std::sin(angle), 0.0});
+    }
+
+    std::vector<TrajectorySimplifier::Segment> segments;
+    for (auto i = 0u; i < positions.size(); i++)
+    {
+        if (const auto segment = simplifier.Add(i * step, positions[i]))
+        {
+            segments.emplace_back(segment.value());
+        }
+    }
+    segments.emplace_back(simplifier.Finish().value());
+
+    NS_TEST_ASSERT_MSG_GT(segments.size(), 1u, "A curve should need several segments");
+    NS_TEST_ASSERT_MSG_LT(segments.size(),
+                          positions.size() / 2,
+                          "Segments should replace positions");
+
+    auto segment = segments.begin();
+    for (auto i = 0u; i < positions.size(); i++)
+    {
+        const auto time = static_cast<int64_t>(i) * step;
+        while (segment->end < time)
+        {
+            segment++;
+        }
+        NS_TEST_ASSERT_MSG_EQ(segment->start <= time, true, "Segments should have no gaps");
+
+        const auto seconds = static_cast<double>(time - segment->start) * 1e-9;
+        const auto x = segment->position.x + segment->velocity.x * seconds;
+        const auto y = segment->position.y + segment->velocity.y * seconds;
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(std::abs(x - positions[i].x),
+                                    maxError + 1e-9,
+                                    "Every position should be within the error on x");
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(std::abs(y - positions[i].y),
+                                    maxError + 1e-9,
+                                    "Every position should be within the error on y");
+    }
+}
+
+class TrajectorySimplifierTestSuite : public TestSuite
+{
+  public:
+    TrajectorySimplifierTestSuite();
+};
+
+TrajectorySimplifierTestSuite::TrajectorySimplifierTestSuite()
+    : TestSuite("netsimulyzer-trajectory-simplifier", TEST_TYPE_UNIT)
+{
+    AddTestCase(new TestCaseTrajectoryTurn{}, TEST_DURATION_QUICK);
+    AddTestCase(new TestCaseTrajectoryError{}, TEST_DURATION_QUICK);
+}
+
+static TrajectorySimplifierTestSuite g_trajectorySimplifierTestSuite{};
+
+} // namespace ns3::test
@@ -0,0 +1,76 @@
+/*
+ * NIST-developed software is provided by NIST as a public
+ * service. You may use, copy and distribute copies of the software in
+ * any medium, provided that you keep intact this entire notice. You
+ * may improve, modify and create derivative works of the software or
+ * any portion of the software, and you may copy and distribute such
+ * modifications or works. Modified works should carry a notice
+ * stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the
+ * National Institute of Standards and Technology as the source of the
+ * software.
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES
+ * NO WARRANTY OF ANY KIND, EXPRESS, IMPLIED, IN FACT OR ARISING BY
+ * OPERATION OF LAW, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+ * WARRANTY OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE,
+ * NON-INFRINGEMENT AND DATA ACCURACY. NIST NEITHER REPRESENTS NOR
+ * WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE UNINTERRUPTED
+ * OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES NOT
+ * WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE
+ * SOFTWARE OR THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE
+ * CORRECTNESS, ACCURACY, RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ *
+ * You are solely responsible for determining the appropriateness of
+ * using and distributing the software and you assume all risks
+ * associated with its use, including but not limited to the risks and
+ * costs of program errors, compliance with applicable laws, damage to
+ * or loss of data, programs or equipment, and the unavailability or
+ * interruption of operation. This software is not intended to be used
+ * in any situation where a failure could cause risk of injury or
+ * damage to property. The software developed by NIST employees is not
+ * subject to copyright protection within the United States.
+ *
+ * Author: Evan Black <evan.black@nist.gov>
+ */
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/netsimulyzer-module.h"
+
+#include <fstream>
+#include <string>
+
+// Converts output written with the Orchestrator's `OutputFormat`
+// set to `Binary` into the JSON document the application reads.
+//
+// Usage:
+// ./ns3 run "netsimulyzer-binary-to-json --input=output.nszb --output=output.json"
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+
+    CommandLine cmd{__FILE__};
+    cmd.AddValue("input", "Binary NetSimulyzer output to convert", input);
+    cmd.AddValue("output", "Where to write the converted JSON output", output);
+    cmd.Parse(argc, argv);
+
+    NS_ABORT_MSG_IF(input.empty(), "An input file must be given with `--input`");
+    NS_ABORT_MSG_IF(output.empty(), "An output file must be given with `--output`");
+
+    std::ifstream inputFile{input, std::ios::in | std::ios::binary};
+    NS_ABORT_MSG_IF(!inputFile, "Failed to open input file: " << input);
+
+    std::ofstream outputFile{output, std::ios::out | std::ios::trunc | std::ios::binary};
+    NS_ABORT_MSG_IF(!outputFile, "Failed to open output file: " << output);
+
+    netsimulyzer::BinaryOutputReader reader{inputFile};
+    reader.WriteJson(outputFile);
+
+    return 0;
+}